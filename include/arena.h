@@ -0,0 +1,37 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+typedef struct ArenaChunk ArenaChunk;
+
+struct ArenaChunk
+{
+    ArenaChunk   *next;
+    size_t        size;
+    size_t        used;
+    unsigned char data[];
+};
+
+// bump allocator for objects that share one lifetime: nothing is freed individually,
+// and arena_dnit releases every allocation at once. current owners: the type system (types, names,
+// parameter lists, mangle fragments, field and method indexes), the symbol system (symbols, scopes,
+// their names and scope indexes) and each query table. tokens, ast nodes and diagnostics are still
+// heap-allocated per object.
+typedef struct Arena
+{
+    ArenaChunk *head;       // chunk currently being filled
+    size_t      chunk_size; // default chunk payload size
+    size_t      allocated;  // bytes handed out
+    size_t      reserved;   // bytes obtained from malloc
+} Arena;
+
+void arena_init(Arena *arena, size_t chunk_size);
+void arena_dnit(Arena *arena);
+
+// zeroed memory aligned for any object type; NULL only when the system is out of memory
+void *arena_alloc(Arena *arena, size_t size);
+char *arena_strdup(Arena *arena, const char *text);
+char *arena_strndup(Arena *arena, const char *text, size_t len);
+
+#endif
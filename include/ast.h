@@ -5,8 +5,9 @@
 #include <stdbool.h>
 
 // forward statements
-typedef struct Type   Type;
-typedef struct Symbol Symbol;
+typedef struct Type          Type;
+typedef struct Symbol        Symbol;
+typedef struct ComptimeValue ComptimeValue;
 
 typedef enum AstKind
 {
@@ -69,6 +70,27 @@ struct AstList
     int       capacity;
 };
 
+// loop annotations (#@vectorize, #@unroll, #@no_unroll); zero means unset
+typedef struct LoopHints
+{
+    int  vectorize_width; // #@vectorize(n)
+    int  unroll_count;    // #@unroll(n)
+    bool no_unroll;       // #@no_unroll
+} LoopHints;
+
+// function annotations (#@cold, #@inline, #@align(n), ...); zero means unset
+typedef struct FunHints
+{
+    bool  is_cold;     // #@cold
+    bool  is_hot;      // #@hot
+    bool  is_inline;   // #@inline
+    bool  is_noinline; // #@noinline
+    bool  is_flatten;  // #@flatten
+    bool  is_noreturn; // #@noreturn
+    int   align;       // #@align(n)
+    char *section;     // #@section("name"); owned by the fun node
+} FunHints;
+
 // base AST node
 struct AstNode
 {
@@ -120,12 +142,16 @@ struct AstNode
         // value/variable statement
         struct
         {
-            char    *name;
-            AstNode *type; // explicit type or null
-            AstNode *init; // initializer expression
-            bool     is_val;
-            bool     is_public;
-            char    *mangle_name;
+            char          *name;
+            AstNode       *type; // explicit type or null
+            AstNode       *init; // initializer expression
+            bool           is_val;
+            bool           is_public;
+            bool           is_thread_local;
+            bool           is_comptime;    // '#@comptime' or a global initializer that calls mach code
+            bool           is_keep;        // '#@keep': a root for dead declaration elimination
+            char          *mangle_name;
+            ComptimeValue *comptime_value; // evaluated initializer, owned by the node
         } var_stmt;
 
         // function statement
@@ -141,6 +167,8 @@ struct AstNode
             char    *mangle_name;
             bool     is_method;
             AstNode *method_receiver; // typename before '.' for method declarations
+            FunHints hints;
+            bool     is_keep; // '#@keep': a root for dead declaration elimination
         } fun_stmt;
 
         // struct statement
@@ -212,8 +240,10 @@ struct AstNode
         // for loop
         struct
         {
-            AstNode *cond; // null for infinite loop
-            AstNode *body;
+            AstNode  *cond;           // null for infinite loop
+            AstNode  *body;
+            AstList  *bounds_hoisted; // slice accesses checked once before the loop (not owned)
+            LoopHints hints;
         } for_stmt;
 
         // binary expression
@@ -245,6 +275,7 @@ struct AstNode
         {
             AstNode *array;
             AstNode *index;
+            bool     bounds_safe; // no runtime bounds check needed (proven or hoisted)
         } index_expr;
 
         // field access
@@ -319,7 +350,8 @@ struct AstNode
         struct
         {
             AstNode *elem_type;
-            AstNode *size; // null for unbound arrays [_]
+            AstNode *size;      // null for unbound arrays [_]
+            bool     is_vector; // simd vec[N]T
         } type_array;
 
         struct
@@ -358,10 +390,24 @@ void ast_list_dnit(AstList *list);
 void ast_list_append(AstList *list, AstNode *node);
 void ast_list_prepend(AstList *list, AstNode *node);
 
+// free the bodies of a program's top-level functions once its object is emitted;
+// signatures stay because symbols in other modules still point at them
+void ast_release_bodies(AstNode *root);
+
+// link roots: declarations that must keep their external symbol because something outside the
+// visible call graph may name them ('#@keep', '#@symbol', '#@section', anything beside top-level asm,
+// and in the entry module 'main' plus its public declarations)
+bool ast_program_has_asm(AstNode *root);
+bool ast_stmt_is_link_root(AstNode *stmt, bool has_asm, bool is_entry);
+
 // cloning helpers
 AstNode *ast_clone(const AstNode *node);
 AstList *ast_list_clone(const AstList *list);
 
+// traversal helpers (pre-order, source order; returning false skips the children)
+typedef bool (*AstVisitFn)(AstNode *node, void *user_data);
+void         ast_visit(AstNode *node, AstVisitFn visit, void *user_data);
+
 // pretty printing for debugging
 void ast_print(AstNode *node, int indent);
 
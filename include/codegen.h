@@ -3,6 +3,7 @@
 
 #include "ast.h"
 #include "lexer.h"
+#include "query.h"
 #include "semantic.h"
 #include <llvm-c/Core.h>
 #include <llvm-c/DebugInfo.h>
@@ -10,8 +11,9 @@
 #include <llvm-c/TargetMachine.h>
 #include <stdbool.h>
 
-typedef struct CodegenContext CodegenContext;
-typedef struct CodegenError   CodegenError;
+typedef struct CodegenContext  CodegenContext;
+typedef struct CodegenError    CodegenError;
+typedef struct CodegenPipeline CodegenPipeline;
 
 struct CodegenError
 {
@@ -20,6 +22,19 @@ struct CodegenError
     CodegenError *next;
 };
 
+// optimization pipeline tuning; -1 keeps the llvm default
+struct CodegenPipeline
+{
+    int         size_level;       // 0 = none, 1 = Os, 2 = Oz
+    const char *passes;           // custom pass pipeline, replaces default<O*>
+    int         loop_vectorize;   // -1, 0 or 1
+    int         slp_vectorize;    // -1, 0 or 1
+    int         loop_unroll;      // -1, 0 or 1
+    int         inline_threshold; // -1 or threshold
+    bool        profile_generate; // insert pgo instrumentation
+    const char *profile_use;      // indexed profile (.profdata) to annotate from
+};
+
 struct CodegenContext
 {
     // llvm core
@@ -35,32 +50,24 @@ struct CodegenContext
     LLVMMetadataRef      current_di_subprogram;
     LLVMMetadataRef      di_unknown_type;
 
-    // symbol mapping
-    struct
-    {
-        Symbol      **symbols;
-        LLVMValueRef *values;
-        int           count;
-        int           capacity;
-    } symbol_map;
-
-    // type cache
-    struct
-    {
-        Type       **types;
-        LLVMTypeRef *llvm_types;
-        int          count;
-        int          capacity;
-    } type_cache;
+    // memoized symbol values and lowered types
+    QueryTable queries;
 
     // current function context
     LLVMValueRef      current_function;
     Type             *current_function_type; // mach type for current function
     LLVMBasicBlockRef break_block;
     LLVMBasicBlockRef continue_block;
+    LLVMBasicBlockRef trap_block;  // shared bounds failure block (created on demand)
+    LLVMValueRef      current_sret; // hidden result pointer when the current function returns through sret
+
+    // in-place construction: the expression below builds its value directly into this slot
+    AstNode     *result_slot_expr;
+    LLVMValueRef result_slot;
 
     // initialization context
-    bool generating_mutable_init; // true when generating initializer for var (not val)
+    bool          generating_mutable_init; // true when generating initializer for var (not val)
+    LLVMValueRef *comptime_globals;        // one global per allocation of the interpreter result being emitted
 
     // module-level assembly aggregation
     char  *module_inline_asm;
@@ -71,13 +78,20 @@ struct CodegenContext
     bool          has_errors;
 
     // options
-    int   opt_level;
-    bool  debug_info;
-    bool  debug_finalized;
-    bool  no_pie; // disable position independent executable
-    char *debug_full_path;
-    char *debug_dir;
-    char *debug_file;
+    int             opt_level;
+    CodegenPipeline pipeline;           // pass pipeline tuning
+    bool            verbose;            // report codegen statistics
+    int             internalized_count; // non-public symbols given internal linkage
+    bool            prune_unreachable;  // skip functions and globals the reachability pass did not mark
+    int             pruned_count;       // declarations skipped as unreachable
+    bool            emit_profile_hook;  // define mach_profile_write (entry module only)
+    bool            is_entry_module;    // 'main' and public declarations are link roots
+    bool            debug_info;
+    bool            debug_finalized;
+    bool            no_pie; // disable position independent executable
+    char           *debug_full_path;
+    char           *debug_dir;
+    char           *debug_file;
 
     // source context for diagnostics
     const char *source_file;  // current file being compiled
@@ -85,7 +99,8 @@ struct CodegenContext
 
     // variadic function support (Mach ABI)
     LLVMValueRef current_vararg_count_value; // u64 count parameter passed to current function (null if none)
-    LLVMValueRef current_vararg_array;       // i8** pointing to packed variadic argument slots
+    LLVMValueRef current_vararg_data;        // packed block holding the variadic argument values
+    LLVMValueRef current_vararg_desc;        // constant {type tag, offset} pair per variadic argument
     size_t       current_fixed_param_count;  // number of fixed parameters in current function
 
     // specialization cache for cross-module generic instantiation
@@ -93,7 +108,8 @@ struct CodegenContext
 };
 
 // context lifecycle
-void codegen_context_init(CodegenContext *ctx, const char *module_name, bool no_pie);
+void codegen_pipeline_init(CodegenPipeline *pipeline);
+void codegen_context_init(CodegenContext *ctx, const char *module_name, const char *triple, const char *cpu, const char *features, bool no_pie);
 void codegen_context_dnit(CodegenContext *ctx);
 
 // main entry point
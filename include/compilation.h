@@ -25,21 +25,29 @@ typedef struct
 
 typedef struct
 {
-    const char *input_file;
-    const char *output_file;
-    int         opt_level;
-    int         link_exe;
-    int         no_pie;
-    int         debug_info;
-    int         emit_ast;
-    int         emit_ir;
-    int         emit_asm;
-    const char *emit_ast_path;
-    const char *emit_ir_path;
-    const char *emit_asm_path;
-    StringVec   include_paths;
-    StringVec   link_objects;
-    AliasVec    aliases;
+    const char     *input_file;
+    const char     *output_file;
+    int             opt_level;  // -1 until resolved from the command line or target config
+    int             size_level; // -1 until resolved; 1 = Os, 2 = Oz
+    const char     *passes;     // custom pass pipeline (--passes=)
+    int             profile_generate;
+    const char     *profile_use;
+    BoundsCheckMode bounds_checks;
+    int             link_exe;
+    int             no_pie;
+    int             debug_info;
+    int             emit_ast;
+    int             emit_ir;
+    int             emit_asm;
+    int             verbose;
+    const char     *emit_ast_path;
+    const char     *emit_ir_path;
+    const char     *emit_asm_path;
+    const char     *target_cpu;
+    const char     *target_features;
+    StringVec       include_paths;
+    StringVec       link_objects;
+    AliasVec        aliases;
 } BuildOptions;
 
 typedef struct
@@ -53,6 +61,7 @@ typedef struct
     Parser          parser;
     Lexer           lexer;
     CodegenContext  codegen;
+    CodegenPipeline pipeline;
     char           *module_name;
     char          **dep_objects;
     int             dep_count;
@@ -0,0 +1,67 @@
+#ifndef COMPTIME_H
+#define COMPTIME_H
+
+#include "ast.h"
+#include "symbol.h"
+#include "type.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// limits for a single compile-time evaluation
+#define COMPTIME_DEFAULT_FUEL   10000000u          // statements and expressions evaluated
+#define COMPTIME_DEFAULT_MEMORY ((size_t)64 << 20) // bytes of interpreter memory
+#define COMPTIME_MAX_DEPTH      256                // nested mach calls
+
+// interpreter addresses carry their region in the upper bits so nil stays distinct
+#define COMPTIME_STACK_BASE  0x100000000000ULL
+#define COMPTIME_STATIC_BASE 0x200000000000ULL
+#define COMPTIME_FUNC_BASE   0x300000000000ULL
+
+typedef struct ComptimeLimits
+{
+    uint64_t fuel;
+    size_t   memory;
+    int      depth;
+} ComptimeLimits;
+
+// where and why an evaluation stopped
+typedef struct ComptimeError
+{
+    AstNode *node;     // offending expression or statement
+    Symbol  *function; // mach function being executed, null for the initializer itself
+    char     message[256];
+} ComptimeError;
+
+// one allocation in the static region (string and array literal storage)
+typedef struct ComptimeAlloc
+{
+    uint64_t addr;
+    size_t   size;
+} ComptimeAlloc;
+
+// result of an evaluation, laid out exactly as the value is laid out in memory
+typedef struct ComptimeValue
+{
+    Type          *type;
+    uint8_t       *bytes;       // type_sizeof(type) bytes in host byte order
+    uint8_t       *memory;      // static region that pointers in the value refer to
+    size_t         memory_size;
+    ComptimeAlloc *allocs;
+    size_t         alloc_count;
+    Symbol       **functions;   // function pointer targets, indexed from COMPTIME_FUNC_BASE
+    size_t         function_count;
+} ComptimeValue;
+
+ComptimeLimits comptime_default_limits(void);
+
+// evaluate an analysed expression and convert it to type; null with error filled on failure
+ComptimeValue *comptime_eval(AstNode *expr, Type *type, ComptimeLimits limits, ComptimeError *error);
+void           comptime_value_free(ComptimeValue *value);
+
+// pointer resolution for materializing a result
+const ComptimeAlloc *comptime_value_find_alloc(const ComptimeValue *value, uint64_t addr);
+const uint8_t       *comptime_value_memory(const ComptimeValue *value, uint64_t addr);
+Symbol              *comptime_value_function(const ComptimeValue *value, uint64_t addr);
+
+#endif
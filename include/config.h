@@ -8,9 +8,12 @@ typedef struct TargetConfig
 {
     char *name;          // target name (e.g., "linux", "macos", "windows")
     char *target_triple; // target architecture triple
+    char *cpu;           // target cpu (e.g. "x86-64-v3", "native"); null means host
+    char *features;      // target feature list (e.g. "+avx2,-sse4.2")
 
     // build options
     int  opt_level;     // optimization level (0-3)
+    int  size_level;    // size optimization (0 = none, 1 = "s", 2 = "z")
     bool emit_ast;      // emit AST files
     bool emit_ir;       // emit LLVM IR
     bool emit_asm;      // emit assembly
@@ -18,6 +21,13 @@ typedef struct TargetConfig
     bool build_library; // build as library
     bool no_pie;        // disable PIE
     bool shared;        // build shared library when building a library
+
+    // pass pipeline tuning (-1 keeps the llvm default)
+    char *passes;           // custom pass pipeline string
+    int   loop_vectorize;   // enable loop vectorization
+    int   slp_vectorize;    // enable slp vectorization
+    int   unroll_loops;     // enable loop unrolling
+    int   inline_threshold; // inliner threshold
 } TargetConfig;
 
 // explicit dependency specification (parsed from [deps] table)
@@ -0,0 +1,11 @@
+#ifndef EFFECTS_H
+#define EFFECTS_H
+
+#include "symbol.h"
+#include <stddef.h>
+
+// infer memory effects, unwinding, termination and pointer parameter use for every function in the set;
+// results land in symbol->func.effects, and calls to functions outside the set are assumed to do anything
+void effects_infer(Symbol **functions, size_t count);
+
+#endif
@@ -9,6 +9,7 @@
 typedef struct Module              Module;
 typedef struct ModuleManager       ModuleManager;
 typedef struct SpecializationCache SpecializationCache;
+typedef struct CodegenPipeline     CodegenPipeline;
 
 // forward statement
 typedef struct SymbolTable SymbolTable;
@@ -56,8 +57,10 @@ struct ModuleManager
     char          **alias_names;
     char          **alias_paths;
     int             alias_count;
-    ModuleErrorList errors;    // accumulated errors during loading
-    bool            had_error; // true if any module failed to load/parse
+    ModuleErrorList errors;            // accumulated errors during loading
+    bool            had_error;         // true if any module failed to load/parse
+    bool            verbose;           // report per-module codegen statistics
+    bool            prune_unreachable; // reachability ran; codegen skips functions and globals it did not mark
 
     // configuration for dependency resolution
     void       *config;      // ProjectConfig* (void* to avoid circular includes)
@@ -66,6 +69,8 @@ struct ModuleManager
     char *target_triple; // cached target triple (from config or host)
     char *target_os;     // normalized os name (linux/windows/darwin/...) for platform suffix resolution
     char *target_arch;   // normalized arch name (x86_64/aarch64/...)
+    char *target_cpu;    // resolved cpu name (from -mcpu, config, or host)
+    char *target_feats;  // resolved feature string ("+avx2,-sse4.2,...")
 
     // cached preprocessor constants
     PreprocessorConstant *cached_constants;
@@ -80,6 +85,7 @@ void module_manager_dnit(ModuleManager *manager);
 void   module_manager_add_search_path(ModuleManager *manager, const char *path);
 void   module_manager_add_alias(ModuleManager *manager, const char *name, const char *base_dir);
 void   module_manager_set_config(ModuleManager *manager, void *config, const char *project_dir);
+void   module_manager_set_target_cpu(ModuleManager *manager, const char *cpu, const char *features);
 size_t module_manager_collect_constants(ModuleManager *manager, PreprocessorConstant *out, size_t max_count);
 
 // module loading
@@ -88,7 +94,7 @@ Module *module_manager_find_module(ModuleManager *manager, const char *name);
 Module *module_manager_find_by_file_path(ModuleManager *manager, const char *file_path);
 
 // dependency compilation and linking
-bool module_manager_compile_dependencies(ModuleManager *manager, const char *output_dir, int opt_level, bool no_pie, bool debug_info, SpecializationCache *spec_cache);
+bool module_manager_compile_dependencies(ModuleManager *manager, const char *output_dir, int opt_level, const CodegenPipeline *pipeline, bool no_pie, bool debug_info, SpecializationCache *spec_cache);
 bool module_manager_get_link_objects(ModuleManager *manager, char ***object_files, int *count);
 
 // utility helpers
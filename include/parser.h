@@ -46,6 +46,13 @@ typedef struct Parser
     bool            had_error;
     ParserErrorList errors;
     char           *pending_mangle;
+    LoopHints       pending_loop_hints; // annotations for the next 'for'
+    bool            has_loop_hints;
+    bool            pending_thread_local; // '#@thread_local' for the next 'var'
+    bool            pending_comptime;     // '#@comptime' for the next 'val' or 'var'
+    bool            pending_keep;         // '#@keep' for the next top-level 'fun', 'val' or 'var'
+    FunHints        pending_fun_hints;    // annotations for the next 'fun'
+    bool            has_fun_hints;
 } Parser;
 
 // parser lifecycle
@@ -107,6 +114,7 @@ AstNode *parser_parse_type(Parser *parser);
 AstNode *parser_parse_type_name(Parser *parser);
 AstNode *parser_parse_type_ptr(Parser *parser);
 AstNode *parser_parse_type_array(Parser *parser);
+AstNode *parser_parse_type_vector(Parser *parser);
 AstNode *parser_parse_type_fun(Parser *parser);
 AstNode *parser_parse_type_str(Parser *parser);
 AstNode *parser_parse_type_uni(Parser *parser);
@@ -4,6 +4,8 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#define PREPROCESSOR_MAX_CONSTANTS 64
+
 typedef struct PreprocessorConstant
 {
     const char *name;
@@ -0,0 +1,75 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include "arena.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// kinds of memoized question; the key's meaning depends on the kind
+typedef enum QueryKind
+{
+    QUERY_LLVM_TYPE,       // key: Type *, value: LLVMTypeRef
+    QUERY_LLVM_NAMED_TYPE, // key: struct/union name (string), value: LLVMTypeRef shared by same-named types
+    QUERY_SYMBOL_VALUE,    // key: Symbol *, value: LLVMValueRef (function, global or local slot)
+    QUERY_VARARG_DESC,     // key: descriptor initializer (llvm uniques constants), value: its private global
+    QUERY_LAYOUT,          // key: struct/union Type *, value: the same type once its fields, size and alignment are set
+    QUERY_SIGNATURE,       // key: function Symbol *, value: its resolved function Type *
+} QueryKind;
+
+typedef struct QueryEntry QueryEntry;
+typedef struct QueryLink  QueryLink;
+
+struct QueryLink
+{
+    QueryEntry *entry;
+    QueryLink  *next;
+};
+
+struct QueryEntry
+{
+    QueryKind   kind;
+    const void *key;
+    void       *value;
+    bool        is_valid;
+    QueryLink  *dependents; // entries computed while this answer was read
+    QueryEntry *next;       // bucket chain
+};
+
+// memo table with dependency tracking: a question is computed the first time it is asked, an answer
+// read while another query is being computed is recorded as its input, so invalidating an answer
+// also drops everything derived from it; the stack of questions being computed reports cycles
+typedef struct QueryTable
+{
+    QueryEntry **buckets;
+    size_t       bucket_count;
+    size_t       entry_count;
+    QueryEntry **active; // queries being computed, innermost last
+    size_t       active_count;
+    size_t       active_capacity;
+    uint64_t     hits;
+    uint64_t     misses;
+    Arena        arena; // entries and string keys
+} QueryTable;
+
+void query_table_init(QueryTable *table);
+void query_table_dnit(QueryTable *table);
+
+// cached answer, or false on a miss; valid answers count as an input of the active query
+bool query_lookup(QueryTable *table, QueryKind kind, const void *key, void **out_value);
+
+// record an answer outside any computation (replaces an existing one)
+void query_store(QueryTable *table, QueryKind kind, const void *key, void *value);
+
+// bracket the computation of an answer; lookups in between become its inputs, and a NULL value
+// records a failure, which is retried when asked again
+void query_begin(QueryTable *table, QueryKind kind, const void *key);
+void query_end(QueryTable *table, void *value);
+
+// whether the answer is being computed right now, i.e. asking for it again would recurse
+bool query_is_active(QueryTable *table, QueryKind kind, const void *key);
+
+// drop an answer and, transitively, every answer computed from it
+void query_invalidate(QueryTable *table, QueryKind kind, const void *key);
+
+#endif
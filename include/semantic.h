@@ -3,6 +3,7 @@
 
 #include "ast.h"
 #include "module.h"
+#include "query.h"
 #include "symbol.h"
 #include "type.h"
 #include <stdbool.h>
@@ -25,6 +26,14 @@ typedef enum
     DIAG_NOTE
 } DiagnosticLevel;
 
+// slice bounds check elimination mode (--bounds-checks=)
+typedef enum
+{
+    BOUNDS_CHECKS_FULL,  // check every slice access
+    BOUNDS_CHECKS_LOOPS, // drop or hoist checks proven by loop conditions
+    BOUNDS_CHECKS_OFF    // never check slice accesses
+} BoundsCheckMode;
+
 // diagnostic entry
 typedef struct Diagnostic
 {
@@ -134,6 +143,14 @@ struct InstantiationQueue
     size_t                count;
 };
 
+// compile-time evaluation request: a val/var initializer run once analysis completes
+typedef struct ComptimeRequest
+{
+    AstNode                *stmt;
+    const char             *file_path;
+    struct ComptimeRequest *next;
+} ComptimeRequest;
+
 // semantic driver: orchestrates multi-pass analysis
 struct SemanticDriver
 {
@@ -141,9 +158,13 @@ struct SemanticDriver
     SymbolTable         symbol_table; // for codegen compatibility
     SpecializationCache spec_cache;
     InstantiationQueue  inst_queue;
+    ComptimeRequest    *comptime_head; // initializers to evaluate, in analysis order
+    ComptimeRequest    *comptime_tail;
     DiagnosticSink      diagnostics;
+    QueryTable          queries; // layouts and signatures, resolved on first use
     AstNode            *program_root;
     const char         *entry_module_name;
+    BoundsCheckMode     bounds_checks;
 };
 
 // driver lifecycle
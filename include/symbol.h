@@ -1,6 +1,7 @@
 #ifndef SYMBOL_H
 #define SYMBOL_H
 
+#include "ast.h"
 #include "type.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -23,6 +24,26 @@ typedef enum SymbolKind
 
 typedef struct GenericSpecialization GenericSpecialization;
 
+// inferred function behaviour, lowered to llvm attributes (see effects.c)
+typedef enum FunEffect
+{
+    FUN_EFFECT_ARG_READ    = 1 << 0, // reads memory reached through pointer parameters
+    FUN_EFFECT_ARG_WRITE   = 1 << 1, // writes memory reached through pointer parameters
+    FUN_EFFECT_OTHER_READ  = 1 << 2, // reads globals or memory behind any other pointer
+    FUN_EFFECT_OTHER_WRITE = 1 << 3, // writes globals or memory behind any other pointer
+    FUN_EFFECT_TRAP        = 1 << 4, // may abort on a failed bounds check
+} FunEffect;
+
+typedef struct FunEffects
+{
+    bool     inferred;   // false for externals and before inference; nothing may be assumed then
+    bool     nounwind;   // no call on any path may unwind
+    bool     willreturn; // always returns: no loops, recursion, traps or unknown callees
+    uint8_t  memory;     // FunEffect mask
+    uint64_t nocapture;  // bit i: pointer parameter i does not outlive the call
+    uint64_t readonly;   // bit i: nothing is stored through pointer parameter i
+} FunEffects;
+
 struct GenericSpecialization
 {
     size_t                 arg_count;
@@ -41,6 +62,7 @@ typedef struct Symbol
     struct Scope  *home_scope;    // scope where the symbol is registered
     struct Symbol *next;          // for linked list in scope
     struct Symbol *method_next;   // linked list for type methods
+    struct Symbol *index_next;    // bucket chain in the owning scope's name index
     bool           is_imported;   // true if this symbol was imported from another module
     bool           is_public;     // true if symbol should be exported from module
     bool           has_const_i64; // semantic constant folding result (integer/bool)
@@ -48,6 +70,7 @@ typedef struct Symbol
     const char    *import_module; // source module for imported symbols
     char          *module_name;   // canonical module owning this symbol
     struct Symbol *import_origin; // original symbol when imported
+    bool           is_reachable;  // referenced from a root of the whole program (see ModuleManager.prune_unreachable)
 
     union
     {
@@ -55,7 +78,8 @@ typedef struct Symbol
         struct
         {
             bool  is_global;
-            bool  is_const; // true for val
+            bool  is_const;        // true for val
+            bool  is_thread_local; // '#@thread_local' global
             char *mangled_name;
         } var;
 
@@ -78,6 +102,10 @@ typedef struct Symbol
             size_t                 method_forwarded_generic_count;
             bool                   method_receiver_is_pointer;
             char                  *method_receiver_name;
+            bool                   is_analyzed; // body went through analysis (imported bodies only on demand)
+            bool                   is_demanded; // reached by the on-demand body walk
+            FunHints               hints;       // '#@' function annotations
+            FunEffects             effects;     // inferred after analysis; imported clones defer to import_origin
         } func;
         // SYMBOL_TYPE
         struct
@@ -89,12 +117,15 @@ typedef struct Symbol
             GenericSpecialization *generic_specializations;
             bool                   is_specialized_instance;
             struct Symbol         *methods;
+            struct Symbol        **method_slots;      // open-addressed name index over 'methods', built on first lookup
+            size_t                 method_slot_count; // zero until built; type_add_method drops the index
         } type_def;
 
         // SYMBOL_FIELD
         struct
         {
             size_t offset; // offset within struct/union
+            size_t index;  // declaration position, the llvm element index for structs (set by the field index)
         } field;
 
         // SYMBOL_PARAM
@@ -114,10 +145,13 @@ typedef struct Symbol
 
 typedef struct Scope
 {
-    struct Scope *parent;    // parent scope
-    Symbol       *symbols;   // linked list of symbols
-    bool          is_module; // true for module scope
-    char         *name;      // scope name (for debugging)
+    struct Scope *parent;       // parent scope
+    Symbol       *symbols;      // linked list of symbols
+    bool          is_module;    // true for module scope
+    char         *name;         // scope name (for debugging)
+    size_t        symbol_count; // entries in 'symbols'
+    Symbol      **index;        // name hash buckets chained through index_next; built once the scope grows
+    size_t        index_size;   // bucket count, a power of two (zero while unindexed)
 } Scope;
 
 typedef struct SymbolTable
@@ -127,13 +161,18 @@ typedef struct SymbolTable
     Scope *module_scope; // current module scope
 } SymbolTable;
 
+// symbols, scopes and the strings they own come from one arena that lives as long as semantic analysis;
+// nothing is freed individually, and symbol_system_dnit releases everything at once
+void *symbol_system_alloc(size_t size); // zeroed
+char *symbol_system_strdup(const char *text);
+void  symbol_system_dnit(void);
+
 // symbol table operations
 void symbol_table_init(SymbolTable *table);
 void symbol_table_dnit(SymbolTable *table);
 
 // scope operations
 Scope *scope_create(Scope *parent, const char *name);
-void   scope_destroy(Scope *scope);
 void   scope_enter(SymbolTable *table, Scope *scope);
 void   scope_exit(SymbolTable *table);
 Scope *scope_push(SymbolTable *table, const char *name);
@@ -141,7 +180,6 @@ void   scope_pop(SymbolTable *table);
 
 // symbol operations
 Symbol *symbol_create(SymbolKind kind, const char *name, Type *type, AstNode *decl);
-void    symbol_destroy(Symbol *symbol);
 void    symbol_add(Scope *scope, Symbol *symbol);
 Symbol *symbol_lookup(SymbolTable *table, const char *name);
 Symbol *symbol_lookup_scope(Scope *scope, const char *name);
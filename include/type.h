@@ -25,6 +25,7 @@ typedef enum TypeKind
     TYPE_PTR,     // generic pointer
     TYPE_POINTER, // typed pointer
     TYPE_ARRAY,
+    TYPE_VECTOR, // simd vector vec[N]T
     TYPE_STRUCT,
     TYPE_UNION,
     TYPE_FUNCTION,
@@ -38,6 +39,7 @@ typedef struct Type
     size_t   size;      // size in bytes
     size_t   alignment; // alignment requirement
     char    *name;      // for named types (structs, unions, aliases)
+    char    *mangled;   // symbol-name fragment, computed once by the mangler
 
     // generic specialization info
     Symbol       *generic_origin; // the generic symbol this was instantiated from
@@ -60,11 +62,22 @@ typedef struct Type
             bool         is_slice; // true for []T (fat pointer), false for [N]T (fixed-size)
         } array;
 
+        // TYPE_VECTOR
+        struct
+        {
+            struct Type *elem_type;
+            size_t       count; // lane count, power of two
+        } vector;
+
         // TYPE_STRUCT, TYPE_UNION
         struct
         {
-            Symbol *fields;
-            size_t  field_count;
+            Symbol  *fields;
+            size_t   field_count;
+            Symbol **field_array;   // dense view of 'fields' in declaration order, built on first lookup
+            Symbol **field_slots;   // open-addressed name index into field_array
+            size_t   slot_count;    // power of two, zero until built
+            size_t   indexed_count; // field_count when the index was built; a mismatch rebuilds it
         } composite;
 
         // TYPE_FUNCTION
@@ -88,6 +101,10 @@ typedef struct Type
 void type_system_init(void);
 void type_system_dnit(void);
 
+// type-system storage (zeroed); it is released with the types by type_system_dnit
+void *type_system_alloc(size_t size);
+char *type_system_strndup(const char *text, size_t len);
+
 // builtin type accessors
 Type *type_u8(void);
 Type *type_u16(void);
@@ -107,6 +124,7 @@ Type *type_error(void);
 Type *type_pointer_create(Type *base);
 Type *type_array_create(Type *elem_type);                    // creates slice/fat pointer []T
 Type *type_fixed_array_create(Type *elem_type, size_t size); // creates fixed-size [N]T
+Type *type_vector_create(Type *elem_type, size_t count);     // creates simd vec[N]T
 Type *type_struct_create(const char *name);
 Type *type_union_create(const char *name);
 Type *type_function_create(Type *return_type, Type **param_types, size_t param_count, bool is_variadic);
@@ -119,6 +137,7 @@ bool   type_is_integer(Type *type);
 bool   type_is_float(Type *type);
 bool   type_is_signed(Type *type);
 bool   type_is_pointer_like(Type *type);
+bool   type_is_vector(Type *type);
 bool   type_is_truthy(Type *type); // true when type is the mach boolean (u8)
 bool   type_is_error(Type *type);
 bool   type_can_cast_to(Type *from, Type *to);
@@ -126,6 +145,10 @@ bool   type_can_assign_to(Type *from, Type *to);
 size_t type_sizeof(Type *type);
 size_t type_alignof(Type *type);
 
+// composite field lookup through the name index (rebuilt whenever the field list changes)
+Symbol *type_find_field(Type *type, const char *name);
+Symbol *type_field_at(Type *type, size_t index);
+
 // builtin lookup
 Type *type_lookup_builtin(const char *name);
 
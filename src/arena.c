@@ -0,0 +1,94 @@
+#include "arena.h"
+#include <stdalign.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_DEFAULT_CHUNK (64 * 1024)
+
+static size_t arena_align(size_t size)
+{
+    size_t align = alignof(max_align_t);
+    return (size + align - 1) & ~(align - 1);
+}
+
+// chunks come from calloc, so every allocation is zeroed without a memset
+static ArenaChunk *arena_chunk_create(Arena *arena, size_t size)
+{
+    ArenaChunk *chunk = calloc(1, sizeof(ArenaChunk) + size);
+    if (!chunk)
+        return NULL;
+    chunk->size = size;
+    arena->reserved += sizeof(ArenaChunk) + size;
+    return chunk;
+}
+
+void arena_init(Arena *arena, size_t chunk_size)
+{
+    arena->head       = NULL;
+    arena->chunk_size = chunk_size ? arena_align(chunk_size) : ARENA_DEFAULT_CHUNK;
+    arena->allocated  = 0;
+    arena->reserved   = 0;
+}
+
+void arena_dnit(Arena *arena)
+{
+    ArenaChunk *chunk = arena->head;
+    while (chunk)
+    {
+        ArenaChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->head      = NULL;
+    arena->allocated = 0;
+    arena->reserved  = 0;
+}
+
+void *arena_alloc(Arena *arena, size_t size)
+{
+    size = arena_align(size ? size : 1);
+
+    ArenaChunk *head = arena->head;
+    if (!head || head->size - head->used < size)
+    {
+        // oversized requests get a chunk of their own behind the current one, keeping its free tail
+        if (head && size > arena->chunk_size / 4)
+        {
+            ArenaChunk *chunk = arena_chunk_create(arena, size);
+            if (!chunk)
+                return NULL;
+            chunk->used = size;
+            chunk->next = head->next;
+            head->next  = chunk;
+            arena->allocated += size;
+            return chunk->data;
+        }
+
+        ArenaChunk *chunk = arena_chunk_create(arena, size > arena->chunk_size ? size : arena->chunk_size);
+        if (!chunk)
+            return NULL;
+        chunk->next = head;
+        arena->head = chunk;
+        head        = chunk;
+    }
+
+    void *result = head->data + head->used;
+    head->used += size;
+    arena->allocated += size;
+    return result;
+}
+
+char *arena_strndup(Arena *arena, const char *text, size_t len)
+{
+    char *copy = arena_alloc(arena, len + 1);
+    if (!copy)
+        return NULL;
+    memcpy(copy, text, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+char *arena_strdup(Arena *arena, const char *text)
+{
+    return text ? arena_strndup(arena, text, strlen(text)) : NULL;
+}
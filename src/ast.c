@@ -1,4 +1,5 @@
 #include "ast.h"
+#include "comptime.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -69,6 +70,7 @@ void ast_node_dnit(AstNode *node)
     case AST_STMT_VAR:
         free(node->var_stmt.name);
         free(node->var_stmt.mangle_name);
+        comptime_value_free(node->var_stmt.comptime_value);
         if (node->var_stmt.type)
         {
             ast_node_dnit(node->var_stmt.type);
@@ -84,6 +86,7 @@ void ast_node_dnit(AstNode *node)
     case AST_STMT_FUN:
         free(node->fun_stmt.name);
         free(node->fun_stmt.mangle_name);
+        free(node->fun_stmt.hints.section);
         if (node->fun_stmt.params)
         {
             ast_list_dnit(node->fun_stmt.params);
@@ -226,6 +229,11 @@ void ast_node_dnit(AstNode *node)
             ast_node_dnit(node->for_stmt.body);
             free(node->for_stmt.body);
         }
+        if (node->for_stmt.bounds_hoisted)
+        {
+            free(node->for_stmt.bounds_hoisted->items);
+            free(node->for_stmt.bounds_hoisted);
+        }
         break;
 
     case AST_STMT_BRK:
@@ -473,6 +481,47 @@ void ast_list_prepend(AstList *list, AstNode *node)
     list->count++;
 }
 
+void ast_release_bodies(AstNode *root)
+{
+    if (!root || root->kind != AST_PROGRAM || !root->program.stmts)
+        return;
+
+    AstList *stmts = root->program.stmts;
+    for (int i = 0; i < stmts->count; i++)
+    {
+        AstNode *stmt = stmts->items[i];
+        if (!stmt || stmt->kind != AST_STMT_FUN || !stmt->fun_stmt.body)
+            continue;
+
+        ast_node_dnit(stmt->fun_stmt.body);
+        free(stmt->fun_stmt.body);
+        stmt->fun_stmt.body = NULL;
+    }
+}
+
+bool ast_program_has_asm(AstNode *root)
+{
+    for (int i = 0; root && root->kind == AST_PROGRAM && i < root->program.stmts->count; i++)
+    {
+        if (root->program.stmts->items[i]->kind == AST_STMT_ASM)
+            return true;
+    }
+    return false;
+}
+
+bool ast_stmt_is_link_root(AstNode *stmt, bool has_asm, bool is_entry)
+{
+    if (stmt->kind == AST_STMT_FUN)
+    {
+        if (has_asm || stmt->fun_stmt.is_keep || stmt->fun_stmt.mangle_name || stmt->fun_stmt.hints.section)
+            return true;
+        return is_entry && (stmt->fun_stmt.is_public || (!stmt->fun_stmt.is_method && strcmp(stmt->fun_stmt.name, "main") == 0));
+    }
+    if (stmt->kind == AST_STMT_VAL || stmt->kind == AST_STMT_VAR)
+        return has_asm || stmt->var_stmt.is_keep || stmt->var_stmt.mangle_name || (is_entry && stmt->var_stmt.is_public);
+    return false;
+}
+
 static char *ast_strdup(const char *src)
 {
     return src ? strdup(src) : NULL;
@@ -569,12 +618,15 @@ static AstNode *ast_clone_checked(const AstNode *node)
 
     case AST_STMT_VAL:
     case AST_STMT_VAR:
-        clone->var_stmt.name        = ast_strdup(node->var_stmt.name);
-        clone->var_stmt.type        = ast_clone_checked(node->var_stmt.type);
-        clone->var_stmt.init        = ast_clone_checked(node->var_stmt.init);
-        clone->var_stmt.is_val      = node->var_stmt.is_val;
-        clone->var_stmt.is_public   = node->var_stmt.is_public;
-        clone->var_stmt.mangle_name = ast_strdup(node->var_stmt.mangle_name);
+        clone->var_stmt.name            = ast_strdup(node->var_stmt.name);
+        clone->var_stmt.type            = ast_clone_checked(node->var_stmt.type);
+        clone->var_stmt.init            = ast_clone_checked(node->var_stmt.init);
+        clone->var_stmt.is_val          = node->var_stmt.is_val;
+        clone->var_stmt.is_public       = node->var_stmt.is_public;
+        clone->var_stmt.is_thread_local = node->var_stmt.is_thread_local;
+        clone->var_stmt.is_comptime     = node->var_stmt.is_comptime;
+        clone->var_stmt.is_keep         = node->var_stmt.is_keep;
+        clone->var_stmt.mangle_name     = ast_strdup(node->var_stmt.mangle_name);
         break;
 
     case AST_STMT_FUN:
@@ -588,6 +640,9 @@ static AstNode *ast_clone_checked(const AstNode *node)
         clone->fun_stmt.mangle_name     = ast_strdup(node->fun_stmt.mangle_name);
         clone->fun_stmt.is_method       = node->fun_stmt.is_method;
         clone->fun_stmt.method_receiver = ast_clone_checked(node->fun_stmt.method_receiver);
+        clone->fun_stmt.hints           = node->fun_stmt.hints;
+        clone->fun_stmt.hints.section   = ast_strdup(node->fun_stmt.hints.section);
+        clone->fun_stmt.is_keep         = node->fun_stmt.is_keep;
         break;
 
     case AST_STMT_STR:
@@ -640,8 +695,12 @@ static AstNode *ast_clone_checked(const AstNode *node)
         break;
 
     case AST_STMT_FOR:
-        clone->for_stmt.cond = ast_clone_checked(node->for_stmt.cond);
-        clone->for_stmt.body = ast_clone_checked(node->for_stmt.body);
+        clone->for_stmt.cond  = ast_clone_checked(node->for_stmt.cond);
+        clone->for_stmt.body  = ast_clone_checked(node->for_stmt.body);
+        clone->for_stmt.hints = node->for_stmt.hints;
+
+        // bounds facts belong to the analysed original; the clone gets its own pass
+        clone->for_stmt.bounds_hoisted = NULL;
         break;
 
     case AST_STMT_BRK:
@@ -667,8 +726,9 @@ static AstNode *ast_clone_checked(const AstNode *node)
         break;
 
     case AST_EXPR_INDEX:
-        clone->index_expr.array = ast_clone_checked(node->index_expr.array);
-        clone->index_expr.index = ast_clone_checked(node->index_expr.index);
+        clone->index_expr.array       = ast_clone_checked(node->index_expr.array);
+        clone->index_expr.index       = ast_clone_checked(node->index_expr.index);
+        clone->index_expr.bounds_safe = false;
         break;
 
     case AST_EXPR_FIELD:
@@ -736,6 +796,7 @@ static AstNode *ast_clone_checked(const AstNode *node)
     case AST_TYPE_ARRAY:
         clone->type_array.elem_type = ast_clone_checked(node->type_array.elem_type);
         clone->type_array.size      = ast_clone_checked(node->type_array.size);
+        clone->type_array.is_vector = node->type_array.is_vector;
         break;
 
     case AST_TYPE_PARAM:
@@ -762,6 +823,118 @@ static AstNode *ast_clone_checked(const AstNode *node)
     return clone;
 }
 
+static void ast_visit_list(AstList *list, AstVisitFn visit, void *user_data)
+{
+    if (!list)
+        return;
+
+    for (int i = 0; i < list->count; i++)
+        ast_visit(list->items[i], visit, user_data);
+}
+
+void ast_visit(AstNode *node, AstVisitFn visit, void *user_data)
+{
+    if (!node || !visit(node, user_data))
+        return;
+
+    switch (node->kind)
+    {
+    case AST_PROGRAM:
+        ast_visit_list(node->program.stmts, visit, user_data);
+        break;
+    case AST_MODULE:
+        ast_visit_list(node->module.stmts, visit, user_data);
+        break;
+
+    case AST_STMT_EXT:
+        ast_visit(node->ext_stmt.type, visit, user_data);
+        break;
+    case AST_STMT_DEF:
+        ast_visit(node->def_stmt.type, visit, user_data);
+        break;
+    case AST_STMT_VAL:
+    case AST_STMT_VAR:
+        ast_visit(node->var_stmt.type, visit, user_data);
+        ast_visit(node->var_stmt.init, visit, user_data);
+        break;
+    case AST_STMT_FUN:
+        ast_visit_list(node->fun_stmt.params, visit, user_data);
+        ast_visit(node->fun_stmt.return_type, visit, user_data);
+        ast_visit(node->fun_stmt.body, visit, user_data);
+        break;
+    case AST_STMT_STR:
+        ast_visit_list(node->str_stmt.fields, visit, user_data);
+        break;
+    case AST_STMT_UNI:
+        ast_visit_list(node->uni_stmt.fields, visit, user_data);
+        break;
+    case AST_STMT_FIELD:
+        ast_visit(node->field_stmt.type, visit, user_data);
+        break;
+    case AST_STMT_PARAM:
+        ast_visit(node->param_stmt.type, visit, user_data);
+        break;
+    case AST_STMT_BLOCK:
+        ast_visit_list(node->block_stmt.stmts, visit, user_data);
+        break;
+    case AST_STMT_EXPR:
+        ast_visit(node->expr_stmt.expr, visit, user_data);
+        break;
+    case AST_STMT_RET:
+        ast_visit(node->ret_stmt.expr, visit, user_data);
+        break;
+    case AST_STMT_IF:
+    case AST_STMT_OR:
+        ast_visit(node->cond_stmt.cond, visit, user_data);
+        ast_visit(node->cond_stmt.body, visit, user_data);
+        ast_visit(node->cond_stmt.stmt_or, visit, user_data);
+        break;
+    case AST_STMT_FOR:
+        ast_visit(node->for_stmt.cond, visit, user_data);
+        ast_visit(node->for_stmt.body, visit, user_data);
+        break;
+
+    case AST_EXPR_BINARY:
+        ast_visit(node->binary_expr.left, visit, user_data);
+        ast_visit(node->binary_expr.right, visit, user_data);
+        break;
+    case AST_EXPR_UNARY:
+        ast_visit(node->unary_expr.expr, visit, user_data);
+        break;
+    case AST_EXPR_CALL:
+        ast_visit(node->call_expr.func, visit, user_data);
+        ast_visit_list(node->call_expr.args, visit, user_data);
+        break;
+    case AST_EXPR_INDEX:
+        ast_visit(node->index_expr.array, visit, user_data);
+        ast_visit(node->index_expr.index, visit, user_data);
+        break;
+    case AST_EXPR_FIELD:
+        ast_visit(node->field_expr.object, visit, user_data);
+        break;
+    case AST_EXPR_CAST:
+        ast_visit(node->cast_expr.expr, visit, user_data);
+        break;
+    case AST_EXPR_ARRAY:
+        ast_visit_list(node->array_expr.elems, visit, user_data);
+        break;
+    case AST_EXPR_STRUCT:
+        ast_visit_list(node->struct_expr.fields, visit, user_data);
+        break;
+
+    case AST_TYPE_ARRAY:
+        ast_visit(node->type_array.elem_type, visit, user_data);
+        ast_visit(node->type_array.size, visit, user_data);
+        break;
+    case AST_TYPE_PTR:
+        ast_visit(node->type_ptr.base, visit, user_data);
+        break;
+
+    default:
+        break;
+    }
+}
+
 // helper for printing
 static void print_indent(int indent)
 {
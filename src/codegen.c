@@ -1,9 +1,12 @@
 #include "codegen.h"
+#include "comptime.h"
 #include "symbol.h"
 #include "token.h"
 #include "type.h"
 #include <limits.h>
 #include <llvm-c/Analysis.h>
+#include <llvm-c/Error.h>
+#include <llvm-c/Support.h>
 #include <llvm-c/Transforms/PassBuilder.h>
 #include <stdarg.h>
 #include <stdio.h>
@@ -11,6 +14,11 @@
 #include <string.h>
 
 static LLVMValueRef    codegen_load_rvalue(CodegenContext *ctx, LLVMValueRef value, Type *type, AstNode *source_expr);
+static LLVMValueRef    codegen_vector_lane(CodegenContext *ctx, LLVMValueRef value, Type *from_type, Type *vector_type);
+static LLVMValueRef    codegen_vector_splat(CodegenContext *ctx, LLVMValueRef value, Type *vector_type);
+static bool            codegen_is_large_aggregate(Type *type);
+static void            codegen_declare_function_symbol(CodegenContext *ctx, Symbol *sym);
+static LLVMValueRef    codegen_call_intrinsic(CodegenContext *ctx, const char *name, LLVMTypeRef *overloads, size_t overload_count, LLVMValueRef *args, unsigned arg_count, const char *label);
 static void            codegen_debug_init(CodegenContext *ctx);
 static void            codegen_debug_finalize(CodegenContext *ctx);
 static void            codegen_set_debug_location(CodegenContext *ctx, AstNode *node);
@@ -18,6 +26,8 @@ static LLVMMetadataRef codegen_get_current_scope(CodegenContext *ctx);
 static LLVMMetadataRef codegen_debug_get_unknown_type(CodegenContext *ctx);
 static LLVMMetadataRef codegen_debug_create_subprogram(CodegenContext *ctx, AstNode *stmt, LLVMValueRef func, const char *display_name, const char *link_name, size_t param_count);
 
+static bool codegen_eval_const_f64(CodegenContext *ctx, AstNode *expr, double *out);
+
 // simple constant folding for integers/booleans used in global initializers
 static bool codegen_eval_const_i64(CodegenContext *ctx, AstNode *expr, int64_t *out)
 {
@@ -108,6 +118,42 @@ static bool codegen_eval_const_i64(CodegenContext *ctx, AstNode *expr, int64_t *
 
     case AST_EXPR_BINARY:
     {
+        // float comparisons fold to an integer truth value
+        Type *operand_type = type_resolve_alias(expr->binary_expr.left->type);
+        if (operand_type && type_is_float(operand_type))
+        {
+            double flhs = 0.0;
+            double frhs = 0.0;
+            if (!codegen_eval_const_f64(ctx, expr->binary_expr.left, &flhs) || !codegen_eval_const_f64(ctx, expr->binary_expr.right, &frhs))
+            {
+                return false;
+            }
+
+            switch (expr->binary_expr.op)
+            {
+            case TOKEN_EQUAL_EQUAL:
+                *out = flhs == frhs;
+                return true;
+            case TOKEN_BANG_EQUAL:
+                *out = flhs != frhs;
+                return true;
+            case TOKEN_LESS:
+                *out = flhs < frhs;
+                return true;
+            case TOKEN_LESS_EQUAL:
+                *out = flhs <= frhs;
+                return true;
+            case TOKEN_GREATER:
+                *out = flhs > frhs;
+                return true;
+            case TOKEN_GREATER_EQUAL:
+                *out = flhs >= frhs;
+                return true;
+            default:
+                return false;
+            }
+        }
+
         int64_t lhs = 0;
         int64_t rhs = 0;
         if (!codegen_eval_const_i64(ctx, expr->binary_expr.left, &lhs) || !codegen_eval_const_i64(ctx, expr->binary_expr.right, &rhs))
@@ -194,14 +240,39 @@ static bool codegen_eval_const_i64(CodegenContext *ctx, AstNode *expr, int64_t *
 
     case AST_EXPR_CAST:
     {
-        int64_t value = 0;
-        if (!codegen_eval_const_i64(ctx, expr->cast_expr.expr, &value))
+        Type *target = type_resolve_alias(expr->type);
+        Type *source = type_resolve_alias(expr->cast_expr.expr->type);
+        if (!target)
         {
             return false;
         }
 
-        Type *target = type_resolve_alias(expr->type);
-        if (!target)
+        // float to integer casts truncate toward zero
+        int64_t value = 0;
+        if (source && type_is_float(source) && type_is_integer(target))
+        {
+            double fvalue = 0.0;
+            if (!codegen_eval_const_f64(ctx, expr->cast_expr.expr, &fvalue))
+            {
+                return false;
+            }
+
+            // fptosi/fptoui give poison when the truncated value does not fit the target, so such casts
+            // (and nan) are left to run time instead of folding through an undefined c conversion
+            size_t bits = target->size * 8;
+            if (bits == 0 || bits > 64)
+            {
+                return false;
+            }
+            double limit = (double)(1ULL << (bits - 1)) * (type_is_signed(target) ? 1.0 : 2.0);
+            double low   = type_is_signed(target) ? -limit : 0.0;
+            if (!(fvalue < limit && (fvalue > low - 1.0 || fvalue == low)))
+            {
+                return false;
+            }
+            value = type_is_signed(target) ? (int64_t)fvalue : (int64_t)(uint64_t)fvalue;
+        }
+        else if (!codegen_eval_const_i64(ctx, expr->cast_expr.expr, &value))
         {
             return false;
         }
@@ -315,18 +386,12 @@ static bool codegen_eval_const_i64(CodegenContext *ctx, AstNode *expr, int64_t *
                     return false;
                 }
 
-                const char *field_name = field_arg->ident_expr.name;
-                for (size_t i = 0; i < struct_type->composite.field_count; i++)
-                {
-                    Symbol *field = &struct_type->composite.fields[i];
-                    if (strcmp(field->name, field_name) == 0)
-                    {
-                        *out = (int64_t)field->field.offset;
-                        return true;
-                    }
-                }
+                Symbol *field = type_find_field(struct_type, field_arg->ident_expr.name);
+                if (!field)
+                    return false;
 
-                return false;
+                *out = (int64_t)field->field.offset;
+                return true;
             }
         }
         return false;
@@ -336,150 +401,751 @@ static bool codegen_eval_const_i64(CodegenContext *ctx, AstNode *expr, int64_t *
     }
 }
 
-static void codegen_debug_split_path(const char *path, char **dir_out, char **file_out)
+// float counterpart of codegen_eval_const_i64; integer-typed operands fold through it
+static bool codegen_eval_const_f64(CodegenContext *ctx, AstNode *expr, double *out)
 {
-    if (!path)
+    if (!expr || !out)
     {
-        *dir_out  = strdup(".");
-        *file_out = strdup("<unknown>");
-        return;
+        return false;
     }
 
-    char *tmp = strdup(path);
-    if (!tmp)
+    Type *type = type_resolve_alias(expr->type);
+    if (type && type_is_integer(type))
     {
-        *dir_out  = strdup(".");
-        *file_out = strdup(path);
-        return;
+        int64_t value = 0;
+        if (!codegen_eval_const_i64(ctx, expr, &value))
+        {
+            return false;
+        }
+        *out = type_is_signed(type) ? (double)value : (double)(uint64_t)value;
+        return true;
     }
 
-    char *slash = strrchr(tmp, '/');
-    if (!slash)
+    switch (expr->kind)
     {
-        *dir_out  = strdup(".");
-        *file_out = strdup(tmp);
-    }
-    else
+    case AST_EXPR_LIT:
+        switch (expr->lit_expr.kind)
+        {
+        case TOKEN_LIT_FLOAT:
+            *out = expr->lit_expr.float_val;
+            return true;
+        case TOKEN_LIT_INT:
+            *out = (double)expr->lit_expr.int_val;
+            return true;
+        default:
+            return false;
+        }
+
+    case AST_EXPR_IDENT:
     {
-        *slash    = '\0';
-        *dir_out  = strdup(tmp);
-        *file_out = strdup(slash + 1);
+        Symbol *sym = expr->symbol;
+        if (!sym || (sym->kind != SYMBOL_VAL && sym->kind != SYMBOL_VAR) || !sym->decl)
+        {
+            return false;
+        }
+
+        AstNode *decl = sym->decl;
+        if (decl->kind != AST_STMT_VAL && decl->kind != AST_STMT_VAR)
+        {
+            return false;
+        }
+        return codegen_eval_const_f64(ctx, decl->var_stmt.init, out);
     }
 
-    free(tmp);
-}
+    case AST_EXPR_UNARY:
+    {
+        double value = 0.0;
+        if (!codegen_eval_const_f64(ctx, expr->unary_expr.expr, &value))
+        {
+            return false;
+        }
 
-static void codegen_debug_init(CodegenContext *ctx)
-{
-    if (!ctx->debug_info || ctx->di_builder)
-        return;
+        switch (expr->unary_expr.op)
+        {
+        case TOKEN_MINUS:
+            *out = -value;
+            return true;
+        case TOKEN_PLUS:
+            *out = value;
+            return true;
+        default:
+            return false;
+        }
+    }
 
-    const char *source_path = ctx->source_file;
-    if (!source_path || source_path[0] == '\0')
+    case AST_EXPR_BINARY:
     {
-        ctx->debug_info = false;
-        return;
-    }
+        double lhs = 0.0;
+        double rhs = 0.0;
+        if (!codegen_eval_const_f64(ctx, expr->binary_expr.left, &lhs) || !codegen_eval_const_f64(ctx, expr->binary_expr.right, &rhs))
+        {
+            return false;
+        }
 
-    char  resolved[PATH_MAX];
-    char *full_path = NULL;
-    if (realpath(source_path, resolved))
-        full_path = strdup(resolved);
-    else
-        full_path = strdup(source_path);
+        switch (expr->binary_expr.op)
+        {
+        case TOKEN_PLUS:
+            *out = lhs + rhs;
+            return true;
+        case TOKEN_MINUS:
+            *out = lhs - rhs;
+            return true;
+        case TOKEN_STAR:
+            *out = lhs * rhs;
+            return true;
+        case TOKEN_SLASH:
+            *out = lhs / rhs;
+            return true;
+        default:
+            return false;
+        }
+    }
 
-    if (!full_path)
+    case AST_EXPR_CAST:
     {
-        ctx->debug_info = false;
-        return;
+        double value = 0.0;
+        if (!codegen_eval_const_f64(ctx, expr->cast_expr.expr, &value))
+        {
+            return false;
+        }
+
+        // narrowing to f32 rounds here so later folds see the stored value
+        *out = (type && type->kind == TYPE_F32) ? (double)(float)value : value;
+        return true;
     }
 
-    char *dir  = NULL;
-    char *file = NULL;
-    codegen_debug_split_path(full_path, &dir, &file);
-    if (!dir || !file)
-    {
-        free(full_path);
-        free(dir);
-        free(file);
-        ctx->debug_info = false;
-        return;
+    default:
+        return false;
     }
+}
 
-    ctx->debug_full_path = full_path;
-    ctx->debug_dir       = dir;
-    ctx->debug_file      = file;
+// private constant holding a nul-terminated string literal
+static LLVMValueRef codegen_const_string(CodegenContext *ctx, const char *str)
+{
+    size_t       len    = strlen(str);
+    LLVMTypeRef  arr_ty = LLVMArrayType(LLVMInt8TypeInContext(ctx->context), (unsigned)(len + 1));
+    LLVMValueRef global = LLVMAddGlobal(ctx->module, arr_ty, "str");
+    LLVMSetInitializer(global, LLVMConstStringInContext(ctx->context, str, (unsigned)len, false));
+    LLVMSetGlobalConstant(global, true);
+    LLVMSetLinkage(global, LLVMPrivateLinkage);
+    LLVMSetUnnamedAddress(global, LLVMGlobalUnnamedAddr);
+    return global;
+}
 
-    ctx->di_builder = LLVMCreateDIBuilder(ctx->module);
-    if (!ctx->di_builder)
-    {
-        ctx->debug_info = false;
-        return;
-    }
+// link-time address of a function or a global that is not thread-local
+static LLVMValueRef codegen_const_address(CodegenContext *ctx, AstNode *expr)
+{
+    Symbol *sym = expr->symbol;
+    if (!sym)
+        return NULL;
 
-    ctx->di_unknown_type = NULL;
+    bool is_global_var = (sym->kind == SYMBOL_VAR || sym->kind == SYMBOL_VAL) && sym->var.is_global && !sym->var.is_thread_local;
+    if (sym->kind != SYMBOL_FUNC && !is_global_var)
+        return NULL;
 
-    LLVMValueRef    debug_version_val = LLVMConstInt(LLVMInt32TypeInContext(ctx->context), LLVMDebugMetadataVersion(), false);
-    LLVMMetadataRef debug_version     = LLVMValueAsMetadata(debug_version_val);
-    LLVMAddModuleFlag(ctx->module, LLVMModuleFlagBehaviorWarning, "Debug Info Version", strlen("Debug Info Version"), debug_version);
-    LLVMValueRef    dwarf_version_val = LLVMConstInt(LLVMInt32TypeInContext(ctx->context), 5, false);
-    LLVMMetadataRef dwarf_version     = LLVMValueAsMetadata(dwarf_version_val);
-    LLVMAddModuleFlag(ctx->module, LLVMModuleFlagBehaviorWarning, "Dwarf Version", strlen("Dwarf Version"), dwarf_version);
+    if (expr->kind == AST_EXPR_IDENT)
+        return codegen_expr_ident(ctx, expr);
 
-    ctx->di_file         = LLVMDIBuilderCreateFile(ctx->di_builder, ctx->debug_file, strlen(ctx->debug_file), ctx->debug_dir, strlen(ctx->debug_dir));
-    ctx->di_compile_unit = LLVMDIBuilderCreateCompileUnit(ctx->di_builder, LLVMDWARFSourceLanguageC, ctx->di_file, "mach-c", strlen("mach-c"), ctx->opt_level > 0, "", 0, 0, "", 0, LLVMDWARFEmissionFull, 0, false, false, "", 0, "", 0);
+    // module member: mod.name
+    AstNode *object = expr->kind == AST_EXPR_FIELD ? expr->field_expr.object : NULL;
+    if (object && object->kind == AST_EXPR_IDENT && object->symbol && object->symbol->kind == SYMBOL_MODULE)
+        return codegen_expr_field(ctx, expr);
 
-    ctx->current_di_scope = ctx->di_compile_unit;
-    ctx->debug_finalized  = false;
+    return NULL;
 }
 
-static void codegen_debug_finalize(CodegenContext *ctx)
+static LLVMValueRef codegen_const_value(CodegenContext *ctx, AstNode *expr, Type *type);
+
+static LLVMValueRef codegen_const_pointer(CodegenContext *ctx, AstNode *expr, LLVMTypeRef llvm_type)
 {
-    if (!ctx->debug_info || !ctx->di_builder || ctx->debug_finalized)
-        return;
-    LLVMDIBuilderFinalize(ctx->di_builder);
-    ctx->debug_finalized = true;
+    switch (expr->kind)
+    {
+    case AST_EXPR_LIT:
+        if (expr->lit_expr.kind == TOKEN_LIT_STRING)
+            return codegen_const_string(ctx, expr->lit_expr.string_val);
+        break;
+    case AST_EXPR_UNARY:
+        if (expr->unary_expr.op == TOKEN_QUESTION)
+            return codegen_const_address(ctx, expr->unary_expr.expr);
+        break;
+    case AST_EXPR_CAST:
+    {
+        Type *source = type_resolve_alias(expr->cast_expr.expr->type);
+        if (source && type_is_pointer_like(source))
+            return codegen_const_pointer(ctx, expr->cast_expr.expr, llvm_type);
+        break;
+    }
+    case AST_EXPR_IDENT:
+    case AST_EXPR_FIELD:
+        if (expr->symbol && expr->symbol->kind == SYMBOL_FUNC)
+            return codegen_const_address(ctx, expr);
+        break;
+    default:
+        break;
+    }
+
+    // integer addresses, nil and pointer vals
+    int64_t value = 0;
+    if (!codegen_eval_const_i64(ctx, expr, &value))
+        return NULL;
+    if (value == 0)
+        return LLVMConstNull(llvm_type);
+    return LLVMConstIntToPtr(LLVMConstInt(LLVMInt64TypeInContext(ctx->context), (unsigned long long)value, false), llvm_type);
 }
 
-static LLVMMetadataRef codegen_get_current_scope(CodegenContext *ctx)
+static LLVMValueRef codegen_const_fat_pointer(CodegenContext *ctx, LLVMTypeRef llvm_type, LLVMValueRef data, uint64_t len)
 {
-    if (ctx->current_di_scope)
-        return ctx->current_di_scope;
-    return ctx->di_compile_unit;
+    LLVMValueRef fields[2] = {data, LLVMConstInt(LLVMInt64TypeInContext(ctx->context), len, false)};
+    return LLVMConstNamedStruct(llvm_type, fields, 2);
 }
 
-static void codegen_set_debug_location(CodegenContext *ctx, AstNode *node)
+// elements of an array literal, converted to the element type and zero-padded to count
+static LLVMValueRef codegen_const_elements(CodegenContext *ctx, AstNode *expr, Type *elem_type, size_t count, bool as_vector)
 {
-    if (!ctx->debug_info || !ctx->di_builder)
-        return;
-    if (!node || !node->token || !ctx->source_lexer)
-        return;
-
-    int             line  = lexer_get_pos_line(ctx->source_lexer, node->token->pos);
-    int             col   = lexer_get_pos_line_offset(ctx->source_lexer, node->token->pos);
-    LLVMMetadataRef scope = codegen_get_current_scope(ctx);
-    if (!scope)
-        return;
-    if (scope != ctx->di_compile_unit)
+    LLVMTypeRef   llvm_elem = codegen_get_llvm_type(ctx, elem_type);
+    size_t        given     = expr->array_expr.elems ? (size_t)expr->array_expr.elems->count : 0;
+    LLVMValueRef *values    = malloc(sizeof(LLVMValueRef) * (count ? count : 1));
+    if (!values || !llvm_elem || given > count)
     {
-        LLVMMetadataRef loc = LLVMDIBuilderCreateDebugLocation(ctx->context, (unsigned)(line + 1), (unsigned)(col + 1), scope, NULL);
-        LLVMSetCurrentDebugLocation2(ctx->builder, loc);
+        free(values);
+        return NULL;
     }
-}
 
-static LLVMMetadataRef codegen_debug_get_unknown_type(CodegenContext *ctx)
-{
-    if (!ctx->di_builder)
-        return NULL;
-    if (!ctx->di_unknown_type)
+    for (size_t i = 0; i < count; i++)
     {
-        const char *name     = "u64";
-        ctx->di_unknown_type = LLVMDIBuilderCreateBasicType(ctx->di_builder, name, strlen(name), 0, 64, 0);
+        // a single vector element is splatted across every lane
+        AstNode *elem = NULL;
+        if (i < given)
+            elem = expr->array_expr.elems->items[i];
+        else if (as_vector && given == 1)
+            elem = expr->array_expr.elems->items[0];
+
+        values[i] = elem ? codegen_const_value(ctx, elem, elem_type) : LLVMConstNull(llvm_elem);
+        if (!values[i])
+        {
+            free(values);
+            return NULL;
+        }
     }
-    return ctx->di_unknown_type;
+
+    LLVMValueRef result = as_vector ? LLVMConstVector(values, (unsigned)count) : LLVMConstArray(llvm_elem, values, (unsigned)count);
+    free(values);
+    return result;
 }
 
-static LLVMMetadataRef codegen_debug_create_subprogram(CodegenContext *ctx, AstNode *stmt, LLVMValueRef func, const char *display_name, const char *link_name, size_t param_count)
+static LLVMValueRef codegen_const_slice(CodegenContext *ctx, AstNode *expr, Type *slice_type, LLVMTypeRef llvm_type)
+{
+    Type *elem_type = slice_type->array.elem_type;
+
+    if (expr->kind == AST_EXPR_LIT && expr->lit_expr.kind == TOKEN_LIT_STRING)
+        return codegen_const_fat_pointer(ctx, llvm_type, codegen_const_string(ctx, expr->lit_expr.string_val), strlen(expr->lit_expr.string_val));
+
+    if (expr->kind != AST_EXPR_ARRAY)
+        return NULL;
+
+    LLVMTypeRef ptr_ty = LLVMPointerTypeInContext(ctx->context, 0);
+    size_t      given  = expr->array_expr.elems ? (size_t)expr->array_expr.elems->count : 0;
+    if (expr->array_expr.is_slice_literal)
+    {
+        // []T{data, len}
+        LLVMValueRef data = given >= 1 ? codegen_const_pointer(ctx, expr->array_expr.elems->items[0], ptr_ty) : LLVMConstNull(ptr_ty);
+        int64_t      len  = 0;
+        if (!data || (given >= 2 && !codegen_eval_const_i64(ctx, expr->array_expr.elems->items[1], &len)))
+            return NULL;
+        return codegen_const_fat_pointer(ctx, llvm_type, data, (uint64_t)len);
+    }
+
+    // the elements get their own private global; it stays writable when backing a var
+    LLVMValueRef elements = codegen_const_elements(ctx, expr, elem_type, given, false);
+    if (!elements)
+        return NULL;
+
+    LLVMValueRef backing = LLVMAddGlobal(ctx->module, LLVMTypeOf(elements), "array_literal");
+    LLVMSetInitializer(backing, elements);
+    LLVMSetGlobalConstant(backing, !ctx->generating_mutable_init);
+    LLVMSetLinkage(backing, LLVMPrivateLinkage);
+    return codegen_const_fat_pointer(ctx, llvm_type, backing, given);
+}
+
+static LLVMValueRef codegen_const_composite(CodegenContext *ctx, AstNode *expr, Type *target, LLVMTypeRef llvm_type)
+{
+    if (expr->kind != AST_EXPR_STRUCT)
+        return NULL;
+
+    AstList *inits = expr->struct_expr.fields;
+    if (target->kind == TYPE_UNION)
+    {
+        if (!inits || inits->count == 0)
+            return LLVMConstNull(llvm_type);
+
+        // only the member that defines the union's storage type can be expressed as a constant
+        AstNode *init  = inits->items[0];
+        Symbol  *field = type_find_field(target, init->field_expr.field);
+        if (!field)
+            return NULL;
+
+        LLVMValueRef value = codegen_const_value(ctx, init->field_expr.object, field->type);
+        if (!value || LLVMCountStructElementTypes(llvm_type) != 1 || LLVMTypeOf(value) != LLVMStructGetTypeAtIndex(llvm_type, 0))
+            return NULL;
+        return LLVMConstStructInContext(ctx->context, &value, 1, false);
+    }
+
+    size_t count = 0;
+    for (Symbol *field = target->composite.fields; field; field = field->next)
+        count++;
+
+    LLVMValueRef *values = malloc(sizeof(LLVMValueRef) * (count ? count : 1));
+    if (!values)
+        return NULL;
+
+    // fields without an initializer are zero, as in codegen_expr_struct
+    size_t index = 0;
+    for (Symbol *field = target->composite.fields; field; field = field->next)
+        values[index++] = LLVMConstNull(codegen_get_llvm_type(ctx, field->type));
+
+    for (int i = 0; inits && i < inits->count; i++)
+    {
+        AstNode     *init  = inits->items[i];
+        Symbol      *field = type_find_field(target, init->field_expr.field);
+        LLVMValueRef value = field ? codegen_const_value(ctx, init->field_expr.object, field->type) : NULL;
+        if (!value)
+        {
+            free(values);
+            return NULL;
+        }
+        values[field->field.index] = value;
+    }
+
+    LLVMValueRef result = LLVMConstNamedStruct(llvm_type, values, (unsigned)count);
+    free(values);
+    return result;
+}
+
+// fold a global initializer into an llvm constant of the given type; null when it needs code to run.
+// scalars are evaluated here in c, so the result never depends on llvm constant expressions
+static LLVMValueRef codegen_const_value(CodegenContext *ctx, AstNode *expr, Type *type)
+{
+    Type       *target    = type_resolve_alias(type);
+    LLVMTypeRef llvm_type = target ? codegen_get_llvm_type(ctx, target) : NULL;
+    if (!expr || !llvm_type)
+        return NULL;
+
+    if (expr->kind == AST_EXPR_NULL)
+        return LLVMConstNull(llvm_type);
+
+    // aggregates named by another val fold through that val's initializer
+    if (expr->kind == AST_EXPR_IDENT && expr->symbol && expr->symbol->kind == SYMBOL_VAL && expr->symbol->decl && !type_is_numeric(target) && !type_is_pointer_like(target))
+    {
+        AstNode *decl = expr->symbol->decl;
+        if ((decl->kind == AST_STMT_VAL || decl->kind == AST_STMT_VAR) && decl->var_stmt.init)
+            return codegen_const_value(ctx, decl->var_stmt.init, type);
+    }
+
+    if (type_is_integer(target))
+    {
+        int64_t value = 0;
+        if (!codegen_eval_const_i64(ctx, expr, &value))
+            return NULL;
+        return LLVMConstInt(llvm_type, (unsigned long long)value, type_is_signed(target));
+    }
+
+    if (type_is_float(target))
+    {
+        double value = 0.0;
+        if (!codegen_eval_const_f64(ctx, expr, &value))
+            return NULL;
+        return LLVMConstReal(llvm_type, value);
+    }
+
+    switch (target->kind)
+    {
+    case TYPE_PTR:
+    case TYPE_POINTER:
+    case TYPE_FUNCTION:
+        return codegen_const_pointer(ctx, expr, llvm_type);
+    case TYPE_ARRAY:
+        if (target->array.is_slice)
+            return codegen_const_slice(ctx, expr, target, llvm_type);
+        return expr->kind == AST_EXPR_ARRAY ? codegen_const_elements(ctx, expr, target->array.elem_type, target->array.size, false) : NULL;
+    case TYPE_VECTOR:
+        return expr->kind == AST_EXPR_ARRAY ? codegen_const_elements(ctx, expr, target->vector.elem_type, target->vector.count, true) : NULL;
+    case TYPE_STRUCT:
+    case TYPE_UNION:
+        return codegen_const_composite(ctx, expr, target, llvm_type);
+    default:
+        return NULL;
+    }
+}
+
+static LLVMValueRef codegen_const_comptime_bytes(CodegenContext *ctx, const ComptimeValue *value, Type *type, const uint8_t *bytes);
+
+static uint64_t codegen_comptime_bits(const uint8_t *bytes, size_t size)
+{
+    uint8_t  u8  = 0;
+    uint16_t u16 = 0;
+    uint32_t u32 = 0;
+    uint64_t u64 = 0;
+    switch (size)
+    {
+    case 1:
+        memcpy(&u8, bytes, 1);
+        return u8;
+    case 2:
+        memcpy(&u16, bytes, 2);
+        return u16;
+    case 4:
+        memcpy(&u32, bytes, 4);
+        return u32;
+    default:
+        memcpy(&u64, bytes, 8);
+        return u64;
+    }
+}
+
+// pointer in an interpreter result: nil, a function, or into a private copy of the allocation it targets;
+// every pointer into the same allocation shares that copy, so identity and aliasing survive emission
+static LLVMValueRef codegen_comptime_pointer(CodegenContext *ctx, const ComptimeValue *value, Type *pointee, uint64_t addr)
+{
+    LLVMTypeRef ptr_ty = LLVMPointerTypeInContext(ctx->context, 0);
+    if (addr == 0)
+        return LLVMConstNull(ptr_ty);
+
+    Symbol *function = comptime_value_function(value, addr);
+    if (function)
+    {
+        LLVMValueRef func = codegen_get_symbol_value(ctx, function);
+        if (!func)
+        {
+            codegen_declare_function_symbol(ctx, function);
+            func = codegen_get_symbol_value(ctx, function);
+        }
+        return func;
+    }
+
+    // pointers into interpreter locals did not outlive the evaluation
+    const ComptimeAlloc *alloc = comptime_value_find_alloc(value, addr);
+    if (!alloc)
+        return NULL;
+
+    LLVMValueRef *slot   = &ctx->comptime_globals[alloc - value->allocs];
+    LLVMValueRef  global = *slot;
+    if (!global)
+    {
+        // the allocation is re-typed as an array of the first pointee asked for; 'ptr' sees bytes
+        Type  *elem_type = pointee ? type_resolve_alias(pointee) : type_u8();
+        size_t elem_size = elem_type ? type_sizeof(elem_type) : 0;
+        if (elem_size == 0 || alloc->size % elem_size != 0 || (addr - alloc->addr) % elem_size != 0)
+            return NULL;
+
+        // the global exists before its elements are built, so elements may point back into it
+        size_t         count     = alloc->size / elem_size;
+        const uint8_t *data      = comptime_value_memory(value, alloc->addr);
+        LLVMTypeRef    llvm_elem = codegen_get_llvm_type(ctx, elem_type);
+        LLVMTypeRef    array_ty  = LLVMArrayType(llvm_elem, (unsigned)count);
+        global                   = LLVMAddGlobal(ctx->module, array_ty, "comptime_data");
+        LLVMSetGlobalConstant(global, !ctx->generating_mutable_init);
+        LLVMSetLinkage(global, LLVMPrivateLinkage);
+        *slot = global;
+
+        LLVMValueRef init = NULL;
+        if (elem_size == 1 && type_is_integer(elem_type))
+        {
+            init = LLVMConstStringInContext(ctx->context, (const char *)data, (unsigned)count, true);
+        }
+        else
+        {
+            LLVMValueRef *elems = malloc(sizeof(LLVMValueRef) * (count ? count : 1));
+            bool          ok    = elems != NULL;
+            for (size_t i = 0; ok && i < count; i++)
+            {
+                elems[i] = codegen_const_comptime_bytes(ctx, value, elem_type, data + i * elem_size);
+                ok       = elems[i] != NULL;
+            }
+            init = ok ? LLVMConstArray(llvm_elem, elems, (unsigned)count) : NULL;
+            free(elems);
+        }
+
+        // a failed value is discarded whole; the unused global is left for dead-global removal
+        LLVMSetInitializer(global, init ? init : LLVMConstNull(array_ty));
+        if (!init)
+            return NULL;
+    }
+    if (addr == alloc->addr)
+        return global;
+
+    // later pointers may see the allocation as a different element type, so offsets are in bytes
+    LLVMValueRef offset = LLVMConstInt(LLVMInt64TypeInContext(ctx->context), addr - alloc->addr, false);
+    return LLVMConstInBoundsGEP2(LLVMInt8TypeInContext(ctx->context), global, &offset, 1);
+}
+
+// llvm constant for the value of type laid out at bytes; aggregates follow the field offsets semantic assigned
+static LLVMValueRef codegen_const_comptime_bytes(CodegenContext *ctx, const ComptimeValue *value, Type *type, const uint8_t *bytes)
+{
+    Type       *target    = type_resolve_alias(type);
+    LLVMTypeRef llvm_type = target ? codegen_get_llvm_type(ctx, target) : NULL;
+    if (!llvm_type || !bytes)
+        return NULL;
+
+    if (type_is_integer(target))
+        return LLVMConstInt(llvm_type, codegen_comptime_bits(bytes, type_sizeof(target)), false);
+
+    switch (target->kind)
+    {
+    case TYPE_F16:
+        return LLVMConstBitCast(LLVMConstInt(LLVMInt16TypeInContext(ctx->context), codegen_comptime_bits(bytes, 2), false), llvm_type);
+    case TYPE_F32:
+    {
+        float value32 = 0.0f;
+        memcpy(&value32, bytes, sizeof(value32));
+        return LLVMConstReal(llvm_type, value32);
+    }
+    case TYPE_F64:
+    {
+        double value64 = 0.0;
+        memcpy(&value64, bytes, sizeof(value64));
+        return LLVMConstReal(llvm_type, value64);
+    }
+    case TYPE_PTR:
+    case TYPE_FUNCTION:
+        return codegen_comptime_pointer(ctx, value, NULL, codegen_comptime_bits(bytes, 8));
+    case TYPE_POINTER:
+        return codegen_comptime_pointer(ctx, value, target->pointer.base, codegen_comptime_bits(bytes, 8));
+    case TYPE_ARRAY:
+    case TYPE_VECTOR:
+    {
+        if (target->kind == TYPE_ARRAY && target->array.is_slice)
+        {
+            uint64_t             data  = codegen_comptime_bits(bytes, 8);
+            uint64_t             len   = codegen_comptime_bits(bytes + 8, 8);
+            size_t               size  = type_sizeof(type_resolve_alias(target->array.elem_type));
+            const ComptimeAlloc *alloc = comptime_value_find_alloc(value, data);
+            if (data && (!alloc || len > (alloc->addr + alloc->size - data) / (size ? size : 1)))
+                return NULL;
+
+            LLVMValueRef ptr = codegen_comptime_pointer(ctx, value, target->array.elem_type, data);
+            return ptr ? codegen_const_fat_pointer(ctx, llvm_type, ptr, len) : NULL;
+        }
+
+        bool          is_vector = target->kind == TYPE_VECTOR;
+        Type         *elem_type = is_vector ? target->vector.elem_type : target->array.elem_type;
+        size_t        count     = is_vector ? target->vector.count : target->array.size;
+        size_t        elem_size = type_sizeof(type_resolve_alias(elem_type));
+        LLVMValueRef *elems     = malloc(sizeof(LLVMValueRef) * (count ? count : 1));
+        if (!elems)
+            return NULL;
+        for (size_t i = 0; i < count; i++)
+        {
+            elems[i] = codegen_const_comptime_bytes(ctx, value, elem_type, bytes + i * elem_size);
+            if (!elems[i])
+            {
+                free(elems);
+                return NULL;
+            }
+        }
+        LLVMValueRef result = is_vector ? LLVMConstVector(elems, (unsigned)count) : LLVMConstArray(codegen_get_llvm_type(ctx, elem_type), elems, (unsigned)count);
+        free(elems);
+        return result;
+    }
+    case TYPE_STRUCT:
+    {
+        size_t count = 0;
+        for (Symbol *field = target->composite.fields; field; field = field->next)
+            count++;
+
+        LLVMValueRef *fields = malloc(sizeof(LLVMValueRef) * (count ? count : 1));
+        if (!fields)
+            return NULL;
+
+        size_t index = 0;
+        for (Symbol *field = target->composite.fields; field; field = field->next)
+        {
+            fields[index] = codegen_const_comptime_bytes(ctx, value, field->type, bytes + field->field.offset);
+            if (!fields[index++])
+            {
+                free(fields);
+                return NULL;
+            }
+        }
+        LLVMValueRef result = LLVMConstNamedStruct(llvm_type, fields, (unsigned)count);
+        free(fields);
+        return result;
+    }
+    case TYPE_UNION:
+    {
+        // the storage member is the first largest one, as in codegen_get_llvm_type
+        Symbol *largest = NULL;
+        for (Symbol *field = target->composite.fields; field; field = field->next)
+        {
+            if (!largest || field->type->size > largest->type->size)
+                largest = field;
+        }
+        if (!largest || largest->type->size == 0)
+            return LLVMConstNull(llvm_type);
+
+        LLVMValueRef member = codegen_const_comptime_bytes(ctx, value, largest->type, bytes);
+        return member ? LLVMConstStructInContext(ctx->context, &member, 1, false) : NULL;
+    }
+    default:
+        return NULL;
+    }
+}
+
+static LLVMValueRef codegen_const_comptime(CodegenContext *ctx, const ComptimeValue *value)
+{
+    ctx->comptime_globals = calloc(value->alloc_count ? value->alloc_count : 1, sizeof(LLVMValueRef));
+    if (!ctx->comptime_globals)
+        return NULL;
+
+    LLVMValueRef result = codegen_const_comptime_bytes(ctx, value, value->type, value->bytes);
+    free(ctx->comptime_globals);
+    ctx->comptime_globals = NULL;
+    return result;
+}
+
+static void codegen_debug_split_path(const char *path, char **dir_out, char **file_out)
+{
+    if (!path)
+    {
+        *dir_out  = strdup(".");
+        *file_out = strdup("<unknown>");
+        return;
+    }
+
+    char *tmp = strdup(path);
+    if (!tmp)
+    {
+        *dir_out  = strdup(".");
+        *file_out = strdup(path);
+        return;
+    }
+
+    char *slash = strrchr(tmp, '/');
+    if (!slash)
+    {
+        *dir_out  = strdup(".");
+        *file_out = strdup(tmp);
+    }
+    else
+    {
+        *slash    = '\0';
+        *dir_out  = strdup(tmp);
+        *file_out = strdup(slash + 1);
+    }
+
+    free(tmp);
+}
+
+static void codegen_debug_init(CodegenContext *ctx)
+{
+    if (!ctx->debug_info || ctx->di_builder)
+        return;
+
+    const char *source_path = ctx->source_file;
+    if (!source_path || source_path[0] == '\0')
+    {
+        ctx->debug_info = false;
+        return;
+    }
+
+    char  resolved[PATH_MAX];
+    char *full_path = NULL;
+    if (realpath(source_path, resolved))
+        full_path = strdup(resolved);
+    else
+        full_path = strdup(source_path);
+
+    if (!full_path)
+    {
+        ctx->debug_info = false;
+        return;
+    }
+
+    char *dir  = NULL;
+    char *file = NULL;
+    codegen_debug_split_path(full_path, &dir, &file);
+    if (!dir || !file)
+    {
+        free(full_path);
+        free(dir);
+        free(file);
+        ctx->debug_info = false;
+        return;
+    }
+
+    ctx->debug_full_path = full_path;
+    ctx->debug_dir       = dir;
+    ctx->debug_file      = file;
+
+    ctx->di_builder = LLVMCreateDIBuilder(ctx->module);
+    if (!ctx->di_builder)
+    {
+        ctx->debug_info = false;
+        return;
+    }
+
+    ctx->di_unknown_type = NULL;
+
+    LLVMValueRef    debug_version_val = LLVMConstInt(LLVMInt32TypeInContext(ctx->context), LLVMDebugMetadataVersion(), false);
+    LLVMMetadataRef debug_version     = LLVMValueAsMetadata(debug_version_val);
+    LLVMAddModuleFlag(ctx->module, LLVMModuleFlagBehaviorWarning, "Debug Info Version", strlen("Debug Info Version"), debug_version);
+    LLVMValueRef    dwarf_version_val = LLVMConstInt(LLVMInt32TypeInContext(ctx->context), 5, false);
+    LLVMMetadataRef dwarf_version     = LLVMValueAsMetadata(dwarf_version_val);
+    LLVMAddModuleFlag(ctx->module, LLVMModuleFlagBehaviorWarning, "Dwarf Version", strlen("Dwarf Version"), dwarf_version);
+
+    ctx->di_file         = LLVMDIBuilderCreateFile(ctx->di_builder, ctx->debug_file, strlen(ctx->debug_file), ctx->debug_dir, strlen(ctx->debug_dir));
+    ctx->di_compile_unit = LLVMDIBuilderCreateCompileUnit(ctx->di_builder, LLVMDWARFSourceLanguageC, ctx->di_file, "mach-c", strlen("mach-c"), ctx->opt_level > 0, "", 0, 0, "", 0, LLVMDWARFEmissionFull, 0, false, false, "", 0, "", 0);
+
+    ctx->current_di_scope = ctx->di_compile_unit;
+    ctx->debug_finalized  = false;
+}
+
+static void codegen_debug_finalize(CodegenContext *ctx)
+{
+    if (!ctx->debug_info || !ctx->di_builder || ctx->debug_finalized)
+        return;
+    LLVMDIBuilderFinalize(ctx->di_builder);
+    ctx->debug_finalized = true;
+}
+
+static LLVMMetadataRef codegen_get_current_scope(CodegenContext *ctx)
+{
+    if (ctx->current_di_scope)
+        return ctx->current_di_scope;
+    return ctx->di_compile_unit;
+}
+
+static void codegen_set_debug_location(CodegenContext *ctx, AstNode *node)
+{
+    if (!ctx->debug_info || !ctx->di_builder)
+        return;
+    if (!node || !node->token || !ctx->source_lexer)
+        return;
+
+    int             line  = lexer_get_pos_line(ctx->source_lexer, node->token->pos);
+    int             col   = lexer_get_pos_line_offset(ctx->source_lexer, node->token->pos);
+    LLVMMetadataRef scope = codegen_get_current_scope(ctx);
+    if (!scope)
+        return;
+    if (scope != ctx->di_compile_unit)
+    {
+        LLVMMetadataRef loc = LLVMDIBuilderCreateDebugLocation(ctx->context, (unsigned)(line + 1), (unsigned)(col + 1), scope, NULL);
+        LLVMSetCurrentDebugLocation2(ctx->builder, loc);
+    }
+}
+
+static LLVMMetadataRef codegen_debug_get_unknown_type(CodegenContext *ctx)
+{
+    if (!ctx->di_builder)
+        return NULL;
+    if (!ctx->di_unknown_type)
+    {
+        const char *name     = "u64";
+        ctx->di_unknown_type = LLVMDIBuilderCreateBasicType(ctx->di_builder, name, strlen(name), 0, 64, 0);
+    }
+    return ctx->di_unknown_type;
+}
+
+static LLVMMetadataRef codegen_debug_create_subprogram(CodegenContext *ctx, AstNode *stmt, LLVMValueRef func, const char *display_name, const char *link_name, size_t param_count)
 {
     if (!ctx->debug_info || !ctx->di_builder || !func)
         return NULL;
@@ -517,6 +1183,199 @@ static LLVMMetadataRef codegen_debug_create_subprogram(CodegenContext *ctx, AstN
     return subprogram;
 }
 
+// mach variadics take three hidden parameters after the fixed ones: the argument count, a packed
+// block holding the argument values, and a constant descriptor with a {type tag, offset} pair per argument
+#define CODEGEN_MACH_VARARG_PARAMS 3
+
+static void codegen_mach_vararg_param_types(CodegenContext *ctx, LLVMTypeRef *out)
+{
+    LLVMTypeRef ptr_ty = LLVMPointerTypeInContext(ctx->context, 0);
+    out[0]             = LLVMInt64TypeInContext(ctx->context);
+    out[1]             = ptr_ty;
+    out[2]             = ptr_ty;
+}
+
+static LLVMTypeRef codegen_vararg_desc_type(CodegenContext *ctx)
+{
+    LLVMTypeRef i64_ty      = LLVMInt64TypeInContext(ctx->context);
+    LLVMTypeRef elements[2] = {i64_ty, i64_ty};
+    return LLVMStructTypeInContext(ctx->context, elements, 2, false);
+}
+
+// large aggregate results come back through a hidden sret pointer ahead of the fixed parameters;
+// the caller supplies the destination and the callee constructs the value there
+static bool codegen_returns_sret(Type *func_type)
+{
+    return func_type && func_type->function.return_type && codegen_is_large_aggregate(func_type->function.return_type);
+}
+
+// llvm signature of a function type, including the hidden sret and mach variadic parameters
+static LLVMTypeRef codegen_function_llvm_type(CodegenContext *ctx, Type *func_type, bool uses_mach_varargs)
+{
+    bool        returns_sret = codegen_returns_sret(func_type);
+    size_t      first_fixed  = returns_sret ? 1 : 0;
+    size_t      fixed_params = func_type->function.param_count;
+    size_t      param_count  = first_fixed + fixed_params + (uses_mach_varargs ? CODEGEN_MACH_VARARG_PARAMS : 0);
+    LLVMTypeRef return_type  = func_type->function.return_type && !returns_sret ? codegen_get_llvm_type(ctx, func_type->function.return_type) : LLVMVoidTypeInContext(ctx->context);
+
+    LLVMTypeRef *param_types = NULL;
+    if (param_count > 0)
+    {
+        param_types = malloc(sizeof(LLVMTypeRef) * param_count);
+        if (!param_types)
+            return NULL;
+
+        if (returns_sret)
+            param_types[0] = LLVMPointerTypeInContext(ctx->context, 0);
+        for (size_t i = 0; i < fixed_params; i++)
+        {
+            param_types[first_fixed + i] = codegen_get_llvm_type(ctx, func_type->function.param_types[i]);
+        }
+        if (uses_mach_varargs)
+            codegen_mach_vararg_param_types(ctx, param_types + first_fixed + fixed_params); // hidden count, data and descriptor
+    }
+
+    LLVMTypeRef llvm_func_type = LLVMFunctionType(return_type, param_types, (unsigned)param_count, uses_mach_varargs ? false : func_type->function.is_variadic);
+    free(param_types);
+    return llvm_func_type;
+}
+
+static LLVMAttributeRef codegen_sret_attribute(CodegenContext *ctx, Type *func_type)
+{
+    unsigned kind = LLVMGetEnumAttributeKindForName("sret", strlen("sret"));
+    return LLVMCreateTypeAttribute(ctx->context, kind, codegen_get_llvm_type(ctx, func_type->function.return_type));
+}
+
+// the sret slot is always a fresh variable or temporary of the caller, so it aliases nothing the callee can see
+static void codegen_mark_sret_param(CodegenContext *ctx, LLVMValueRef func, Type *func_type)
+{
+    if (!codegen_returns_sret(func_type))
+        return;
+
+    unsigned noalias = LLVMGetEnumAttributeKindForName("noalias", strlen("noalias"));
+    LLVMAddAttributeAtIndex(func, 1, codegen_sret_attribute(ctx, func_type));
+    LLVMAddAttributeAtIndex(func, 1, LLVMCreateEnumAttribute(ctx->context, noalias, 0));
+}
+
+// runtime identifier shared by type_of() and the variadic descriptor tags
+static uint64_t codegen_type_tag(Type *type)
+{
+    type          = type_resolve_alias(type);
+    uint64_t hash = (uint64_t)type->kind;
+    hash          = hash * 31 + type->size;
+    hash          = hash * 31 + type->alignment;
+    return hash;
+}
+
+static void codegen_add_function_attribute(CodegenContext *ctx, LLVMValueRef func, const char *name)
+{
+    unsigned kind = LLVMGetEnumAttributeKindForName(name, strlen(name));
+    LLVMAddAttributeAtIndex(func, LLVMAttributeFunctionIndex, LLVMCreateEnumAttribute(ctx->context, kind, 0));
+}
+
+// lower '#@' function annotations; declarations carry them too so callers see cold or noreturn callees
+static void codegen_apply_function_hints(CodegenContext *ctx, LLVMValueRef func, const FunHints *hints)
+{
+    if (hints->is_cold)
+        codegen_add_function_attribute(ctx, func, "cold");
+    if (hints->is_hot)
+        codegen_add_function_attribute(ctx, func, "hot");
+    if (hints->is_inline)
+        codegen_add_function_attribute(ctx, func, "alwaysinline");
+    if (hints->is_noinline)
+        codegen_add_function_attribute(ctx, func, "noinline");
+    if (hints->is_noreturn)
+        codegen_add_function_attribute(ctx, func, "noreturn");
+    if (hints->align > 0)
+        LLVMSetAlignment(func, (unsigned)hints->align);
+    if (hints->section)
+        LLVMSetSection(func, hints->section);
+}
+
+// llvm's memory attribute packs a 2-bit ref/mod mask per location, argmem first and inaccessiblemem second;
+// the remaining locations differ between llvm versions, so accesses to other memory fill every slot
+static uint64_t codegen_memory_effects(uint8_t memory, bool returns_sret)
+{
+    enum
+    {
+        REF       = 1,
+        MOD       = 2,
+        LOCATIONS = 16,
+    };
+
+    uint64_t other        = (memory & FUN_EFFECT_OTHER_READ ? REF : 0) | (memory & FUN_EFFECT_OTHER_WRITE ? MOD : 0);
+    uint64_t arg          = other | (memory & FUN_EFFECT_ARG_READ ? REF : 0) | (memory & FUN_EFFECT_ARG_WRITE ? MOD : 0) | (returns_sret ? MOD : 0);
+    uint64_t inaccessible = other | (memory & FUN_EFFECT_TRAP ? REF | MOD : 0); // abort()
+
+    uint64_t value = arg | (inaccessible << 2);
+    for (unsigned location = 2; location < LOCATIONS; location++)
+        value |= other << (location * 2);
+    return value;
+}
+
+static void codegen_add_enum_attribute(CodegenContext *ctx, LLVMValueRef func, unsigned index, const char *name, uint64_t value)
+{
+    unsigned kind = LLVMGetEnumAttributeKindForName(name, strlen(name));
+    if (kind)
+        LLVMAddAttributeAtIndex(func, index, LLVMCreateEnumAttribute(ctx->context, kind, value));
+}
+
+// lower inferred effects; imported clones defer to the symbol that was analysed
+static void codegen_apply_function_effects(CodegenContext *ctx, LLVMValueRef func, Symbol *sym, Type *func_type)
+{
+    while (sym && sym->import_origin && sym->import_origin != sym)
+        sym = sym->import_origin;
+    if (!sym || sym->kind != SYMBOL_FUNC || !sym->func.effects.inferred)
+        return;
+
+    const FunEffects *effects      = &sym->func.effects;
+    bool              returns_sret = codegen_returns_sret(func_type);
+
+    if (effects->nounwind)
+        codegen_add_function_attribute(ctx, func, "nounwind");
+    if (effects->willreturn)
+        codegen_add_function_attribute(ctx, func, "willreturn");
+
+    // llvm 21 replaced nocapture with captures(none), which encodes as zero
+    const char *nocapture = LLVMGetEnumAttributeKindForName("nocapture", strlen("nocapture")) ? "nocapture" : "captures";
+    unsigned    first     = returns_sret ? 2 : 1;
+    for (size_t i = 0; i < func_type->function.param_count && i < 64; i++)
+    {
+        if ((effects->nocapture >> i) & 1)
+            codegen_add_enum_attribute(ctx, func, first + (unsigned)i, nocapture, 0);
+        if ((effects->readonly >> i) & 1)
+            codegen_add_enum_attribute(ctx, func, first + (unsigned)i, "readonly", 0);
+    }
+
+    // instrumentation adds counter updates the inference never saw
+    if (ctx->pipeline.profile_generate)
+        return;
+
+    uint64_t memory = codegen_memory_effects(effects->memory, returns_sret);
+    if (memory != 0xffffffffu)
+        codegen_add_enum_attribute(ctx, func, LLVMAttributeFunctionIndex, "memory", memory);
+}
+
+// #@flatten: llvm has no function-level attribute, so every direct call in the body becomes alwaysinline
+static void codegen_flatten_calls(CodegenContext *ctx, LLVMValueRef func)
+{
+    unsigned kind = LLVMGetEnumAttributeKindForName("alwaysinline", strlen("alwaysinline"));
+    for (LLVMBasicBlockRef block = LLVMGetFirstBasicBlock(func); block; block = LLVMGetNextBasicBlock(block))
+    {
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(block); inst; inst = LLVMGetNextInstruction(inst))
+        {
+            if (!LLVMIsACallInst(inst))
+                continue;
+
+            LLVMValueRef callee = LLVMGetCalledValue(inst);
+            if (!LLVMIsAFunction(callee) || LLVMGetIntrinsicID(callee) != 0)
+                continue;
+
+            LLVMAddCallSiteAttribute(inst, LLVMAttributeFunctionIndex, LLVMCreateEnumAttribute(ctx->context, kind, 0));
+        }
+    }
+}
+
 static void codegen_declare_function_symbol(CodegenContext *ctx, Symbol *sym)
 {
     if (!ctx || !sym)
@@ -536,34 +1395,9 @@ static void codegen_declare_function_symbol(CodegenContext *ctx, Symbol *sym)
     if (!func_type || func_type->kind != TYPE_FUNCTION)
         return;
 
-    LLVMTypeRef return_type = func_type->function.return_type ? codegen_get_llvm_type(ctx, func_type->function.return_type) : LLVMVoidTypeInContext(ctx->context);
-
-    bool   uses_mach_varargs = sym->func.uses_mach_varargs;
-    size_t fixed_params      = func_type->function.param_count;
-    size_t llvm_param_count  = fixed_params + (uses_mach_varargs ? 2 : 0);
-
-    LLVMTypeRef *param_types = NULL;
-    if (llvm_param_count > 0)
-    {
-        param_types = malloc(sizeof(LLVMTypeRef) * llvm_param_count);
-        if (!param_types)
-            return;
-
-        for (size_t i = 0; i < fixed_params; i++)
-        {
-            param_types[i] = codegen_get_llvm_type(ctx, func_type->function.param_types[i]);
-        }
-
-        if (uses_mach_varargs)
-        {
-            LLVMTypeRef i64ty             = LLVMInt64TypeInContext(ctx->context);
-            LLVMTypeRef i8_ptr            = LLVMPointerTypeInContext(ctx->context, 0);
-            param_types[fixed_params]     = i64ty;
-            param_types[fixed_params + 1] = LLVMPointerType(i8_ptr, 0);
-        }
-    }
-
-    LLVMTypeRef llvm_func_type = LLVMFunctionType(return_type, param_types, llvm_param_count, uses_mach_varargs ? false : func_type->function.is_variadic);
+    LLVMTypeRef llvm_func_type = codegen_function_llvm_type(ctx, func_type, sym->func.uses_mach_varargs);
+    if (!llvm_func_type)
+        return;
 
     const char *llvm_name = NULL;
     if (sym->func.mangled_name && sym->func.mangled_name[0])
@@ -581,11 +1415,33 @@ static void codegen_declare_function_symbol(CodegenContext *ctx, Symbol *sym)
             func = LLVMAddFunction(ctx->module, llvm_name, llvm_func_type);
     }
 
-    if (param_types)
-        free(param_types);
-
     if (func)
+    {
+        codegen_mark_sret_param(ctx, func, func_type);
+        codegen_apply_function_hints(ctx, func, &sym->func.hints);
+        codegen_apply_function_effects(ctx, func, sym, func_type);
         codegen_set_symbol_value(ctx, sym, func);
+    }
+}
+
+// true for functions and globals the reachability pass found no path to from the program roots
+static bool codegen_is_pruned(CodegenContext *ctx, Symbol *sym)
+{
+    if (!ctx->prune_unreachable || !sym)
+        return false;
+
+    while (sym->import_origin && sym->import_origin != sym)
+        sym = sym->import_origin;
+
+    if (sym->kind == SYMBOL_FUNC)
+    {
+        if (sym->func.is_generic && !sym->func.is_specialized_instance)
+            return false;
+        return !sym->is_reachable;
+    }
+    if (sym->kind == SYMBOL_VAR || sym->kind == SYMBOL_VAL)
+        return sym->var.is_global && !sym->is_reachable;
+    return false;
 }
 
 static void codegen_declare_functions_in_scope(CodegenContext *ctx, Scope *scope)
@@ -595,7 +1451,8 @@ static void codegen_declare_functions_in_scope(CodegenContext *ctx, Scope *scope
 
     for (Symbol *sym = scope->symbols; sym; sym = sym->next)
     {
-        codegen_declare_function_symbol(ctx, sym);
+        if (!codegen_is_pruned(ctx, sym))
+            codegen_declare_function_symbol(ctx, sym);
     }
 }
 
@@ -607,6 +1464,9 @@ static void codegen_generate_specialized_function(Symbol *sym, void *user_data)
     if (sym->kind != SYMBOL_FUNC || !sym->func.is_specialized_instance || !sym->func.is_defined || !sym->decl)
         return;
 
+    if (codegen_is_pruned(ctx, sym))
+        return;
+
     // check if the function already exists in the LLVM module by name
     // (multiple Symbol objects may exist for the same specialized function)
     const char  *func_name          = sym->func.mangled_name ? sym->func.mangled_name : sym->name;
@@ -643,7 +1503,177 @@ static void codegen_generate_specialized_functions_in_scope(CodegenContext *ctx,
     }
 }
 
-void codegen_context_init(CodegenContext *ctx, const char *module_name, bool no_pie)
+// check whether a value is reachable from a linkonce_odr body (specializations are emitted into every module)
+static bool codegen_value_used_by_linkonce(LLVMValueRef value)
+{
+    for (LLVMUseRef use = LLVMGetFirstUse(value); use; use = LLVMGetNextUse(use))
+    {
+        LLVMValueRef user = LLVMGetUser(use);
+        if (LLVMIsAInstruction(user))
+        {
+            LLVMValueRef parent = LLVMGetBasicBlockParent(LLVMGetInstructionParent(user));
+            if (parent && LLVMGetLinkage(parent) == LLVMLinkOnceODRLinkage)
+                return true;
+        }
+        else if (!LLVMIsAGlobalValue(user) && codegen_value_used_by_linkonce(user))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// check whether every use of a function is a direct call to it
+static bool codegen_function_address_escapes(LLVMValueRef func)
+{
+    for (LLVMUseRef use = LLVMGetFirstUse(func); use; use = LLVMGetNextUse(use))
+    {
+        LLVMValueRef user = LLVMGetUser(use);
+        if (!LLVMIsACallInst(user) || LLVMGetCalledValue(user) != func)
+            return true;
+
+        unsigned arg_count = LLVMGetNumArgOperands(user);
+        for (unsigned i = 0; i < arg_count; i++)
+        {
+            if (LLVMGetOperand(user, i) == func)
+                return true;
+        }
+    }
+    return false;
+}
+
+// give non-public module-level definitions internal linkage, and fastcc where possible
+static void codegen_internalize_symbols(CodegenContext *ctx, AstNode *root)
+{
+    // the same roots dead declaration elimination keeps: asm may name any symbol, and main is the entry point
+    bool has_asm = ast_program_has_asm(root);
+    if (has_asm)
+        return;
+
+    for (int i = 0; i < root->program.stmts->count; i++)
+    {
+        AstNode *stmt = root->program.stmts->items[i];
+        Symbol  *sym  = stmt->symbol;
+        if (!sym || sym->is_public || sym->is_imported)
+            continue;
+        if (ast_stmt_is_link_root(stmt, has_asm, ctx->is_entry_module))
+            continue;
+
+        if (stmt->kind == AST_STMT_FUN)
+        {
+            // methods are reachable through any visible receiver type; #@symbol names are part of the abi
+            if (sym->kind != SYMBOL_FUNC || sym->func.is_generic || sym->func.is_method || sym->func.is_specialized_instance || !sym->func.is_defined || sym->func.extern_name)
+                continue;
+
+            LLVMValueRef func = codegen_get_symbol_value(ctx, sym);
+            if (!func || LLVMIsDeclaration(func) || LLVMGetLinkage(func) != LLVMExternalLinkage)
+                continue;
+            if (codegen_value_used_by_linkonce(func))
+                continue;
+
+            LLVMSetLinkage(func, LLVMInternalLinkage);
+            ctx->internalized_count++;
+
+            if (LLVMIsFunctionVarArg(LLVMGlobalGetValueType(func)) || codegen_function_address_escapes(func))
+                continue;
+
+            LLVMSetFunctionCallConv(func, LLVMFastCallConv);
+            for (LLVMUseRef use = LLVMGetFirstUse(func); use; use = LLVMGetNextUse(use))
+                LLVMSetInstructionCallConv(LLVMGetUser(use), LLVMFastCallConv);
+        }
+        else if (stmt->kind == AST_STMT_VAR || stmt->kind == AST_STMT_VAL)
+        {
+            LLVMValueRef global = codegen_get_symbol_value(ctx, sym);
+            if (!global || !LLVMIsAGlobalVariable(global) || LLVMGetLinkage(global) != LLVMExternalLinkage)
+                continue;
+            if (codegen_value_used_by_linkonce(global))
+                continue;
+
+            LLVMSetLinkage(global, LLVMInternalLinkage);
+            ctx->internalized_count++;
+        }
+    }
+}
+
+void codegen_pipeline_init(CodegenPipeline *pipeline)
+{
+    pipeline->size_level       = 0;
+    pipeline->passes           = NULL;
+    pipeline->loop_vectorize   = -1;
+    pipeline->slp_vectorize    = -1;
+    pipeline->loop_unroll      = -1;
+    pipeline->inline_threshold = -1;
+    pipeline->profile_generate = false;
+    pipeline->profile_use      = NULL;
+}
+
+// the inliner threshold and profile path are only reachable through llvm's global options, so set them once per process
+static void codegen_apply_llvm_options(const CodegenPipeline *pipeline)
+{
+    static bool applied = false;
+    if (applied)
+        return;
+    applied = true;
+
+    const char *argv[3];
+    int         argc = 0;
+    argv[argc++]     = "cmach";
+
+    char threshold[48];
+    if (pipeline->inline_threshold >= 0)
+    {
+        snprintf(threshold, sizeof(threshold), "-inline-threshold=%d", pipeline->inline_threshold);
+        argv[argc++] = threshold;
+    }
+
+    // the c pass builder api has no pgo options; -pgo-test-profile-file is llvm's internal testing hook
+    // that pgo-instr-use reads its profile path from, so this depends on it staying available
+    char *profile = NULL;
+    if (pipeline->profile_use)
+    {
+        size_t len = strlen("-pgo-test-profile-file=") + strlen(pipeline->profile_use) + 1;
+        profile    = malloc(len);
+        if (profile)
+        {
+            snprintf(profile, len, "-pgo-test-profile-file=%s", pipeline->profile_use);
+            argv[argc++] = profile;
+        }
+    }
+
+    if (argc > 1)
+        LLVMParseCommandLineOptions(argc, argv, NULL);
+    free(profile);
+}
+
+// define mach_profile_write() so the runtime can flush profile counters at exit (no-op unless instrumented)
+static void codegen_emit_profile_hook(CodegenContext *ctx)
+{
+    LLVMTypeRef  void_fn = LLVMFunctionType(LLVMVoidTypeInContext(ctx->context), NULL, 0, false);
+    LLVMValueRef hook    = LLVMGetNamedFunction(ctx->module, "mach_profile_write");
+    if (hook)
+        return;
+
+    hook = LLVMAddFunction(ctx->module, "mach_profile_write", void_fn);
+    LLVMSetLinkage(hook, LLVMWeakAnyLinkage);
+
+    LLVMBuilderRef    builder = LLVMCreateBuilderInContext(ctx->context);
+    LLVMBasicBlockRef entry   = LLVMAppendBasicBlockInContext(ctx->context, hook, "entry");
+    LLVMPositionBuilderAtEnd(builder, entry);
+
+    if (ctx->pipeline.profile_generate)
+    {
+        LLVMTypeRef  write_ty = LLVMFunctionType(LLVMInt32TypeInContext(ctx->context), NULL, 0, false);
+        LLVMValueRef write_fn = LLVMGetNamedFunction(ctx->module, "__llvm_profile_write_file");
+        if (!write_fn)
+            write_fn = LLVMAddFunction(ctx->module, "__llvm_profile_write_file", write_ty);
+        LLVMBuildCall2(builder, write_ty, write_fn, NULL, 0, "");
+    }
+
+    LLVMBuildRetVoid(builder);
+    LLVMDisposeBuilder(builder);
+}
+
+void codegen_context_init(CodegenContext *ctx, const char *module_name, const char *triple, const char *cpu, const char *features, bool no_pie)
 {
     ctx->context = LLVMContextCreate();
 
@@ -674,39 +1704,54 @@ void codegen_context_init(CodegenContext *ctx, const char *module_name, bool no_
     LLVMInitializeAllAsmParsers();
     LLVMInitializeAllAsmPrinters();
 
+    // unspecified target parameters fall back to the host
+    char *host_triple   = triple ? NULL : LLVMGetDefaultTargetTriple();
+    char *host_cpu      = cpu ? NULL : LLVMGetHostCPUName();
+    char *host_features = features ? NULL : LLVMGetHostCPUFeatures();
+    if (!triple)
+        triple = host_triple;
+    if (!cpu)
+        cpu = host_cpu;
+    if (!features)
+        features = host_features;
+
     char         *error = NULL;
     LLVMTargetRef target;
-    if (LLVMGetTargetFromTriple(LLVMGetDefaultTargetTriple(), &target, &error) != 0)
+    if (LLVMGetTargetFromTriple(triple, &target, &error) != 0)
     {
         fprintf(stderr, "error: failed to get target: %s\n", error);
         LLVMDisposeMessage(error);
         exit(EXIT_FAILURE);
     }
 
-    ctx->target_machine = LLVMCreateTargetMachine(target, LLVMGetDefaultTargetTriple(), LLVMGetHostCPUName(), LLVMGetHostCPUFeatures(), LLVMCodeGenLevelDefault, ctx->no_pie ? LLVMRelocStatic : LLVMRelocPIC, LLVMCodeModelDefault);
+    ctx->target_machine = LLVMCreateTargetMachine(target, triple, cpu, features, LLVMCodeGenLevelDefault, ctx->no_pie ? LLVMRelocStatic : LLVMRelocPIC, LLVMCodeModelDefault);
 
     ctx->data_layout = LLVMCreateTargetDataLayout(ctx->target_machine);
     LLVMSetModuleDataLayout(ctx->module, ctx->data_layout);
-    LLVMSetTarget(ctx->module, LLVMGetDefaultTargetTriple());
+    LLVMSetTarget(ctx->module, triple);
 
-    ctx->spec_cache = NULL;
+    if (host_triple)
+        LLVMDisposeMessage(host_triple);
+    if (host_cpu)
+        LLVMDisposeMessage(host_cpu);
+    if (host_features)
+        LLVMDisposeMessage(host_features);
 
-    // initialize maps
-    ctx->symbol_map.symbols  = NULL;
-    ctx->symbol_map.values   = NULL;
-    ctx->symbol_map.count    = 0;
-    ctx->symbol_map.capacity = 0;
+    ctx->spec_cache = NULL;
 
-    ctx->type_cache.types      = NULL;
-    ctx->type_cache.llvm_types = NULL;
-    ctx->type_cache.count      = 0;
-    ctx->type_cache.capacity   = 0;
+    // initialize query table
+    query_table_init(&ctx->queries);
 
     ctx->current_function        = NULL;
     ctx->current_function_type   = NULL;
     ctx->break_block             = NULL;
     ctx->continue_block          = NULL;
+    ctx->trap_block              = NULL;
+    ctx->current_sret            = NULL;
+    ctx->result_slot_expr        = NULL;
+    ctx->result_slot             = NULL;
     ctx->generating_mutable_init = false;
+    ctx->comptime_globals        = NULL;
     ctx->module_inline_asm       = NULL;
     ctx->module_inline_asm_len   = 0;
 
@@ -714,6 +1759,13 @@ void codegen_context_init(CodegenContext *ctx, const char *module_name, bool no_
     ctx->has_errors = false;
 
     ctx->opt_level             = 2;
+    codegen_pipeline_init(&ctx->pipeline);
+    ctx->verbose               = false;
+    ctx->internalized_count    = 0;
+    ctx->prune_unreachable     = false;
+    ctx->pruned_count          = 0;
+    ctx->emit_profile_hook     = false;
+    ctx->is_entry_module       = false;
     ctx->debug_info            = false;
     ctx->debug_finalized       = false;
     ctx->di_builder            = NULL;
@@ -727,7 +1779,8 @@ void codegen_context_init(CodegenContext *ctx, const char *module_name, bool no_
     ctx->di_unknown_type       = NULL;
 
     ctx->current_vararg_count_value = NULL;
-    ctx->current_vararg_array       = NULL;
+    ctx->current_vararg_data        = NULL;
+    ctx->current_vararg_desc        = NULL;
     ctx->current_fixed_param_count  = 0;
     ctx->source_file                = NULL;
     ctx->source_lexer               = NULL;
@@ -746,10 +1799,7 @@ void codegen_context_dnit(CodegenContext *ctx)
     }
 
     // clean up maps
-    free(ctx->symbol_map.symbols);
-    free(ctx->symbol_map.values);
-    free(ctx->type_cache.types);
-    free(ctx->type_cache.llvm_types);
+    query_table_dnit(&ctx->queries);
 
     if (ctx->di_builder)
     {
@@ -793,6 +1843,11 @@ bool codegen_generate(CodegenContext *ctx, AstNode *root, SymbolTable *symbols)
     for (int i = 0; i < root->program.stmts->count; i++)
     {
         AstNode *stmt = root->program.stmts->items[i];
+        if ((stmt->kind == AST_STMT_FUN || stmt->kind == AST_STMT_VAL || stmt->kind == AST_STMT_VAR) && codegen_is_pruned(ctx, stmt->symbol))
+        {
+            ctx->pruned_count++;
+            continue;
+        }
         codegen_stmt(ctx, stmt);
     }
 
@@ -812,6 +1867,24 @@ bool codegen_generate(CodegenContext *ctx, AstNode *root, SymbolTable *symbols)
         specialization_cache_foreach(ctx->spec_cache, codegen_generate_specialized_function, ctx);
     }
 
+    if (ctx->emit_profile_hook)
+        codegen_emit_profile_hook(ctx);
+
+    // internalize non-public definitions now that every reference has been emitted
+    if (!ctx->has_errors)
+    {
+        codegen_internalize_symbols(ctx, root);
+        if (ctx->verbose)
+        {
+            size_t      id_len = 0;
+            const char *id     = LLVMGetModuleIdentifier(ctx->module, &id_len);
+            fprintf(stderr, "note: %.*s: internalized %d symbol(s)\n", (int)id_len, id, ctx->internalized_count);
+            if (ctx->prune_unreachable)
+                fprintf(stderr, "note: %.*s: skipped %d unreachable declaration(s)\n", (int)id_len, id, ctx->pruned_count);
+            fprintf(stderr, "note: %.*s: %llu query hit(s), %llu miss(es)\n", (int)id_len, id, (unsigned long long)ctx->queries.hits, (unsigned long long)ctx->queries.misses);
+        }
+    }
+
     if (ctx->debug_info)
         codegen_debug_finalize(ctx);
 
@@ -836,14 +1909,44 @@ bool codegen_generate(CodegenContext *ctx, AstNode *root, SymbolTable *symbols)
     }
 
     // run optimization passes
-    if (ctx->opt_level > 0 && !ctx->has_errors)
+    const CodegenPipeline *pipeline = &ctx->pipeline;
+    bool                   uses_pgo = pipeline->profile_generate || pipeline->profile_use;
+    if ((ctx->opt_level > 0 || pipeline->passes || uses_pgo) && !ctx->has_errors)
     {
         LLVMPassBuilderOptionsRef options = LLVMCreatePassBuilderOptions();
+        if (pipeline->loop_vectorize >= 0)
+            LLVMPassBuilderOptionsSetLoopVectorization(options, pipeline->loop_vectorize);
+        if (pipeline->slp_vectorize >= 0)
+            LLVMPassBuilderOptionsSetSLPVectorization(options, pipeline->slp_vectorize);
+        if (pipeline->loop_unroll >= 0)
+            LLVMPassBuilderOptionsSetLoopUnrolling(options, pipeline->loop_unroll);
+        codegen_apply_llvm_options(pipeline);
 
         char opt_str[16];
-        snprintf(opt_str, sizeof(opt_str), "default<O%d>", ctx->opt_level);
+        if (pipeline->size_level > 0)
+            snprintf(opt_str, sizeof(opt_str), "default<O%c>", pipeline->size_level > 1 ? 'z' : 's');
+        else
+            snprintf(opt_str, sizeof(opt_str), "default<O%d>", ctx->opt_level);
+
+        const char *base = pipeline->passes && pipeline->passes[0] ? pipeline->passes : opt_str;
+        if (!pipeline->passes && ctx->opt_level == 0)
+            base = "";
 
-        LLVMRunPasses(ctx->module, opt_str, ctx->target_machine, options);
+        // pgo runs first so instrumentation and profile use see the same unoptimized cfg
+        const char *pgo    = pipeline->profile_generate ? "pgo-instr-gen,instrprof" : (pipeline->profile_use ? "pgo-instr-use" : "");
+        size_t      len    = strlen(pgo) + 1 + strlen(base) + 1;
+        char       *passes = malloc(len);
+        snprintf(passes, len, "%s%s%s", pgo, (pgo[0] && base[0]) ? "," : "", base);
+
+        LLVMErrorRef err = LLVMRunPasses(ctx->module, passes, ctx->target_machine, options);
+        if (err)
+        {
+            char *message = LLVMGetErrorMessage(err);
+            fprintf(stderr, "error: failed to run pass pipeline '%s': %s\n", passes, message);
+            LLVMDisposeErrorMessage(message);
+            ctx->has_errors = true;
+        }
+        free(passes);
         LLVMDisposePassBuilderOptions(options);
     }
 
@@ -935,48 +2038,9 @@ void codegen_print_errors(CodegenContext *ctx)
     }
 }
 
-LLVMTypeRef codegen_get_llvm_type(CodegenContext *ctx, Type *type)
+// lower one mach type; nested types go back through the memoized codegen_get_llvm_type
+static LLVMTypeRef codegen_lower_type(CodegenContext *ctx, Type *type)
 {
-    if (!type)
-        return NULL;
-
-    // check cache
-    LLVMTypeRef reused_llvm = NULL;
-    for (int i = 0; i < ctx->type_cache.count; i++)
-    {
-        if (ctx->type_cache.types[i] == type)
-        {
-            return ctx->type_cache.llvm_types[i];
-        }
-
-        // reuse struct/union types by name even if Type instances differ
-        if (!reused_llvm)
-        {
-            Type *cached_type = ctx->type_cache.types[i];
-            if (type->name && cached_type && cached_type->name && type->kind == cached_type->kind && (type->kind == TYPE_STRUCT || type->kind == TYPE_UNION) && strcmp(type->name, cached_type->name) == 0)
-            {
-                reused_llvm = ctx->type_cache.llvm_types[i];
-            }
-        }
-    }
-
-    // if we found a reusable type, cache this Type pointer and return
-    if (reused_llvm)
-    {
-        if (ctx->type_cache.count >= ctx->type_cache.capacity)
-        {
-            ctx->type_cache.capacity   = ctx->type_cache.capacity ? ctx->type_cache.capacity * 2 : 16;
-            ctx->type_cache.types      = realloc(ctx->type_cache.types, sizeof(Type *) * ctx->type_cache.capacity);
-            ctx->type_cache.llvm_types = realloc(ctx->type_cache.llvm_types, sizeof(LLVMTypeRef) * ctx->type_cache.capacity);
-        }
-
-        ctx->type_cache.types[ctx->type_cache.count]      = type;
-        ctx->type_cache.llvm_types[ctx->type_cache.count] = reused_llvm;
-        ctx->type_cache.count++;
-
-        return reused_llvm;
-    }
-
     LLVMTypeRef llvm_type = NULL;
 
     switch (type->kind)
@@ -1039,6 +2103,9 @@ LLVMTypeRef codegen_get_llvm_type(CodegenContext *ctx, Type *type)
         }
     }
     break;
+    case TYPE_VECTOR:
+        llvm_type = LLVMVectorType(codegen_get_llvm_type(ctx, type->vector.elem_type), (unsigned)type->vector.count);
+        break;
     case TYPE_STRUCT:
     {
         // create opaque struct type first
@@ -1102,59 +2169,53 @@ LLVMTypeRef codegen_get_llvm_type(CodegenContext *ctx, Type *type)
         break;
     }
 
-    // cache the result
-    if (llvm_type)
+    return llvm_type;
+}
+
+LLVMTypeRef codegen_get_llvm_type(CodegenContext *ctx, Type *type)
+{
+    if (!type)
+        return NULL;
+
+    void *cached = NULL;
+    if (query_lookup(&ctx->queries, QUERY_LLVM_TYPE, type, &cached))
+        return cached;
+
+    query_begin(&ctx->queries, QUERY_LLVM_TYPE, type);
+
+    // struct/union types are shared by name even if Type instances differ
+    LLVMTypeRef llvm_type = NULL;
+    if (type->name && (type->kind == TYPE_STRUCT || type->kind == TYPE_UNION))
     {
-        if (ctx->type_cache.count >= ctx->type_cache.capacity)
+        if (query_lookup(&ctx->queries, QUERY_LLVM_NAMED_TYPE, type->name, &cached))
         {
-            ctx->type_cache.capacity   = ctx->type_cache.capacity ? ctx->type_cache.capacity * 2 : 16;
-            ctx->type_cache.types      = realloc(ctx->type_cache.types, sizeof(Type *) * ctx->type_cache.capacity);
-            ctx->type_cache.llvm_types = realloc(ctx->type_cache.llvm_types, sizeof(LLVMTypeRef) * ctx->type_cache.capacity);
+            llvm_type = cached;
         }
-
-        ctx->type_cache.types[ctx->type_cache.count]      = type;
-        ctx->type_cache.llvm_types[ctx->type_cache.count] = llvm_type;
-        ctx->type_cache.count++;
+        else
+        {
+            query_begin(&ctx->queries, QUERY_LLVM_NAMED_TYPE, type->name);
+            llvm_type = codegen_lower_type(ctx, type);
+            query_end(&ctx->queries, llvm_type);
+        }
+    }
+    else
+    {
+        llvm_type = codegen_lower_type(ctx, type);
     }
 
+    query_end(&ctx->queries, llvm_type);
     return llvm_type;
 }
 
 LLVMValueRef codegen_get_symbol_value(CodegenContext *ctx, Symbol *symbol)
 {
-    for (int i = 0; i < ctx->symbol_map.count; i++)
-    {
-        if (ctx->symbol_map.symbols[i] == symbol)
-        {
-            return ctx->symbol_map.values[i];
-        }
-    }
-    return NULL;
+    void *value = NULL;
+    return query_lookup(&ctx->queries, QUERY_SYMBOL_VALUE, symbol, &value) ? value : NULL;
 }
 
 void codegen_set_symbol_value(CodegenContext *ctx, Symbol *symbol, LLVMValueRef value)
 {
-    // check if already exists
-    for (int i = 0; i < ctx->symbol_map.count; i++)
-    {
-        if (ctx->symbol_map.symbols[i] == symbol)
-        {
-            ctx->symbol_map.values[i] = value;
-            return;
-        }
-    }
-
-    // add new mapping
-    if (ctx->symbol_map.count >= ctx->symbol_map.capacity)
-    {
-        ctx->symbol_map.capacity = ctx->symbol_map.capacity ? ctx->symbol_map.capacity * 2 : 16;
-        ctx->symbol_map.symbols  = realloc(ctx->symbol_map.symbols, sizeof(Symbol *) * ctx->symbol_map.capacity);
-        ctx->symbol_map.values   = realloc(ctx->symbol_map.values, sizeof(LLVMValueRef) * ctx->symbol_map.capacity);
-    }
-
-    ctx->symbol_map.symbols[ctx->symbol_map.count] = symbol;
-    ctx->symbol_map.values[ctx->symbol_map.count]  = value;
-    ctx->symbol_map.count++;
+    query_store(&ctx->queries, QUERY_SYMBOL_VALUE, symbol, value);
 }
 
 LLVMValueRef codegen_stmt(CodegenContext *ctx, AstNode *stmt)
@@ -1312,35 +2373,17 @@ LLVMValueRef codegen_stmt_ext(CodegenContext *ctx, AstNode *stmt)
         return func;
     }
 
-    // create LLVM function type
-    LLVMTypeRef return_type = func_type->function.return_type ? codegen_get_llvm_type(ctx, func_type->function.return_type) : LLVMVoidTypeInContext(ctx->context);
-
-    LLVMTypeRef *param_types       = NULL;
-    bool         uses_mach_varargs = stmt->symbol && stmt->symbol->func.uses_mach_varargs;
-    size_t       fixed_params      = func_type->function.param_count;
-    size_t       llvm_param_count  = fixed_params + (uses_mach_varargs ? 2 : 0);
-    if (llvm_param_count > 0)
+    // create LLVM function type; large results use sret, which matches the c abi for memory-class returns
+    LLVMTypeRef llvm_func_type = codegen_function_llvm_type(ctx, func_type, stmt->symbol && stmt->symbol->func.uses_mach_varargs);
+    if (!llvm_func_type)
     {
-        param_types = malloc(sizeof(LLVMTypeRef) * llvm_param_count);
-        for (size_t i = 0; i < fixed_params; i++)
-        {
-            param_types[i] = codegen_get_llvm_type(ctx, func_type->function.param_types[i]);
-        }
-        if (uses_mach_varargs)
-        {
-            LLVMTypeRef i64ty             = LLVMInt64TypeInContext(ctx->context);
-            LLVMTypeRef i8_ptr            = LLVMPointerTypeInContext(ctx->context, 0);
-            param_types[fixed_params]     = i64ty;
-            param_types[fixed_params + 1] = LLVMPointerType(i8_ptr, 0);
-        }
+        codegen_error(ctx, stmt, "failed to build type for external function '%s'", symbol_name);
+        return NULL;
     }
 
-    LLVMTypeRef llvm_func_type = LLVMFunctionType(return_type, param_types, llvm_param_count, uses_mach_varargs ? false : func_type->function.is_variadic);
-
     // create function declaration with target symbol name
     func = LLVMAddFunction(ctx->module, symbol_name, llvm_func_type);
-
-    free(param_types);
+    codegen_mark_sret_param(ctx, func, func_type);
 
     // add to symbol map
     codegen_set_symbol_value(ctx, stmt->symbol, func);
@@ -1363,6 +2406,96 @@ LLVMValueRef codegen_stmt_block(CodegenContext *ctx, AstNode *stmt)
     return last;
 }
 
+// aggregates above this size are copied and cleared with llvm.memcpy/llvm.memset instead of
+// first-class loads and stores, which llvm splits into one move per field
+#define CODEGEN_MEMCPY_MIN_SIZE 16
+
+static bool codegen_is_large_aggregate(Type *type)
+{
+    type = type_resolve_alias(type);
+    if (!type)
+        return false;
+
+    bool is_aggregate = type->kind == TYPE_STRUCT || type->kind == TYPE_UNION || (type->kind == TYPE_ARRAY && !type->array.is_slice);
+    return is_aggregate && type_sizeof(type) > CODEGEN_MEMCPY_MIN_SIZE;
+}
+
+static void codegen_store_zero(CodegenContext *ctx, LLVMValueRef dst, Type *type, LLVMTypeRef llvm_type)
+{
+    if (codegen_is_large_aggregate(type))
+    {
+        LLVMValueRef zero = LLVMConstInt(LLVMInt8TypeInContext(ctx->context), 0, false);
+        LLVMValueRef size = LLVMConstInt(LLVMInt64TypeInContext(ctx->context), type_sizeof(type), false);
+        LLVMBuildMemSet(ctx->builder, dst, zero, size, (unsigned)type_alignof(type));
+        return;
+    }
+
+    LLVMBuildStore(ctx->builder, LLVMConstNull(llvm_type), dst);
+}
+
+// copy a large aggregate that lives in memory; returns false when the caller must load and store
+static bool codegen_copy_aggregate(CodegenContext *ctx, LLVMValueRef dst, LLVMValueRef src, Type *type)
+{
+    if (!codegen_is_large_aggregate(type))
+        return false;
+
+    if (!LLVMIsAAllocaInst(src) && !LLVMIsAGlobalVariable(src) && !LLVMIsAGetElementPtrInst(src))
+        return false;
+
+    unsigned     align = (unsigned)type_alignof(type_resolve_alias(type));
+    LLVMValueRef size  = LLVMConstInt(LLVMInt64TypeInContext(ctx->context), type_sizeof(type_resolve_alias(type)), false);
+    LLVMBuildMemCpy(ctx->builder, dst, align, src, align, size);
+    return true;
+}
+
+// struct literals and sret calls can construct their value directly in a destination of the same type
+static bool codegen_builds_in_place(AstNode *expr, Type *type)
+{
+    Type *resolved  = type_resolve_alias(type);
+    Type *expr_type = type_resolve_alias(expr->type);
+    if (!resolved || !expr_type || !type_equals(expr_type, resolved) || type_sizeof(expr_type) != type_sizeof(resolved))
+        return false;
+
+    if (expr->kind == AST_EXPR_STRUCT)
+        return resolved->kind == TYPE_STRUCT || resolved->kind == TYPE_UNION;
+    return expr->kind == AST_EXPR_CALL && codegen_is_large_aggregate(resolved);
+}
+
+// hand the pending destination to the expression it was reserved for; nested expressions never match
+static LLVMValueRef codegen_take_result_slot(CodegenContext *ctx, AstNode *expr)
+{
+    if (!ctx->result_slot || ctx->result_slot_expr != expr)
+        return NULL;
+
+    LLVMValueRef slot     = ctx->result_slot;
+    ctx->result_slot      = NULL;
+    ctx->result_slot_expr = NULL;
+    return slot;
+}
+
+// evaluate expr and store it to dst, building it in place when possible instead of through a temporary
+static LLVMValueRef codegen_expr_into(CodegenContext *ctx, AstNode *expr, LLVMValueRef dst, Type *type)
+{
+    if (codegen_builds_in_place(expr, type))
+    {
+        ctx->result_slot_expr = expr;
+        ctx->result_slot      = dst;
+    }
+
+    LLVMValueRef value    = codegen_expr(ctx, expr);
+    ctx->result_slot_expr = NULL;
+    ctx->result_slot      = NULL;
+    if (!value || value == dst)
+        return value;
+
+    if (codegen_copy_aggregate(ctx, dst, value, type))
+        return value;
+
+    value = codegen_load_rvalue(ctx, value, expr->type, expr);
+    LLVMBuildStore(ctx->builder, value, dst);
+    return value;
+}
+
 LLVMValueRef codegen_stmt_var(CodegenContext *ctx, AstNode *stmt)
 {
     if (!stmt->symbol || !stmt->type)
@@ -1395,77 +2528,31 @@ LLVMValueRef codegen_stmt_var(CodegenContext *ctx, AstNode *stmt)
         {
             LLVMSetGlobalConstant(global, false);
         }
-        // initializer
+        // definitions live in the executable's own tls block
+        if (stmt->var_stmt.is_thread_local)
+        {
+            LLVMSetThreadLocalMode(global, LLVMLocalExecTLSModel);
+        }
+        // initializer: folded at compile time, so vals land in .rodata and vars in .data
         if (stmt->var_stmt.init)
         {
-            // handle constants specially without emitting instructions
-            AstNode     *init       = stmt->var_stmt.init;
-            LLVMValueRef const_init = NULL;
-            if (init->kind == AST_EXPR_LIT)
-            {
-                switch (init->lit_expr.kind)
-                {
-                case TOKEN_LIT_INT:
-                {
-                    const_init = LLVMConstInt(llvm_type, init->lit_expr.int_val, type_is_signed(stmt->type));
-                    break;
-                }
-                case TOKEN_LIT_FLOAT:
-                {
-                    const_init = LLVMConstReal(llvm_type, init->lit_expr.float_val);
-                    break;
-                }
-                case TOKEN_LIT_CHAR:
-                {
-                    const_init = LLVMConstInt(llvm_type, init->lit_expr.char_val, false);
-                    break;
-                }
-                case TOKEN_LIT_STRING:
-                {
-                    // build fat pointer constant: { i8* data, i64 len }
-                    if (type_resolve_alias(stmt->type)->kind == TYPE_ARRAY)
-                    {
-                        size_t      len    = strlen(init->lit_expr.string_val);
-                        LLVMTypeRef arr_ty = LLVMArrayType(LLVMInt8TypeInContext(ctx->context), (unsigned)len);
-                        char        gbuf[128];
-                        snprintf(gbuf, sizeof(gbuf), "%s.str", gname);
-                        LLVMValueRef data_g = LLVMGetNamedGlobal(ctx->module, gbuf);
-                        if (!data_g)
-                        {
-                            data_g = LLVMAddGlobal(ctx->module, arr_ty, gbuf);
-                            LLVMSetGlobalConstant(data_g, true);
-                            LLVMSetLinkage(data_g, LLVMPrivateLinkage);
-                            LLVMValueRef str_c = LLVMConstStringInContext(ctx->context, init->lit_expr.string_val, (unsigned)len, true);
-                            LLVMSetInitializer(data_g, str_c);
-                        }
-                        LLVMValueRef idxs[2]   = {LLVMConstInt(LLVMInt32TypeInContext(ctx->context), 0, false), LLVMConstInt(LLVMInt32TypeInContext(ctx->context), 0, false)};
-                        LLVMValueRef data_ptr  = LLVMConstGEP2(arr_ty, data_g, idxs, 2);
-                        data_ptr               = LLVMConstPointerCast(data_ptr, LLVMPointerTypeInContext(ctx->context, 0));
-                        LLVMValueRef fields[2] = {data_ptr, LLVMConstInt(LLVMInt64TypeInContext(ctx->context), len, false)};
-                        const_init             = LLVMConstStructInContext(ctx->context, fields, 2, false);
-                    }
-                    break;
-                }
-                default:
-                    break;
-                }
-            }
-            else
-            {
-                // try simple integer/boolean constant folding
-                int64_t folded = 0;
-                if (codegen_eval_const_i64(ctx, init, &folded))
-                {
-                    const_init = LLVMConstInt(llvm_type, (unsigned long long)folded, type_is_signed(stmt->type));
-                }
-            }
+            ComptimeValue *comptime         = stmt->var_stmt.comptime_value;
+            bool           old_mutable_init = ctx->generating_mutable_init;
+            ctx->generating_mutable_init    = !stmt->var_stmt.is_val;
+            LLVMValueRef const_init         = comptime ? codegen_const_comptime(ctx, comptime) : codegen_const_value(ctx, stmt->var_stmt.init, stmt->type);
+            ctx->generating_mutable_init    = old_mutable_init;
             if (!const_init)
             {
-                codegen_error(ctx, stmt, "global variable initializer must be constant");
+                codegen_error(ctx, stmt, comptime ? "compile-time result cannot be emitted as a constant" : "global variable initializer must be constant");
                 return NULL;
             }
             LLVMSetInitializer(global, const_init);
         }
+        else
+        {
+            // without an initializer the definition is zero-filled (.bss) rather than an external reference
+            LLVMSetInitializer(global, LLVMConstNull(llvm_type));
+        }
         codegen_set_symbol_value(ctx, stmt->symbol, global);
         return global;
     }
@@ -1475,30 +2562,54 @@ LLVMValueRef codegen_stmt_var(CodegenContext *ctx, AstNode *stmt)
         LLVMValueRef alloca = codegen_create_alloca(ctx, llvm_type, stmt->var_stmt.name);
         codegen_set_symbol_value(ctx, stmt->symbol, alloca);
 
-        // always initialize to zero first to avoid undef in SROA'd variables
-        LLVMValueRef zero_val = LLVMConstNull(llvm_type);
-        LLVMBuildStore(ctx->builder, zero_val, alloca);
+        // always initialize to zero first to avoid undef in SROA'd variables; values built
+        // in place write the whole slot themselves
+        AstNode       *init     = stmt->var_stmt.init;
+        ComptimeValue *comptime = stmt->var_stmt.comptime_value;
+        if (!init || (!comptime && !codegen_builds_in_place(init, stmt->type)))
+            codegen_store_zero(ctx, alloca, stmt->type, llvm_type);
 
-        if (stmt->var_stmt.init)
+        // evaluated at compile time: store the constant, copying large ones from a private global
+        if (comptime)
         {
             bool old_mutable_init        = ctx->generating_mutable_init;
             ctx->generating_mutable_init = !stmt->var_stmt.is_val;
-            LLVMValueRef init_value      = codegen_expr(ctx, stmt->var_stmt.init);
+            LLVMValueRef constant        = codegen_const_comptime(ctx, comptime);
             ctx->generating_mutable_init = old_mutable_init;
-            if (!init_value)
+            if (!constant)
             {
-                codegen_error(ctx, stmt, "failed to generate initializer");
+                codegen_error(ctx, stmt, "compile-time result cannot be emitted as a constant");
                 return NULL;
             }
-            if (stmt->var_stmt.init->kind == AST_EXPR_STRUCT)
+
+            if (!codegen_is_large_aggregate(stmt->type))
             {
-                LLVMValueRef loaded_struct = LLVMBuildLoad2(ctx->builder, llvm_type, init_value, "");
-                LLVMBuildStore(ctx->builder, loaded_struct, alloca);
+                LLVMBuildStore(ctx->builder, constant, alloca);
+                return alloca;
             }
-            else
+
+            Type        *resolved = type_resolve_alias(stmt->type);
+            unsigned     align    = (unsigned)type_alignof(resolved);
+            LLVMValueRef source   = LLVMAddGlobal(ctx->module, llvm_type, "comptime");
+            LLVMSetInitializer(source, constant);
+            LLVMSetGlobalConstant(source, true);
+            LLVMSetLinkage(source, LLVMPrivateLinkage);
+            LLVMSetUnnamedAddress(source, LLVMGlobalUnnamedAddr);
+            LLVMSetAlignment(source, align);
+            LLVMBuildMemCpy(ctx->builder, alloca, align, source, align, LLVMConstInt(LLVMInt64TypeInContext(ctx->context), type_sizeof(resolved), false));
+            return alloca;
+        }
+
+        if (init)
+        {
+            bool old_mutable_init        = ctx->generating_mutable_init;
+            ctx->generating_mutable_init = !stmt->var_stmt.is_val;
+            LLVMValueRef init_value      = codegen_expr_into(ctx, init, alloca, stmt->type);
+            ctx->generating_mutable_init = old_mutable_init;
+            if (!init_value)
             {
-                init_value = codegen_load_rvalue(ctx, init_value, stmt->var_stmt.init->type, stmt->var_stmt.init);
-                LLVMBuildStore(ctx->builder, init_value, alloca);
+                codegen_error(ctx, stmt, "failed to generate initializer");
+                return NULL;
             }
         }
         return alloca;
@@ -1535,43 +2646,27 @@ LLVMValueRef codegen_stmt_fun(CodegenContext *ctx, AstNode *stmt)
     else
         func_name = stmt->fun_stmt.name;
 
-    Type       *func_type         = stmt->type;
-    bool        uses_mach_varargs = stmt->symbol && stmt->symbol->func.uses_mach_varargs;
-    size_t      fixed_param_count = func_type->function.param_count;
-    size_t      llvm_param_count  = fixed_param_count + (uses_mach_varargs ? 2 : 0);
-    LLVMTypeRef return_type       = func_type->function.return_type ? codegen_get_llvm_type(ctx, func_type->function.return_type) : LLVMVoidTypeInContext(ctx->context);
-
-    LLVMTypeRef *param_types = NULL;
-    if (llvm_param_count > 0)
-    {
-        param_types = malloc(sizeof(LLVMTypeRef) * llvm_param_count);
-        for (size_t i = 0; i < fixed_param_count; i++)
-        {
-            param_types[i] = codegen_get_llvm_type(ctx, func_type->function.param_types[i]);
-        }
-        if (uses_mach_varargs)
-        {
-            LLVMTypeRef i64ty                  = LLVMInt64TypeInContext(ctx->context);
-            LLVMTypeRef i8_ptr                 = LLVMPointerTypeInContext(ctx->context, 0);
-            param_types[fixed_param_count]     = i64ty;                      // hidden count parameter
-            param_types[fixed_param_count + 1] = LLVMPointerType(i8_ptr, 0); // hidden i8** array pointer
-        }
-    }
+    Type  *func_type         = stmt->type;
+    bool   uses_mach_varargs = stmt->symbol && stmt->symbol->func.uses_mach_varargs;
+    bool   returns_sret      = codegen_returns_sret(func_type);
+    size_t first_fixed_param = returns_sret ? 1 : 0;
+    size_t fixed_param_count = func_type->function.param_count;
 
     if (!func_name || !func_name[0])
     {
-        free(param_types);
         codegen_error(ctx, stmt, "function has no resolvable name");
         return NULL;
     }
 
-    LLVMTypeRef  llvm_func_type = LLVMFunctionType(return_type, param_types, llvm_param_count, uses_mach_varargs ? false : func_type->function.is_variadic);
+    LLVMTypeRef  llvm_func_type = codegen_function_llvm_type(ctx, func_type, uses_mach_varargs);
     LLVMValueRef func           = LLVMGetNamedFunction(ctx->module, func_name);
     if (!func)
     {
         func = LLVMAddFunction(ctx->module, func_name, llvm_func_type);
     }
-    free(param_types);
+    codegen_mark_sret_param(ctx, func, func_type);
+    codegen_apply_function_hints(ctx, func, &stmt->fun_stmt.hints);
+    codegen_apply_function_effects(ctx, func, stmt->symbol, func_type);
 
     // set linkage for specialized generic instances
     // linkonce_odr = keep one definition, discard duplicates (like C++ templates)
@@ -1584,7 +2679,7 @@ LLVMValueRef codegen_stmt_fun(CodegenContext *ctx, AstNode *stmt)
     codegen_set_symbol_value(ctx, stmt->symbol, func);
 
     if (stmt->symbol && !stmt->symbol->func.mangled_name && func_name)
-        stmt->symbol->func.mangled_name = strdup(func_name);
+        stmt->symbol->func.mangled_name = symbol_system_strdup(func_name);
 
     // generate body if present
     if (stmt->fun_stmt.body)
@@ -1608,19 +2703,26 @@ LLVMValueRef codegen_stmt_fun(CodegenContext *ctx, AstNode *stmt)
             }
         }
 
-        LLVMValueRef prev_function           = ctx->current_function;
-        Type        *prev_ftype              = ctx->current_function_type;
-        LLVMValueRef prev_vararg_count_value = ctx->current_vararg_count_value;
-        LLVMValueRef prev_vararg_array       = ctx->current_vararg_array;
-        size_t       prev_fixed_param_count  = ctx->current_fixed_param_count;
-        ctx->current_function                = func;
-        ctx->current_function_type           = stmt->type;
+        LLVMValueRef      prev_function           = ctx->current_function;
+        Type             *prev_ftype              = ctx->current_function_type;
+        LLVMValueRef      prev_vararg_count_value = ctx->current_vararg_count_value;
+        LLVMValueRef      prev_vararg_data        = ctx->current_vararg_data;
+        LLVMValueRef      prev_vararg_desc        = ctx->current_vararg_desc;
+        size_t            prev_fixed_param_count  = ctx->current_fixed_param_count;
+        LLVMBasicBlockRef prev_trap_block         = ctx->trap_block;
+        LLVMValueRef      prev_sret               = ctx->current_sret;
+        ctx->current_function                     = func;
+        ctx->current_function_type                = stmt->type;
+        ctx->trap_block                           = NULL;
+        ctx->current_sret                         = returns_sret ? LLVMGetParam(func, 0) : NULL;
+        if (ctx->current_sret)
+            LLVMSetValueName2(ctx->current_sret, "sret", strlen("sret"));
 
         size_t fixed_params            = fixed_param_count;
         ctx->current_fixed_param_count = fixed_params;
         if (stmt->fun_stmt.params)
         {
-            size_t fixed_index = 0;
+            size_t fixed_index = first_fixed_param;
             for (int i = 0; i < stmt->fun_stmt.params->count; i++)
             {
                 AstNode *param = stmt->fun_stmt.params->items[i];
@@ -1652,24 +2754,46 @@ LLVMValueRef codegen_stmt_fun(CodegenContext *ctx, AstNode *stmt)
 
         if (uses_mach_varargs)
         {
-            unsigned count_index            = (unsigned)fixed_params;
+            unsigned count_index            = (unsigned)(first_fixed_param + fixed_params);
             ctx->current_vararg_count_value = LLVMGetParam(func, count_index);
-            ctx->current_vararg_array       = LLVMGetParam(func, count_index + 1);
+            ctx->current_vararg_data        = LLVMGetParam(func, count_index + 1);
+            ctx->current_vararg_desc        = LLVMGetParam(func, count_index + 2);
             LLVMSetValueName2(ctx->current_vararg_count_value, "__mach_vararg_count", strlen("__mach_vararg_count"));
-            LLVMSetValueName2(ctx->current_vararg_array, "__mach_vararg_data", strlen("__mach_vararg_data"));
+            LLVMSetValueName2(ctx->current_vararg_data, "__mach_vararg_data", strlen("__mach_vararg_data"));
+            LLVMSetValueName2(ctx->current_vararg_desc, "__mach_vararg_desc", strlen("__mach_vararg_desc"));
+
+            // descriptors are read-only constants, so their loads fold once the call is inlined
+            const char *desc_attrs[] = {"noalias", "readonly"};
+            for (size_t i = 0; i < sizeof(desc_attrs) / sizeof(desc_attrs[0]); i++)
+            {
+                unsigned kind = LLVMGetEnumAttributeKindForName(desc_attrs[i], strlen(desc_attrs[i]));
+                LLVMAddAttributeAtIndex(func, count_index + 3, LLVMCreateEnumAttribute(ctx->context, kind, 0));
+            }
         }
         else
         {
             ctx->current_vararg_count_value = NULL;
-            ctx->current_vararg_array       = NULL;
+            ctx->current_vararg_data        = NULL;
+            ctx->current_vararg_desc        = NULL;
         }
 
         codegen_stmt(ctx, stmt->fun_stmt.body);
 
         if (!LLVMGetBasicBlockTerminator(LLVMGetInsertBlock(ctx->builder)))
         {
-            if (stmt->type->function.return_type == NULL)
+            if (stmt->fun_stmt.hints.is_noreturn)
+            {
+                // falling off the end of a noreturn function is undefined
+                LLVMBuildUnreachable(ctx->builder);
+            }
+            else if (stmt->type->function.return_type == NULL)
+            {
+                LLVMBuildRetVoid(ctx->builder);
+            }
+            else if (ctx->current_sret)
             {
+                Type *ret_type = stmt->type->function.return_type;
+                codegen_store_zero(ctx, ctx->current_sret, ret_type, codegen_get_llvm_type(ctx, ret_type));
                 LLVMBuildRetVoid(ctx->builder);
             }
             else
@@ -1680,11 +2804,17 @@ LLVMValueRef codegen_stmt_fun(CodegenContext *ctx, AstNode *stmt)
             }
         }
 
+        if (stmt->fun_stmt.hints.is_flatten)
+            codegen_flatten_calls(ctx, func);
+
         ctx->current_vararg_count_value = prev_vararg_count_value;
-        ctx->current_vararg_array       = prev_vararg_array;
+        ctx->current_vararg_data        = prev_vararg_data;
+        ctx->current_vararg_desc        = prev_vararg_desc;
         ctx->current_fixed_param_count  = prev_fixed_param_count;
         ctx->current_function           = prev_function;
         ctx->current_function_type      = prev_ftype;
+        ctx->trap_block                 = prev_trap_block;
+        ctx->current_sret               = prev_sret;
         if (subprogram)
         {
             ctx->current_di_scope      = prev_scope;
@@ -1698,6 +2828,17 @@ LLVMValueRef codegen_stmt_fun(CodegenContext *ctx, AstNode *stmt)
 
 LLVMValueRef codegen_stmt_ret(CodegenContext *ctx, AstNode *stmt)
 {
+    // sret functions construct the result in the caller's slot and return nothing
+    if (ctx->current_sret)
+    {
+        if (stmt->ret_stmt.expr && !codegen_expr_into(ctx, stmt->ret_stmt.expr, ctx->current_sret, ctx->current_function_type->function.return_type))
+        {
+            codegen_error(ctx, stmt, "failed to generate return value");
+            return NULL;
+        }
+        return LLVMBuildRetVoid(ctx->builder);
+    }
+
     if (stmt->ret_stmt.expr)
     {
         LLVMValueRef value = codegen_expr(ctx, stmt->ret_stmt.expr);
@@ -1757,33 +2898,67 @@ LLVMValueRef codegen_stmt_ret(CodegenContext *ctx, AstNode *stmt)
     }
 }
 
+// i1 truth value of a scalar condition; null for aggregates
+static LLVMValueRef codegen_truthiness(CodegenContext *ctx, LLVMValueRef value, Type *type, const char *label)
+{
+    type = type_resolve_alias(type);
+    if (type_is_integer(type) || type_is_pointer_like(type))
+        return LLVMBuildICmp(ctx->builder, LLVMIntNE, value, LLVMConstNull(LLVMTypeOf(value)), label);
+    if (type_is_float(type))
+        return LLVMBuildFCmp(ctx->builder, LLVMRealONE, value, LLVMConstReal(LLVMTypeOf(value), 0.0), label);
+    return NULL;
+}
+
+// unwraps likely(c)/unlikely(c), reporting which way the branch leans
+static bool codegen_branch_hint(AstNode **cond, bool *expected)
+{
+    AstNode *node = *cond;
+    if (node->kind != AST_EXPR_CALL || node->call_expr.func->kind != AST_EXPR_IDENT || !node->call_expr.args || node->call_expr.args->count != 1)
+        return false;
+
+    const char *name = node->call_expr.func->ident_expr.name;
+    if (strcmp(name, "likely") != 0 && strcmp(name, "unlikely") != 0)
+        return false;
+
+    *expected = name[0] == 'l';
+    *cond     = node->call_expr.args->items[0];
+    return true;
+}
+
+// i1 branch condition; hinted conditions go through llvm.expect, which the optimizer turns into branch weights
+static LLVMValueRef codegen_branch_condition(CodegenContext *ctx, AstNode *cond, const char *label)
+{
+    bool         expected = false;
+    bool         hinted   = codegen_branch_hint(&cond, &expected);
+    LLVMValueRef value    = codegen_expr(ctx, cond);
+    if (!value)
+    {
+        codegen_error(ctx, cond, "failed to generate condition");
+        return NULL;
+    }
+
+    LLVMValueRef truth = codegen_truthiness(ctx, value, cond->type, label);
+    if (!truth)
+    {
+        codegen_error(ctx, cond, "invalid truthiness for condition (struct/union not allowed)");
+        return NULL;
+    }
+    if (!hinted)
+        return truth;
+
+    LLVMTypeRef  i1_ty   = LLVMInt1TypeInContext(ctx->context);
+    LLVMValueRef args[2] = {truth, LLVMConstInt(i1_ty, expected, false)};
+    return codegen_call_intrinsic(ctx, "llvm.expect", &i1_ty, 1, args, 2, label);
+}
+
 LLVMValueRef codegen_stmt_if(CodegenContext *ctx, AstNode *stmt)
 {
     LLVMValueRef cond_value = NULL;
     if (stmt->cond_stmt.cond)
     {
-        cond_value = codegen_expr(ctx, stmt->cond_stmt.cond);
+        cond_value = codegen_branch_condition(ctx, stmt->cond_stmt.cond, "ifcond");
         if (!cond_value)
-        {
-            codegen_error(ctx, stmt, "failed to generate if condition");
-            return NULL;
-        }
-        Type *ct = type_resolve_alias(stmt->cond_stmt.cond->type);
-        if (type_is_integer(ct) || type_is_pointer_like(ct))
-        {
-            LLVMValueRef zero = LLVMConstNull(LLVMTypeOf(cond_value));
-            cond_value        = LLVMBuildICmp(ctx->builder, LLVMIntNE, cond_value, zero, "ifcond");
-        }
-        else if (type_is_float(ct))
-        {
-            LLVMValueRef zero = LLVMConstReal(LLVMTypeOf(cond_value), 0.0);
-            cond_value        = LLVMBuildFCmp(ctx->builder, LLVMRealONE, cond_value, zero, "ifcond");
-        }
-        else
-        {
-            codegen_error(ctx, stmt, "invalid truthiness for condition (struct/union not allowed)");
             return NULL;
-        }
     }
     else
     {
@@ -1833,17 +3008,188 @@ LLVMValueRef codegen_stmt_if(CodegenContext *ctx, AstNode *stmt)
     return NULL;
 }
 
+// bounds checking
+
+// weight of the expected edge against 1 for the cold one (llvm's default for __builtin_expect)
+#define CODEGEN_LIKELY_BRANCH_WEIGHT 2000
+
+// branch_weights metadata marking the true edge of a conditional branch as cold
+static void codegen_mark_cold_branch(CodegenContext *ctx, LLVMValueRef branch)
+{
+    LLVMTypeRef     i32_ty = LLVMInt32TypeInContext(ctx->context);
+    LLVMMetadataRef ops[3] = {
+        LLVMMDStringInContext2(ctx->context, "branch_weights", strlen("branch_weights")),
+        LLVMValueAsMetadata(LLVMConstInt(i32_ty, 1, false)),
+        LLVMValueAsMetadata(LLVMConstInt(i32_ty, CODEGEN_LIKELY_BRANCH_WEIGHT, false)),
+    };
+
+    unsigned kind = LLVMGetMDKindIDInContext(ctx->context, "prof", strlen("prof"));
+    LLVMSetMetadata(branch, kind, LLVMMetadataAsValue(ctx->context, LLVMMDNodeInContext2(ctx->context, ops, 3)));
+}
+
+static LLVMBasicBlockRef codegen_get_trap_block(CodegenContext *ctx)
+{
+    if (ctx->trap_block)
+        return ctx->trap_block;
+
+    // a single abort block per function keeps failure paths out of the hot code
+    LLVMBasicBlockRef saved_block = LLVMGetInsertBlock(ctx->builder);
+    ctx->trap_block               = LLVMAppendBasicBlockInContext(ctx->context, ctx->current_function, "bounds_fail");
+    LLVMPositionBuilderAtEnd(ctx->builder, ctx->trap_block);
+
+    LLVMTypeRef  abort_type = LLVMFunctionType(LLVMVoidTypeInContext(ctx->context), NULL, 0, false);
+    LLVMValueRef abort_func = LLVMGetNamedFunction(ctx->module, "abort");
+    if (!abort_func)
+    {
+        abort_func = LLVMAddFunction(ctx->module, "abort", abort_type);
+    }
+    LLVMValueRef abort_call = LLVMBuildCall2(ctx->builder, abort_type, abort_func, NULL, 0, "");
+
+    const char *call_attrs[] = {"cold", "noreturn"};
+    for (size_t i = 0; i < sizeof(call_attrs) / sizeof(call_attrs[0]); i++)
+    {
+        unsigned kind = LLVMGetEnumAttributeKindForName(call_attrs[i], strlen(call_attrs[i]));
+        LLVMAddCallSiteAttribute(abort_call, LLVMAttributeFunctionIndex, LLVMCreateEnumAttribute(ctx->context, kind, 0));
+    }
+    LLVMBuildUnreachable(ctx->builder);
+
+    LLVMPositionBuilderAtEnd(ctx->builder, saved_block);
+    return ctx->trap_block;
+}
+
+// branch to the trap block unless 0 <= index < length; continues in a fresh block
+static void codegen_emit_bounds_check(CodegenContext *ctx, LLVMValueRef index, bool index_signed, LLVMValueRef length)
+{
+    LLVMBasicBlockRef trap_block = codegen_get_trap_block(ctx);
+    LLVMBasicBlockRef ok_block   = LLVMAppendBasicBlockInContext(ctx->context, ctx->current_function, "bounds_ok");
+
+    LLVMValueRef bounds_violated;
+    if (index_signed)
+    {
+        LLVMValueRef zero         = LLVMConstInt(LLVMTypeOf(index), 0, false);
+        LLVMValueRef is_negative  = LLVMBuildICmp(ctx->builder, LLVMIntSLT, index, zero, "is_negative");
+        LLVMValueRef index_ext    = LLVMBuildSExt(ctx->builder, index, LLVMTypeOf(length), "index_ext");
+        LLVMValueRef is_too_large = LLVMBuildICmp(ctx->builder, LLVMIntSGE, index_ext, length, "is_too_large");
+        bounds_violated           = LLVMBuildOr(ctx->builder, is_negative, is_too_large, "bounds_violated");
+    }
+    else
+    {
+        LLVMValueRef index_ext = LLVMBuildZExt(ctx->builder, index, LLVMTypeOf(length), "index_ext");
+        bounds_violated        = LLVMBuildICmp(ctx->builder, LLVMIntUGE, index_ext, length, "bounds_violated");
+    }
+
+    codegen_mark_cold_branch(ctx, LLVMBuildCondBr(ctx->builder, bounds_violated, trap_block, ok_block));
+    LLVMPositionBuilderAtEnd(ctx->builder, ok_block);
+}
+
+// checks for slice accesses the analyser moved in front of a loop
+static bool codegen_emit_hoisted_bounds_checks(CodegenContext *ctx, AstList *hoisted)
+{
+    for (int i = 0; i < hoisted->count; i++)
+    {
+        AstNode     *access = hoisted->items[i];
+        AstNode     *array  = access->index_expr.array;
+        AstNode     *index  = access->index_expr.index;
+        LLVMValueRef slice  = codegen_expr(ctx, array);
+        LLVMValueRef offset = codegen_expr(ctx, index);
+        if (!slice || !offset)
+        {
+            codegen_error(ctx, access, "failed to generate hoisted bounds check");
+            return false;
+        }
+
+        LLVMValueRef fat_ptr = codegen_load_if_needed(ctx, slice, type_resolve_alias(array->type), array);
+        LLVMValueRef length  = LLVMBuildExtractValue(ctx->builder, fat_ptr, 1, "array_length");
+        offset               = codegen_load_if_needed(ctx, offset, index->type, index);
+        codegen_emit_bounds_check(ctx, offset, type_is_signed(index->type), length);
+    }
+    return true;
+}
+
+static LLVMValueRef codegen_loop_condition(CodegenContext *ctx, AstNode *stmt)
+{
+    return codegen_branch_condition(ctx, stmt->for_stmt.cond, "loopcond");
+}
+
+static LLVMMetadataRef codegen_loop_hint(CodegenContext *ctx, const char *name, LLVMValueRef value)
+{
+    LLVMMetadataRef ops[2] = {LLVMMDStringInContext2(ctx->context, name, strlen(name)), value ? LLVMValueAsMetadata(value) : NULL};
+    return LLVMMDNodeInContext2(ctx->context, ops, value ? 2 : 1);
+}
+
+// attach #@vectorize / #@unroll / #@no_unroll as llvm.loop metadata to the loop's back-edge
+static void codegen_attach_loop_hints(CodegenContext *ctx, LLVMValueRef branch, const LoopHints *hints)
+{
+    LLVMTypeRef     i1_ty  = LLVMInt1TypeInContext(ctx->context);
+    LLVMTypeRef     i32_ty = LLVMInt32TypeInContext(ctx->context);
+    LLVMMetadataRef ops[5];
+    size_t          count = 0;
+
+    // loop ids are self-referential; patch the first operand once the node exists
+    LLVMMetadataRef self = LLVMTemporaryMDNode(ctx->context, NULL, 0);
+    ops[count++]         = self;
+
+    if (hints->vectorize_width > 1)
+    {
+        ops[count++] = codegen_loop_hint(ctx, "llvm.loop.vectorize.width", LLVMConstInt(i32_ty, (unsigned long long)hints->vectorize_width, false));
+        ops[count++] = codegen_loop_hint(ctx, "llvm.loop.vectorize.enable", LLVMConstInt(i1_ty, 1, false));
+    }
+    else if (hints->vectorize_width == 1)
+    {
+        // width 1 without interleaving turns the vectorizer off for this loop
+        ops[count++] = codegen_loop_hint(ctx, "llvm.loop.vectorize.width", LLVMConstInt(i32_ty, 1, false));
+        ops[count++] = codegen_loop_hint(ctx, "llvm.loop.interleave.count", LLVMConstInt(i32_ty, 1, false));
+    }
+
+    if (hints->no_unroll)
+        ops[count++] = codegen_loop_hint(ctx, "llvm.loop.unroll.disable", NULL);
+    else if (hints->unroll_count > 0)
+        ops[count++] = codegen_loop_hint(ctx, "llvm.loop.unroll.count", LLVMConstInt(i32_ty, (unsigned long long)hints->unroll_count, false));
+
+    LLVMMetadataRef loop_id = LLVMMDNodeInContext2(ctx->context, ops, count);
+    LLVMMetadataReplaceAllUsesWith(self, loop_id);
+
+    unsigned kind = LLVMGetMDKindIDInContext(ctx->context, "llvm.loop", strlen("llvm.loop"));
+    LLVMSetMetadata(branch, kind, LLVMMetadataAsValue(ctx->context, loop_id));
+}
+
 LLVMValueRef codegen_stmt_for(CodegenContext *ctx, AstNode *stmt)
 {
-    LLVMBasicBlockRef loop_block = LLVMAppendBasicBlockInContext(ctx->context, ctx->current_function, "loop");
-    LLVMBasicBlockRef body_block = LLVMAppendBasicBlockInContext(ctx->context, ctx->current_function, "loop.body");
-    LLVMBasicBlockRef exit_block = LLVMAppendBasicBlockInContext(ctx->context, ctx->current_function, "loop.exit");
+    // annotated loops get a single latch so 'cnt' and the fallthrough share one back-edge
+    const LoopHints  *hints       = &stmt->for_stmt.hints;
+    bool              has_hints   = hints->vectorize_width || hints->unroll_count || hints->no_unroll;
+    bool              has_hoisted = stmt->for_stmt.bounds_hoisted && stmt->for_stmt.bounds_hoisted->count > 0;
+    LLVMBasicBlockRef check_block = has_hoisted ? LLVMAppendBasicBlockInContext(ctx->context, ctx->current_function, "loop.check") : NULL;
+    LLVMBasicBlockRef loop_block  = LLVMAppendBasicBlockInContext(ctx->context, ctx->current_function, "loop");
+    LLVMBasicBlockRef body_block  = LLVMAppendBasicBlockInContext(ctx->context, ctx->current_function, "loop.body");
+    LLVMBasicBlockRef latch_block = has_hints ? LLVMAppendBasicBlockInContext(ctx->context, ctx->current_function, "loop.latch") : NULL;
+    LLVMBasicBlockRef exit_block  = LLVMAppendBasicBlockInContext(ctx->context, ctx->current_function, "loop.exit");
 
     // save loop context
     LLVMBasicBlockRef prev_break    = ctx->break_block;
     LLVMBasicBlockRef prev_continue = ctx->continue_block;
     ctx->break_block                = exit_block;
-    ctx->continue_block             = loop_block;
+    ctx->continue_block             = latch_block ? latch_block : loop_block;
+
+    // loop-invariant bounds checks run once, only if the loop is entered
+    if (has_hoisted)
+    {
+        if (stmt->for_stmt.cond)
+        {
+            LLVMValueRef entry_cond = codegen_loop_condition(ctx, stmt);
+            if (!entry_cond)
+                return NULL;
+            LLVMBuildCondBr(ctx->builder, entry_cond, check_block, exit_block);
+        }
+        else
+        {
+            LLVMBuildBr(ctx->builder, check_block);
+        }
+
+        LLVMPositionBuilderAtEnd(ctx->builder, check_block);
+        if (!codegen_emit_hoisted_bounds_checks(ctx, stmt->for_stmt.bounds_hoisted))
+            return NULL;
+    }
 
     // jump to loop header
     LLVMBuildBr(ctx->builder, loop_block);
@@ -1853,26 +3199,9 @@ LLVMValueRef codegen_stmt_for(CodegenContext *ctx, AstNode *stmt)
 
     if (stmt->for_stmt.cond)
     {
-        LLVMValueRef cond_value = codegen_expr(ctx, stmt->for_stmt.cond);
+        LLVMValueRef cond_value = codegen_loop_condition(ctx, stmt);
         if (!cond_value)
-        {
-            codegen_error(ctx, stmt, "failed to generate loop condition");
-            return NULL;
-        }
-        Type *ct = type_resolve_alias(stmt->for_stmt.cond->type);
-        if (type_is_integer(ct) || type_is_pointer_like(ct))
-        {
-            cond_value = LLVMBuildICmp(ctx->builder, LLVMIntNE, cond_value, LLVMConstNull(LLVMTypeOf(cond_value)), "loopcond");
-        }
-        else if (type_is_float(ct))
-        {
-            cond_value = LLVMBuildFCmp(ctx->builder, LLVMRealONE, cond_value, LLVMConstReal(LLVMTypeOf(cond_value), 0.0), "loopcond");
-        }
-        else
-        {
-            codegen_error(ctx, stmt, "invalid truthiness for loop condition (struct/union not allowed)");
             return NULL;
-        }
 
         LLVMBuildCondBr(ctx->builder, cond_value, body_block, exit_block);
     }
@@ -1887,7 +3216,13 @@ LLVMValueRef codegen_stmt_for(CodegenContext *ctx, AstNode *stmt)
     codegen_stmt(ctx, stmt->for_stmt.body);
     if (!LLVMGetBasicBlockTerminator(LLVMGetInsertBlock(ctx->builder)))
     {
-        LLVMBuildBr(ctx->builder, loop_block);
+        LLVMBuildBr(ctx->builder, ctx->continue_block);
+    }
+
+    if (latch_block)
+    {
+        LLVMPositionBuilderAtEnd(ctx->builder, latch_block);
+        codegen_attach_loop_hints(ctx, LLVMBuildBr(ctx->builder, loop_block), hints);
     }
 
     // restore loop context
@@ -2062,6 +3397,11 @@ LLVMValueRef codegen_expr_ident(CodegenContext *ctx, AstNode *expr)
             if (!value)
             {
                 value = LLVMAddGlobal(ctx->module, ty, gname);
+                // cross-module tls uses a static offset from the thread pointer
+                if (expr->symbol->var.is_thread_local)
+                {
+                    LLVMSetThreadLocalMode(value, LLVMInitialExecTLSModel);
+                }
             }
             codegen_set_symbol_value(ctx, expr->symbol, value);
         }
@@ -2088,6 +3428,62 @@ LLVMValueRef codegen_expr_ident(CodegenContext *ctx, AstNode *expr)
     return value;
 }
 
+// element-wise vector operators; comparisons are sign-extended to an all-ones lane mask
+static LLVMValueRef codegen_vector_binary(CodegenContext *ctx, AstNode *expr, LLVMValueRef lhs, LLVMValueRef rhs, Type *vector_type)
+{
+    Type *elem      = vector_type->vector.elem_type;
+    bool  is_float  = type_is_float(elem);
+    bool  is_signed = type_is_signed(elem);
+
+    LLVMValueRef cmp = NULL;
+    switch (expr->binary_expr.op)
+    {
+    case TOKEN_PLUS:
+        return is_float ? LLVMBuildFAdd(ctx->builder, lhs, rhs, "vadd") : LLVMBuildAdd(ctx->builder, lhs, rhs, "vadd");
+    case TOKEN_MINUS:
+        return is_float ? LLVMBuildFSub(ctx->builder, lhs, rhs, "vsub") : LLVMBuildSub(ctx->builder, lhs, rhs, "vsub");
+    case TOKEN_STAR:
+        return is_float ? LLVMBuildFMul(ctx->builder, lhs, rhs, "vmul") : LLVMBuildMul(ctx->builder, lhs, rhs, "vmul");
+    case TOKEN_SLASH:
+        return is_float ? LLVMBuildFDiv(ctx->builder, lhs, rhs, "vdiv") : (is_signed ? LLVMBuildSDiv(ctx->builder, lhs, rhs, "vdiv") : LLVMBuildUDiv(ctx->builder, lhs, rhs, "vdiv"));
+    case TOKEN_PERCENT:
+        return is_float ? LLVMBuildFRem(ctx->builder, lhs, rhs, "vrem") : (is_signed ? LLVMBuildSRem(ctx->builder, lhs, rhs, "vrem") : LLVMBuildURem(ctx->builder, lhs, rhs, "vrem"));
+    case TOKEN_AMPERSAND:
+        return LLVMBuildAnd(ctx->builder, lhs, rhs, "vand");
+    case TOKEN_PIPE:
+        return LLVMBuildOr(ctx->builder, lhs, rhs, "vor");
+    case TOKEN_CARET:
+        return LLVMBuildXor(ctx->builder, lhs, rhs, "vxor");
+    case TOKEN_LESS_LESS:
+        return LLVMBuildShl(ctx->builder, lhs, rhs, "vshl");
+    case TOKEN_GREATER_GREATER:
+        return is_signed ? LLVMBuildAShr(ctx->builder, lhs, rhs, "vshr") : LLVMBuildLShr(ctx->builder, lhs, rhs, "vshr");
+    case TOKEN_EQUAL_EQUAL:
+        cmp = is_float ? LLVMBuildFCmp(ctx->builder, LLVMRealOEQ, lhs, rhs, "veq") : LLVMBuildICmp(ctx->builder, LLVMIntEQ, lhs, rhs, "veq");
+        break;
+    case TOKEN_BANG_EQUAL:
+        cmp = is_float ? LLVMBuildFCmp(ctx->builder, LLVMRealUNE, lhs, rhs, "vne") : LLVMBuildICmp(ctx->builder, LLVMIntNE, lhs, rhs, "vne");
+        break;
+    case TOKEN_LESS:
+        cmp = is_float ? LLVMBuildFCmp(ctx->builder, LLVMRealOLT, lhs, rhs, "vlt") : LLVMBuildICmp(ctx->builder, is_signed ? LLVMIntSLT : LLVMIntULT, lhs, rhs, "vlt");
+        break;
+    case TOKEN_LESS_EQUAL:
+        cmp = is_float ? LLVMBuildFCmp(ctx->builder, LLVMRealOLE, lhs, rhs, "vle") : LLVMBuildICmp(ctx->builder, is_signed ? LLVMIntSLE : LLVMIntULE, lhs, rhs, "vle");
+        break;
+    case TOKEN_GREATER:
+        cmp = is_float ? LLVMBuildFCmp(ctx->builder, LLVMRealOGT, lhs, rhs, "vgt") : LLVMBuildICmp(ctx->builder, is_signed ? LLVMIntSGT : LLVMIntUGT, lhs, rhs, "vgt");
+        break;
+    case TOKEN_GREATER_EQUAL:
+        cmp = is_float ? LLVMBuildFCmp(ctx->builder, LLVMRealOGE, lhs, rhs, "vge") : LLVMBuildICmp(ctx->builder, is_signed ? LLVMIntSGE : LLVMIntUGE, lhs, rhs, "vge");
+        break;
+    default:
+        codegen_error(ctx, expr, "unimplemented vector operator");
+        return NULL;
+    }
+
+    return LLVMBuildSExt(ctx->builder, cmp, codegen_get_llvm_type(ctx, expr->type), "vmask");
+}
+
 LLVMValueRef codegen_expr_binary(CodegenContext *ctx, AstNode *expr)
 {
     // handle assignment specially
@@ -2115,6 +3511,8 @@ LLVMValueRef codegen_expr_binary(CodegenContext *ctx, AstNode *expr)
                 codegen_error(ctx, expr, "failed to generate rhs for store");
                 return NULL;
             }
+            if (codegen_copy_aggregate(ctx, dest, rhs, expr->binary_expr.right->type))
+                return rhs;
             rhs = codegen_load_if_needed(ctx, rhs, expr->binary_expr.right->type, expr->binary_expr.right);
             LLVMBuildStore(ctx->builder, rhs, dest);
             return rhs;
@@ -2129,6 +3527,9 @@ LLVMValueRef codegen_expr_binary(CodegenContext *ctx, AstNode *expr)
             return NULL;
         }
 
+        if (codegen_copy_aggregate(ctx, lhs, rhs, expr->binary_expr.right->type))
+            return rhs;
+
         // load rhs value if needed
         rhs = codegen_load_if_needed(ctx, rhs, expr->binary_expr.right->type, expr->binary_expr.right);
 
@@ -2154,6 +3555,9 @@ LLVMValueRef codegen_expr_binary(CodegenContext *ctx, AstNode *expr)
     Type *lhs_type = type_resolve_alias(expr->binary_expr.left->type);
     Type *rhs_type = type_resolve_alias(expr->binary_expr.right->type);
 
+    if (lhs_type && lhs_type->kind == TYPE_VECTOR)
+        return codegen_vector_binary(ctx, expr, lhs, rhs, lhs_type);
+
     // handle integer type mismatches by extending smaller type
     if (type_is_integer(lhs_type) && type_is_integer(rhs_type) && lhs_type->kind != rhs_type->kind)
     {
@@ -2215,134 +3619,489 @@ LLVMValueRef codegen_expr_binary(CodegenContext *ctx, AstNode *expr)
         }
     }
 
-    // pointer arithmetic: ptr + int or ptr - int
-    if ((expr->binary_expr.op == TOKEN_PLUS || expr->binary_expr.op == TOKEN_MINUS) && type_is_pointer_like(lhs_type) && type_is_integer(rhs_type))
-    {
-        LLVMValueRef index = rhs;
-        if (expr->binary_expr.op == TOKEN_MINUS)
-        {
-            index = LLVMBuildNeg(ctx->builder, rhs, "negindex");
-        }
+    // pointer arithmetic: ptr + int or ptr - int
+    if ((expr->binary_expr.op == TOKEN_PLUS || expr->binary_expr.op == TOKEN_MINUS) && type_is_pointer_like(lhs_type) && type_is_integer(rhs_type))
+    {
+        LLVMValueRef index = rhs;
+        if (expr->binary_expr.op == TOKEN_MINUS)
+        {
+            index = LLVMBuildNeg(ctx->builder, rhs, "negindex");
+        }
+
+        // Get the pointee type to scale the index correctly
+        Type *pointee_type = NULL;
+        if (lhs_type->kind == TYPE_POINTER)
+        {
+            pointee_type = lhs_type->pointer.base;
+        }
+
+        // Use proper element type for GEP scaling
+        if (pointee_type)
+        {
+            LLVMTypeRef  elem_ty = codegen_get_llvm_type(ctx, pointee_type);
+            LLVMValueRef gep     = LLVMBuildGEP2(ctx->builder, elem_ty, lhs, &index, 1, "ptradd");
+            return gep;
+        }
+        else
+        {
+            // Fallback to byte addressing for untyped pointers (TYPE_PTR)
+            LLVMTypeRef  i8ty = LLVMInt8TypeInContext(ctx->context);
+            LLVMValueRef gep  = LLVMBuildGEP2(ctx->builder, i8ty, lhs, &index, 1, "ptradd");
+            return gep;
+        }
+    }
+
+    switch (expr->binary_expr.op)
+    {
+    case TOKEN_PLUS:
+        return operands_are_float ? LLVMBuildFAdd(ctx->builder, lhs, rhs, "add") : LLVMBuildAdd(ctx->builder, lhs, rhs, "add");
+    case TOKEN_MINUS:
+        return operands_are_float ? LLVMBuildFSub(ctx->builder, lhs, rhs, "sub") : LLVMBuildSub(ctx->builder, lhs, rhs, "sub");
+    case TOKEN_STAR:
+        return operands_are_float ? LLVMBuildFMul(ctx->builder, lhs, rhs, "mul") : LLVMBuildMul(ctx->builder, lhs, rhs, "mul");
+    case TOKEN_SLASH:
+        return operands_are_float ? LLVMBuildFDiv(ctx->builder, lhs, rhs, "div") : (is_signed ? LLVMBuildSDiv(ctx->builder, lhs, rhs, "div") : LLVMBuildUDiv(ctx->builder, lhs, rhs, "div"));
+    case TOKEN_PERCENT:
+        return is_signed ? LLVMBuildSRem(ctx->builder, lhs, rhs, "rem") : LLVMBuildURem(ctx->builder, lhs, rhs, "rem");
+    case TOKEN_AMPERSAND:
+        // bitwise and (integers)
+        return LLVMBuildAnd(ctx->builder, lhs, rhs, "band");
+    case TOKEN_PIPE:
+        // bitwise or
+        return LLVMBuildOr(ctx->builder, lhs, rhs, "bor");
+    case TOKEN_EQUAL_EQUAL:
+        return operands_are_float ? LLVMBuildFCmp(ctx->builder, LLVMRealOEQ, lhs, rhs, "feq") : LLVMBuildICmp(ctx->builder, LLVMIntEQ, lhs, rhs, "eq");
+    case TOKEN_BANG_EQUAL:
+        return operands_are_float ? LLVMBuildFCmp(ctx->builder, LLVMRealUNE, lhs, rhs, "fne") : LLVMBuildICmp(ctx->builder, LLVMIntNE, lhs, rhs, "ne");
+    case TOKEN_LESS:
+        return operands_are_float ? LLVMBuildFCmp(ctx->builder, LLVMRealOLT, lhs, rhs, "lt") : (is_signed ? LLVMBuildICmp(ctx->builder, LLVMIntSLT, lhs, rhs, "lt") : LLVMBuildICmp(ctx->builder, LLVMIntULT, lhs, rhs, "lt"));
+    case TOKEN_LESS_EQUAL:
+        return operands_are_float ? LLVMBuildFCmp(ctx->builder, LLVMRealOLE, lhs, rhs, "le") : (is_signed ? LLVMBuildICmp(ctx->builder, LLVMIntSLE, lhs, rhs, "le") : LLVMBuildICmp(ctx->builder, LLVMIntULE, lhs, rhs, "le"));
+    case TOKEN_GREATER:
+        return operands_are_float ? LLVMBuildFCmp(ctx->builder, LLVMRealOGT, lhs, rhs, "gt") : (is_signed ? LLVMBuildICmp(ctx->builder, LLVMIntSGT, lhs, rhs, "gt") : LLVMBuildICmp(ctx->builder, LLVMIntUGT, lhs, rhs, "gt"));
+    case TOKEN_GREATER_EQUAL:
+        return operands_are_float ? LLVMBuildFCmp(ctx->builder, LLVMRealOGE, lhs, rhs, "ge") : (is_signed ? LLVMBuildICmp(ctx->builder, LLVMIntSGE, lhs, rhs, "ge") : LLVMBuildICmp(ctx->builder, LLVMIntUGE, lhs, rhs, "ge"));
+    case TOKEN_AMPERSAND_AMPERSAND:
+    {
+        LLVMValueRef l1 = LLVMBuildICmp(ctx->builder, LLVMIntNE, lhs, LLVMConstNull(LLVMTypeOf(lhs)), "l1");
+        LLVMValueRef r1 = LLVMBuildICmp(ctx->builder, LLVMIntNE, rhs, LLVMConstNull(LLVMTypeOf(rhs)), "r1");
+        return LLVMBuildAnd(ctx->builder, l1, r1, "and");
+    }
+    case TOKEN_PIPE_PIPE:
+    case TOKEN_KW_OR:
+    {
+        LLVMValueRef l1 = LLVMBuildICmp(ctx->builder, LLVMIntNE, lhs, LLVMConstNull(LLVMTypeOf(lhs)), "l1");
+        LLVMValueRef r1 = LLVMBuildICmp(ctx->builder, LLVMIntNE, rhs, LLVMConstNull(LLVMTypeOf(rhs)), "r1");
+        return LLVMBuildOr(ctx->builder, l1, r1, "or");
+    }
+    case TOKEN_CARET:
+        return LLVMBuildXor(ctx->builder, lhs, rhs, "xor");
+    case TOKEN_LESS_LESS:
+        return LLVMBuildShl(ctx->builder, lhs, rhs, "shl");
+    case TOKEN_GREATER_GREATER:
+        return is_signed ? LLVMBuildAShr(ctx->builder, lhs, rhs, "shr") : LLVMBuildLShr(ctx->builder, lhs, rhs, "shr");
+        {
+        default:
+            codegen_error(ctx, expr, "unimplemented binary operator");
+            return NULL;
+        }
+    }
+}
+
+LLVMValueRef codegen_expr_unary(CodegenContext *ctx, AstNode *expr)
+{
+    LLVMValueRef operand = codegen_expr(ctx, expr->unary_expr.expr);
+    if (!operand)
+    {
+        codegen_error(ctx, expr, "failed to generate unary operand");
+        return NULL;
+    }
+
+    switch (expr->unary_expr.op)
+    {
+    case TOKEN_MINUS:
+        operand = codegen_load_if_needed(ctx, operand, expr->unary_expr.expr->type, expr->unary_expr.expr);
+        if (type_is_float(expr->type) || (type_is_vector(expr->type) && type_is_float(type_resolve_alias(expr->type)->vector.elem_type)))
+        {
+            return LLVMBuildFNeg(ctx->builder, operand, "neg");
+        }
+        else
+        {
+            return LLVMBuildNeg(ctx->builder, operand, "neg");
+        }
+    case TOKEN_QUESTION: // address-of
+        return operand;
+    case TOKEN_AT: // dereference
+        // for dereference, we always need to load the pointer value first if it's in an alloca/global
+        if (LLVMIsAAllocaInst(operand) || LLVMIsAGlobalVariable(operand))
+        {
+            LLVMTypeRef ptr_type = codegen_get_llvm_type(ctx, expr->unary_expr.expr->type);
+            operand              = LLVMBuildLoad2(ctx->builder, ptr_type, operand, "");
+        }
+        // then dereference the pointer
+        return LLVMBuildLoad2(ctx->builder, codegen_get_llvm_type(ctx, expr->type), operand, "deref");
+    case TOKEN_TILDE: // bitwise not
+        operand = codegen_load_if_needed(ctx, operand, expr->unary_expr.expr->type, expr->unary_expr.expr);
+        return LLVMBuildNot(ctx->builder, operand, "bnot");
+    default:
+        codegen_error(ctx, expr, "unimplemented unary operator");
+        return NULL;
+    }
+}
+
+// call an overloaded llvm intrinsic by name, declaring it in the module on first use
+static LLVMValueRef codegen_call_intrinsic(CodegenContext *ctx, const char *name, LLVMTypeRef *overloads, size_t overload_count, LLVMValueRef *args, unsigned arg_count, const char *label)
+{
+    unsigned id = LLVMLookupIntrinsicID(name, strlen(name));
+    if (id == 0)
+        return NULL;
+
+    LLVMValueRef func    = LLVMGetIntrinsicDeclaration(ctx->module, id, overloads, overload_count);
+    LLVMTypeRef  func_ty = LLVMIntrinsicGetType(ctx->context, id, overloads, overload_count);
+    return LLVMBuildCall2(ctx->builder, func_ty, func, args, arg_count, label);
+}
+
+static LLVMValueRef codegen_intrinsic_operand(CodegenContext *ctx, AstNode *arg)
+{
+    LLVMValueRef value = codegen_expr(ctx, arg);
+    if (!value)
+        return NULL;
+    return codegen_load_if_needed(ctx, value, arg->type, arg);
+}
+
+static LLVMValueRef codegen_vector_reduce(CodegenContext *ctx, AstNode *expr, const char *op, LLVMValueRef vector, Type *vector_type)
+{
+    Type       *elem      = vector_type->vector.elem_type;
+    bool        is_float  = type_is_float(elem);
+    bool        is_signed = type_is_signed(elem);
+    LLVMTypeRef vec_ty    = LLVMTypeOf(vector);
+    char        name[64];
+
+    if (is_float && (strcmp(op, "add") == 0 || strcmp(op, "mul") == 0))
+    {
+        // ordered reduction seeded with the identity so results match a scalar loop
+        LLVMTypeRef  elem_ty = codegen_get_llvm_type(ctx, elem);
+        LLVMValueRef start   = strcmp(op, "add") == 0 ? LLVMConstReal(elem_ty, -0.0) : LLVMConstReal(elem_ty, 1.0);
+        LLVMValueRef args[2] = {start, vector};
+        snprintf(name, sizeof(name), "llvm.vector.reduce.f%s", op);
+        return codegen_call_intrinsic(ctx, name, &vec_ty, 1, args, 2, "vreduce");
+    }
+
+    if (strcmp(op, "min") == 0 || strcmp(op, "max") == 0)
+        snprintf(name, sizeof(name), "llvm.vector.reduce.%s%s", is_float ? "f" : (is_signed ? "s" : "u"), op);
+    else
+        snprintf(name, sizeof(name), "llvm.vector.reduce.%s", op);
+
+    LLVMValueRef result = codegen_call_intrinsic(ctx, name, &vec_ty, 1, &vector, 1, "vreduce");
+    if (!result)
+        codegen_error(ctx, expr, "llvm has no intrinsic '%s'", name);
+    return result;
+}
+
+// alignment implied by a typed pointer operand; untyped pointers only guarantee a byte
+static unsigned codegen_pointer_alignment(Type *type)
+{
+    type = type_resolve_alias(type);
+    if (type && type->kind == TYPE_POINTER && type->pointer.base)
+    {
+        size_t align = type_alignof(type_resolve_alias(type->pointer.base));
+        return align ? (unsigned)align : 1;
+    }
+    return 1;
+}
+
+static void codegen_memory_intrinsic(CodegenContext *ctx, AstNode *expr, const char *name)
+{
+    AstList     *args   = expr->call_expr.args;
+    LLVMValueRef dst    = codegen_intrinsic_operand(ctx, args->items[0]);
+    LLVMValueRef middle = codegen_intrinsic_operand(ctx, args->items[1]);
+    LLVMValueRef length = codegen_intrinsic_operand(ctx, args->items[2]);
+    if (!dst || !middle || !length)
+        return;
+
+    unsigned dst_align = codegen_pointer_alignment(args->items[0]->type);
+    length             = LLVMBuildIntCast2(ctx->builder, length, LLVMInt64TypeInContext(ctx->context), false, "mem.len");
+
+    if (strcmp(name, "mem_set") == 0)
+    {
+        LLVMValueRef byte = LLVMBuildIntCast2(ctx->builder, middle, LLVMInt8TypeInContext(ctx->context), false, "mem.byte");
+        LLVMBuildMemSet(ctx->builder, dst, byte, length, dst_align);
+        return;
+    }
+
+    unsigned src_align = codegen_pointer_alignment(args->items[1]->type);
+    if (strcmp(name, "mem_copy") == 0)
+        LLVMBuildMemCpy(ctx->builder, dst, dst_align, middle, src_align, length);
+    else
+        LLVMBuildMemMove(ctx->builder, dst, dst_align, middle, src_align, length);
+}
+
+static LLVMAtomicOrdering codegen_atomic_ordering(AstNode *arg)
+{
+    const char *name = arg->ident_expr.name;
+    if (strcmp(name, "relaxed") == 0)
+        return LLVMAtomicOrderingMonotonic;
+    if (strcmp(name, "acquire") == 0)
+        return LLVMAtomicOrderingAcquire;
+    if (strcmp(name, "release") == 0)
+        return LLVMAtomicOrderingRelease;
+    if (strcmp(name, "acq_rel") == 0)
+        return LLVMAtomicOrderingAcquireRelease;
+    return LLVMAtomicOrderingSequentiallyConsistent;
+}
+
+// llvm requires the failure ordering of a cmpxchg to drop any release semantics
+static LLVMAtomicOrdering codegen_atomic_failure_ordering(LLVMAtomicOrdering success)
+{
+    switch (success)
+    {
+    case LLVMAtomicOrderingRelease:
+        return LLVMAtomicOrderingMonotonic;
+    case LLVMAtomicOrderingAcquireRelease:
+        return LLVMAtomicOrderingAcquire;
+    default:
+        return success;
+    }
+}
+
+static LLVMValueRef codegen_atomic_operand(CodegenContext *ctx, AstNode *arg, Type *target)
+{
+    LLVMValueRef value = codegen_intrinsic_operand(ctx, arg);
+    if (!value)
+        return NULL;
+
+    LLVMTypeRef target_ty = codegen_get_llvm_type(ctx, target);
+    if (LLVMTypeOf(value) != target_ty && LLVMGetTypeKind(target_ty) == LLVMIntegerTypeKind && LLVMGetTypeKind(LLVMTypeOf(value)) == LLVMIntegerTypeKind)
+        value = LLVMBuildIntCast2(ctx->builder, value, target_ty, type_is_signed(arg->type), "atomic.cast");
+    return value;
+}
+
+// returns true when name is an atomic_* intrinsic or fence; *out receives the value (NULL for void forms)
+static bool codegen_atomic_intrinsic(CodegenContext *ctx, AstNode *expr, const char *name, LLVMValueRef *out)
+{
+    AstNode **args = expr->call_expr.args ? expr->call_expr.args->items : NULL;
+    *out           = NULL;
+
+    if (strcmp(name, "fence") == 0)
+    {
+        LLVMBuildFence(ctx->builder, codegen_atomic_ordering(args[0]), false, "");
+        return true;
+    }
+
+    static const struct
+    {
+        const char       *name;
+        LLVMAtomicRMWBinOp op;
+    } rmw_ops[] = {
+        {"atomic_xchg", LLVMAtomicRMWBinOpXchg},
+        {"atomic_fetch_add", LLVMAtomicRMWBinOpAdd},
+        {"atomic_fetch_sub", LLVMAtomicRMWBinOpSub},
+        {"atomic_fetch_and", LLVMAtomicRMWBinOpAnd},
+        {"atomic_fetch_or", LLVMAtomicRMWBinOpOr},
+        {"atomic_fetch_xor", LLVMAtomicRMWBinOpXor},
+    };
+
+    bool is_load  = strcmp(name, "atomic_load") == 0;
+    bool is_store = strcmp(name, "atomic_store") == 0;
+    bool is_cas   = strcmp(name, "atomic_cas") == 0;
+    int  rmw      = -1;
+    for (size_t i = 0; i < sizeof(rmw_ops) / sizeof(rmw_ops[0]); i++)
+    {
+        if (strcmp(name, rmw_ops[i].name) == 0)
+            rmw = (int)i;
+    }
+
+    if (!is_load && !is_store && !is_cas && rmw < 0)
+        return false;
+
+    Type        *target = type_resolve_alias(args[0]->type)->pointer.base;
+    unsigned     align  = (unsigned)type_sizeof(type_resolve_alias(target));
+    LLVMValueRef ptr    = codegen_intrinsic_operand(ctx, args[0]);
+    if (!ptr)
+        return true;
+
+    if (is_load)
+    {
+        LLVMValueRef load = LLVMBuildLoad2(ctx->builder, codegen_get_llvm_type(ctx, target), ptr, "atomic.load");
+        LLVMSetOrdering(load, codegen_atomic_ordering(args[1]));
+        LLVMSetAlignment(load, align);
+        *out = load;
+        return true;
+    }
+
+    if (is_store)
+    {
+        LLVMValueRef value = codegen_atomic_operand(ctx, args[1], target);
+        if (!value)
+            return true;
+        LLVMValueRef store = LLVMBuildStore(ctx->builder, value, ptr);
+        LLVMSetOrdering(store, codegen_atomic_ordering(args[2]));
+        LLVMSetAlignment(store, align);
+        return true;
+    }
+
+    if (is_cas)
+    {
+        // yields the previous value; the exchange happened when it equals the expected value
+        LLVMValueRef expected = codegen_atomic_operand(ctx, args[1], target);
+        LLVMValueRef desired  = codegen_atomic_operand(ctx, args[2], target);
+        if (!expected || !desired)
+            return true;
+
+        LLVMAtomicOrdering success = codegen_atomic_ordering(args[3]);
+        LLVMAtomicOrdering failure = expr->call_expr.args->count == 5 ? codegen_atomic_ordering(args[4]) : codegen_atomic_failure_ordering(success);
+        LLVMValueRef       pair    = LLVMBuildAtomicCmpXchg(ctx->builder, ptr, expected, desired, success, failure, false);
+        *out                       = LLVMBuildExtractValue(ctx->builder, pair, 0, "atomic.prev");
+        return true;
+    }
+
+    LLVMValueRef value = codegen_atomic_operand(ctx, args[1], target);
+    if (value)
+        *out = LLVMBuildAtomicRMW(ctx->builder, rmw_ops[rmw].op, ptr, value, codegen_atomic_ordering(args[2]), false);
+    return true;
+}
+
+// popcount/clz/ctz/bswap/rotl/rotr and prefetch map directly onto llvm intrinsics
+static bool codegen_bit_intrinsic(CodegenContext *ctx, AstNode *expr, const char *name, LLVMValueRef *out)
+{
+    AstNode **args = expr->call_expr.args ? expr->call_expr.args->items : NULL;
+    *out           = NULL;
 
-        // Get the pointee type to scale the index correctly
-        Type *pointee_type = NULL;
-        if (lhs_type->kind == TYPE_POINTER)
-        {
-            pointee_type = lhs_type->pointer.base;
-        }
+    LLVMTypeRef i1_ty  = LLVMInt1TypeInContext(ctx->context);
+    LLVMTypeRef i32_ty = LLVMInt32TypeInContext(ctx->context);
 
-        // Use proper element type for GEP scaling
-        if (pointee_type)
-        {
-            LLVMTypeRef  elem_ty = codegen_get_llvm_type(ctx, pointee_type);
-            LLVMValueRef gep     = LLVMBuildGEP2(ctx->builder, elem_ty, lhs, &index, 1, "ptradd");
-            return gep;
-        }
-        else
-        {
-            // Fallback to byte addressing for untyped pointers (TYPE_PTR)
-            LLVMTypeRef  i8ty = LLVMInt8TypeInContext(ctx->context);
-            LLVMValueRef gep  = LLVMBuildGEP2(ctx->builder, i8ty, lhs, &index, 1, "ptradd");
-            return gep;
-        }
+    if (strcmp(name, "prefetch") == 0)
+    {
+        LLVMValueRef ptr = codegen_intrinsic_operand(ctx, args[0]);
+        if (!ptr)
+            return true;
+
+        // the last operand selects the data cache
+        LLVMTypeRef  ptr_ty    = LLVMTypeOf(ptr);
+        LLVMValueRef params[4] = {ptr, LLVMConstInt(i32_ty, args[1]->lit_expr.int_val, false), LLVMConstInt(i32_ty, args[2]->lit_expr.int_val, false), LLVMConstInt(i32_ty, 1, false)};
+        codegen_call_intrinsic(ctx, "llvm.prefetch", &ptr_ty, 1, params, 4, "");
+        return true;
     }
 
-    switch (expr->binary_expr.op)
+    static const struct
     {
-    case TOKEN_PLUS:
-        return operands_are_float ? LLVMBuildFAdd(ctx->builder, lhs, rhs, "add") : LLVMBuildAdd(ctx->builder, lhs, rhs, "add");
-    case TOKEN_MINUS:
-        return operands_are_float ? LLVMBuildFSub(ctx->builder, lhs, rhs, "sub") : LLVMBuildSub(ctx->builder, lhs, rhs, "sub");
-    case TOKEN_STAR:
-        return operands_are_float ? LLVMBuildFMul(ctx->builder, lhs, rhs, "mul") : LLVMBuildMul(ctx->builder, lhs, rhs, "mul");
-    case TOKEN_SLASH:
-        return operands_are_float ? LLVMBuildFDiv(ctx->builder, lhs, rhs, "div") : (is_signed ? LLVMBuildSDiv(ctx->builder, lhs, rhs, "div") : LLVMBuildUDiv(ctx->builder, lhs, rhs, "div"));
-    case TOKEN_PERCENT:
-        return is_signed ? LLVMBuildSRem(ctx->builder, lhs, rhs, "rem") : LLVMBuildURem(ctx->builder, lhs, rhs, "rem");
-    case TOKEN_AMPERSAND:
-        // bitwise and (integers)
-        return LLVMBuildAnd(ctx->builder, lhs, rhs, "band");
-    case TOKEN_PIPE:
-        // bitwise or
-        return LLVMBuildOr(ctx->builder, lhs, rhs, "bor");
-    case TOKEN_EQUAL_EQUAL:
-        return operands_are_float ? LLVMBuildFCmp(ctx->builder, LLVMRealOEQ, lhs, rhs, "feq") : LLVMBuildICmp(ctx->builder, LLVMIntEQ, lhs, rhs, "eq");
-    case TOKEN_BANG_EQUAL:
-        return operands_are_float ? LLVMBuildFCmp(ctx->builder, LLVMRealUNE, lhs, rhs, "fne") : LLVMBuildICmp(ctx->builder, LLVMIntNE, lhs, rhs, "ne");
-    case TOKEN_LESS:
-        return operands_are_float ? LLVMBuildFCmp(ctx->builder, LLVMRealOLT, lhs, rhs, "lt") : (is_signed ? LLVMBuildICmp(ctx->builder, LLVMIntSLT, lhs, rhs, "lt") : LLVMBuildICmp(ctx->builder, LLVMIntULT, lhs, rhs, "lt"));
-    case TOKEN_LESS_EQUAL:
-        return operands_are_float ? LLVMBuildFCmp(ctx->builder, LLVMRealOLE, lhs, rhs, "le") : (is_signed ? LLVMBuildICmp(ctx->builder, LLVMIntSLE, lhs, rhs, "le") : LLVMBuildICmp(ctx->builder, LLVMIntULE, lhs, rhs, "le"));
-    case TOKEN_GREATER:
-        return operands_are_float ? LLVMBuildFCmp(ctx->builder, LLVMRealOGT, lhs, rhs, "gt") : (is_signed ? LLVMBuildICmp(ctx->builder, LLVMIntSGT, lhs, rhs, "gt") : LLVMBuildICmp(ctx->builder, LLVMIntUGT, lhs, rhs, "gt"));
-    case TOKEN_GREATER_EQUAL:
-        return operands_are_float ? LLVMBuildFCmp(ctx->builder, LLVMRealOGE, lhs, rhs, "ge") : (is_signed ? LLVMBuildICmp(ctx->builder, LLVMIntSGE, lhs, rhs, "ge") : LLVMBuildICmp(ctx->builder, LLVMIntUGE, lhs, rhs, "ge"));
-    case TOKEN_AMPERSAND_AMPERSAND:
+        const char *name;
+        const char *intrinsic;
+    } ops[] = {
+        {"popcount", "llvm.ctpop"},
+        {"clz", "llvm.ctlz"},
+        {"ctz", "llvm.cttz"},
+        {"bswap", "llvm.bswap"},
+        {"rotl", "llvm.fshl"},
+        {"rotr", "llvm.fshr"},
+    };
+
+    const char *intrinsic = NULL;
+    for (size_t i = 0; i < sizeof(ops) / sizeof(ops[0]); i++)
     {
-        LLVMValueRef l1 = LLVMBuildICmp(ctx->builder, LLVMIntNE, lhs, LLVMConstNull(LLVMTypeOf(lhs)), "l1");
-        LLVMValueRef r1 = LLVMBuildICmp(ctx->builder, LLVMIntNE, rhs, LLVMConstNull(LLVMTypeOf(rhs)), "r1");
-        return LLVMBuildAnd(ctx->builder, l1, r1, "and");
+        if (strcmp(name, ops[i].name) == 0)
+            intrinsic = ops[i].intrinsic;
     }
-    case TOKEN_PIPE_PIPE:
-    case TOKEN_KW_OR:
+    if (!intrinsic)
+        return false;
+
+    LLVMValueRef value = codegen_intrinsic_operand(ctx, args[0]);
+    if (!value)
+        return true;
+
+    LLVMTypeRef  value_ty  = LLVMTypeOf(value);
+    LLVMValueRef params[3] = {value, NULL, NULL};
+    unsigned     count     = 1;
+    if (strcmp(name, "rotl") == 0 || strcmp(name, "rotr") == 0)
     {
-        LLVMValueRef l1 = LLVMBuildICmp(ctx->builder, LLVMIntNE, lhs, LLVMConstNull(LLVMTypeOf(lhs)), "l1");
-        LLVMValueRef r1 = LLVMBuildICmp(ctx->builder, LLVMIntNE, rhs, LLVMConstNull(LLVMTypeOf(rhs)), "r1");
-        return LLVMBuildOr(ctx->builder, l1, r1, "or");
+        // a rotate is a funnel shift of the value with itself; the count is taken modulo the width
+        LLVMValueRef amount = codegen_intrinsic_operand(ctx, args[1]);
+        if (!amount)
+            return true;
+        params[1] = value;
+        params[2] = LLVMBuildIntCast2(ctx->builder, amount, value_ty, type_is_signed(args[1]->type), "rot_amount");
+        count     = 3;
     }
-    case TOKEN_CARET:
-        return LLVMBuildXor(ctx->builder, lhs, rhs, "xor");
-    case TOKEN_LESS_LESS:
-        return LLVMBuildShl(ctx->builder, lhs, rhs, "shl");
-    case TOKEN_GREATER_GREATER:
-        return is_signed ? LLVMBuildAShr(ctx->builder, lhs, rhs, "shr") : LLVMBuildLShr(ctx->builder, lhs, rhs, "shr");
-        {
-        default:
-            codegen_error(ctx, expr, "unimplemented binary operator");
-            return NULL;
-        }
+    else if (strcmp(name, "clz") == 0 || strcmp(name, "ctz") == 0)
+    {
+        // zero is a defined input and yields the bit width
+        params[1] = LLVMConstInt(i1_ty, 0, false);
+        count     = 2;
     }
+
+    *out = codegen_call_intrinsic(ctx, intrinsic, &value_ty, 1, params, count, name);
+    return true;
 }
 
-LLVMValueRef codegen_expr_unary(CodegenContext *ctx, AstNode *expr)
+// returns true when name is a vec_* intrinsic; *out receives the value (NULL for vec_store)
+static bool codegen_vector_intrinsic(CodegenContext *ctx, AstNode *expr, const char *name, LLVMValueRef *out)
 {
-    LLVMValueRef operand = codegen_expr(ctx, expr->unary_expr.expr);
-    if (!operand)
+    AstList *args = expr->call_expr.args;
+    *out          = NULL;
+
+    if (strcmp(name, "vec_splat") == 0)
     {
-        codegen_error(ctx, expr, "failed to generate unary operand");
-        return NULL;
+        Type        *vector_type = type_resolve_alias(expr->type);
+        LLVMValueRef value       = codegen_intrinsic_operand(ctx, args->items[0]);
+        if (value)
+            *out = codegen_vector_splat(ctx, codegen_vector_lane(ctx, value, args->items[0]->type, vector_type), vector_type);
+        return true;
     }
 
-    switch (expr->unary_expr.op)
+    if (strcmp(name, "vec_load") == 0)
     {
-    case TOKEN_MINUS:
-        operand = codegen_load_if_needed(ctx, operand, expr->unary_expr.expr->type, expr->unary_expr.expr);
-        if (type_is_float(expr->type))
-        {
-            return LLVMBuildFNeg(ctx->builder, operand, "neg");
-        }
-        else
-        {
-            return LLVMBuildNeg(ctx->builder, operand, "neg");
-        }
-    case TOKEN_QUESTION: // address-of
-        return operand;
-    case TOKEN_AT: // dereference
-        // for dereference, we always need to load the pointer value first if it's in an alloca/global
-        if (LLVMIsAAllocaInst(operand) || LLVMIsAGlobalVariable(operand))
+        // unaligned: only the element alignment is assumed
+        Type        *vector_type = type_resolve_alias(expr->type);
+        LLVMValueRef ptr         = codegen_intrinsic_operand(ctx, args->items[0]);
+        if (!ptr)
+            return true;
+        LLVMValueRef load = LLVMBuildLoad2(ctx->builder, codegen_get_llvm_type(ctx, vector_type), ptr, "vload");
+        LLVMSetAlignment(load, (unsigned)type_alignof(vector_type->vector.elem_type));
+        *out = load;
+        return true;
+    }
+
+    if (strcmp(name, "vec_store") == 0)
+    {
+        Type        *vector_type = type_resolve_alias(args->items[1]->type);
+        LLVMValueRef ptr         = codegen_intrinsic_operand(ctx, args->items[0]);
+        LLVMValueRef value       = codegen_intrinsic_operand(ctx, args->items[1]);
+        if (!ptr || !value)
+            return true;
+        LLVMValueRef store = LLVMBuildStore(ctx->builder, value, ptr);
+        LLVMSetAlignment(store, (unsigned)type_alignof(vector_type->vector.elem_type));
+        return true;
+    }
+
+    if (strcmp(name, "vec_shuffle") == 0)
+    {
+        LLVMValueRef a = codegen_intrinsic_operand(ctx, args->items[0]);
+        LLVMValueRef b = codegen_intrinsic_operand(ctx, args->items[1]);
+        if (!a || !b)
+            return true;
+
+        unsigned      lanes  = (unsigned)(args->count - 2);
+        LLVMValueRef *mask   = malloc(sizeof(LLVMValueRef) * lanes);
+        LLVMTypeRef   i32_ty = LLVMInt32TypeInContext(ctx->context);
+        for (unsigned i = 0; i < lanes; i++)
         {
-            LLVMTypeRef ptr_type = codegen_get_llvm_type(ctx, expr->unary_expr.expr->type);
-            operand              = LLVMBuildLoad2(ctx->builder, ptr_type, operand, "");
+            mask[i] = LLVMConstInt(i32_ty, args->items[i + 2]->lit_expr.int_val, false);
         }
-        // then dereference the pointer
-        return LLVMBuildLoad2(ctx->builder, codegen_get_llvm_type(ctx, expr->type), operand, "deref");
-    case TOKEN_TILDE: // bitwise not
-        operand = codegen_load_if_needed(ctx, operand, expr->unary_expr.expr->type, expr->unary_expr.expr);
-        return LLVMBuildNot(ctx->builder, operand, "bnot");
-    default:
-        codegen_error(ctx, expr, "unimplemented unary operator");
-        return NULL;
+        *out = LLVMBuildShuffleVector(ctx->builder, a, b, LLVMConstVector(mask, lanes), "vshuffle");
+        free(mask);
+        return true;
+    }
+
+    if (strncmp(name, "vec_reduce_", 11) == 0)
+    {
+        AstNode     *arg    = args->items[0];
+        LLVMValueRef vector = codegen_intrinsic_operand(ctx, arg);
+        if (vector)
+            *out = codegen_vector_reduce(ctx, expr, name + 11, vector, type_resolve_alias(arg->type));
+        return true;
     }
+
+    return false;
 }
 
 LLVMValueRef codegen_expr_call(CodegenContext *ctx, AstNode *expr)
@@ -2367,16 +4126,18 @@ LLVMValueRef codegen_expr_call(CodegenContext *ctx, AstNode *expr)
             return ctx->current_vararg_count_value;
         }
 
-        if (strcmp(func_name, "va_arg") == 0)
+        // va_arg(i) points into the packed argument block; va_type(i) reads the argument's type tag
+        if (strcmp(func_name, "va_arg") == 0 || strcmp(func_name, "va_type") == 0)
         {
-            if (!ctx->current_vararg_array || !ctx->current_vararg_count_value)
+            bool is_type = func_name[3] == 't';
+            if (!ctx->current_vararg_desc || !ctx->current_vararg_count_value)
             {
-                codegen_error(ctx, expr, "va_arg used outside mach variadic function");
+                codegen_error(ctx, expr, "%s used outside mach variadic function", func_name);
                 return NULL;
             }
             if (!expr->call_expr.args || expr->call_expr.args->count != 1)
             {
-                codegen_error(ctx, expr, "va_arg() expects exactly one argument");
+                codegen_error(ctx, expr, "%s() expects exactly one argument", func_name);
                 return NULL;
             }
 
@@ -2384,7 +4145,7 @@ LLVMValueRef codegen_expr_call(CodegenContext *ctx, AstNode *expr)
             LLVMValueRef idx_val  = codegen_expr(ctx, idx_node);
             if (!idx_val)
             {
-                codegen_error(ctx, expr, "failed to generate va_arg index");
+                codegen_error(ctx, expr, "failed to generate %s index", func_name);
                 return NULL;
             }
             idx_val = codegen_load_if_needed(ctx, idx_val, idx_node->type, idx_node);
@@ -2403,42 +4164,27 @@ LLVMValueRef codegen_expr_call(CodegenContext *ctx, AstNode *expr)
                 }
                 else
                 {
-                    codegen_error(ctx, expr, "va_arg index must be integer");
+                    codegen_error(ctx, expr, "%s index must be integer", func_name);
                     return NULL;
                 }
             }
 
-            // add bounds checking for vararg access
-            LLVMBasicBlockRef bounds_fail_block = LLVMAppendBasicBlockInContext(ctx->context, ctx->current_function, "bounds_fail");
-            LLVMBasicBlockRef bounds_ok_block   = LLVMAppendBasicBlockInContext(ctx->context, ctx->current_function, "success");
-
             // check: index < 0 || index >= count
-            LLVMValueRef zero          = LLVMConstInt(i64_ty, 0, false);
-            LLVMValueRef is_negative   = LLVMBuildICmp(ctx->builder, LLVMIntSLT, idx_val, zero, "lt");
-            LLVMValueRef is_too_large  = LLVMBuildICmp(ctx->builder, LLVMIntSGE, idx_val, ctx->current_vararg_count_value, "ge");
-            LLVMValueRef out_of_bounds = LLVMBuildOr(ctx->builder, is_negative, is_too_large, "out_of_bounds");
+            codegen_emit_bounds_check(ctx, idx_val, true, ctx->current_vararg_count_value);
 
-            LLVMBuildCondBr(ctx->builder, out_of_bounds, bounds_fail_block, bounds_ok_block);
+            // bounds ok: read the {type tag, offset} descriptor entry
+            LLVMTypeRef  i32_ty     = LLVMInt32TypeInContext(ctx->context);
+            LLVMValueRef indices[2] = {idx_val, LLVMConstInt(i32_ty, is_type ? 0 : 1, false)};
+            LLVMValueRef field      = LLVMBuildInBoundsGEP2(ctx->builder, codegen_vararg_desc_type(ctx), ctx->current_vararg_desc, indices, 2, "mach_va_desc");
+            LLVMValueRef entry      = LLVMBuildLoad2(ctx->builder, i64_ty, field, is_type ? "mach_va_type" : "mach_va_offset");
 
-            // bounds fail: call abort
-            LLVMPositionBuilderAtEnd(ctx->builder, bounds_fail_block);
-            LLVMTypeRef  abort_type = LLVMFunctionType(LLVMVoidTypeInContext(ctx->context), NULL, 0, false);
-            LLVMValueRef abort_func = LLVMGetNamedFunction(ctx->module, "abort");
-            if (!abort_func)
-            {
-                abort_func = LLVMAddFunction(ctx->module, "abort", abort_type);
-            }
-            LLVMBuildCall2(ctx->builder, abort_type, abort_func, NULL, 0, "");
-            LLVMBuildUnreachable(ctx->builder);
+            unsigned invariant = LLVMGetMDKindIDInContext(ctx->context, "invariant.load", strlen("invariant.load"));
+            LLVMSetMetadata(entry, invariant, LLVMMetadataAsValue(ctx->context, LLVMMDNodeInContext2(ctx->context, NULL, 0)));
+            if (is_type)
+                return entry;
 
-            // bounds ok: proceed with vararg access
-            LLVMPositionBuilderAtEnd(ctx->builder, bounds_ok_block);
-            LLVMTypeRef  i8_ty      = LLVMInt8TypeInContext(ctx->context);
-            LLVMTypeRef  i8_ptr_ty  = LLVMPointerType(i8_ty, 0);
-            LLVMValueRef indices[1] = {idx_val};
-            LLVMValueRef slot       = LLVMBuildInBoundsGEP2(ctx->builder, i8_ptr_ty, ctx->current_vararg_array, indices, 1, "mach_va_slot");
-            LLVMValueRef value_ptr  = LLVMBuildLoad2(ctx->builder, i8_ptr_ty, slot, "mach_va_ptr");
-            return value_ptr;
+            LLVMValueRef offset[1] = {entry};
+            return LLVMBuildInBoundsGEP2(ctx->builder, LLVMInt8TypeInContext(ctx->context), ctx->current_vararg_data, offset, 1, "mach_va_ptr");
         }
 
         // handle size_of() intrinsic
@@ -2498,18 +4244,11 @@ LLVMValueRef codegen_expr_call(CodegenContext *ctx, AstNode *expr)
             size_t offset = 0;
             bool   found  = false;
 
-            if (struct_type->kind == TYPE_STRUCT && struct_type->composite.fields)
+            Symbol *field = struct_type->kind == TYPE_STRUCT ? type_find_field(struct_type, field_name) : NULL;
+            if (field)
             {
-                for (size_t i = 0; i < struct_type->composite.field_count; i++)
-                {
-                    Symbol *field = &struct_type->composite.fields[i];
-                    if (strcmp(field->name, field_name) == 0)
-                    {
-                        offset = field->field.offset;
-                        found  = true;
-                        break;
-                    }
-                }
+                offset = field->field.offset;
+                found  = true;
             }
 
             if (!found)
@@ -2531,18 +4270,41 @@ LLVMValueRef codegen_expr_call(CodegenContext *ctx, AstNode *expr)
                 return NULL;
             }
 
-            AstNode *arg      = expr->call_expr.args->items[0];
-            Type    *arg_type = type_resolve_alias(arg->type);
-
-            // generate a simple hash of the type for runtime identification
-            // this is a basic implementation - you could make it more sophisticated
-            uint64_t type_hash = (uint64_t)arg_type->kind;
-            type_hash          = type_hash * 31 + arg_type->size;
-            type_hash          = type_hash * 31 + arg_type->alignment;
+            AstNode *arg = expr->call_expr.args->items[0];
 
             expr->type = type_u64();
-            return LLVMConstInt(LLVMInt64TypeInContext(ctx->context), type_hash, false);
+            return LLVMConstInt(LLVMInt64TypeInContext(ctx->context), codegen_type_tag(arg->type), false);
+        }
+
+        // likely()/unlikely() outside an if/for condition still yield the hinted truth value
+        if (strcmp(func_name, "likely") == 0 || strcmp(func_name, "unlikely") == 0)
+        {
+            if (!expr->call_expr.args || expr->call_expr.args->count != 1)
+            {
+                codegen_error(ctx, expr, "%s() expects exactly one argument", func_name);
+                return NULL;
+            }
+
+            LLVMValueRef truth = codegen_branch_condition(ctx, expr, "hintcond");
+            if (!truth)
+                return NULL;
+            return LLVMBuildZExt(ctx->builder, truth, LLVMInt8TypeInContext(ctx->context), "hint");
+        }
+
+        // handle mem_copy()/mem_move()/mem_set() intrinsics
+        if (strcmp(func_name, "mem_copy") == 0 || strcmp(func_name, "mem_move") == 0 || strcmp(func_name, "mem_set") == 0)
+        {
+            codegen_memory_intrinsic(ctx, expr, func_name);
+            return NULL;
         }
+
+        LLVMValueRef intrinsic = NULL;
+        if (strncmp(func_name, "vec_", 4) == 0 && codegen_vector_intrinsic(ctx, expr, func_name, &intrinsic))
+            return intrinsic;
+        if ((strncmp(func_name, "atomic_", 7) == 0 || strcmp(func_name, "fence") == 0) && codegen_atomic_intrinsic(ctx, expr, func_name, &intrinsic))
+            return intrinsic;
+        if (codegen_bit_intrinsic(ctx, expr, func_name, &intrinsic))
+            return intrinsic;
     }
 
     Symbol *callee_symbol = expr->call_expr.func->symbol;
@@ -2612,7 +4374,7 @@ LLVMValueRef codegen_expr_call(CodegenContext *ctx, AstNode *expr)
 
     // account for varargs markers that will be skipped in actual arg emission
     int           actual_arg_count = arg_expr_count - varargs_markers;
-    int           total_args       = uses_mach_varargs ? (int)fixed_param_count + 2 : actual_arg_count;
+    int           total_args       = uses_mach_varargs ? (int)fixed_param_count + CODEGEN_MACH_VARARG_PARAMS : actual_arg_count;
     LLVMValueRef *args             = NULL;
     if (total_args > 0)
         args = malloc(sizeof(LLVMValueRef) * total_args);
@@ -2717,33 +4479,27 @@ LLVMValueRef codegen_expr_call(CodegenContext *ctx, AstNode *expr)
 
     if (uses_mach_varargs)
     {
-        LLVMTypeRef i64_ty     = LLVMInt64TypeInContext(ctx->context);
-        LLVMTypeRef i8_ty      = LLVMInt8TypeInContext(ctx->context);
-        LLVMTypeRef i8_ptr_ty  = LLVMPointerType(i8_ty, 0);
-        LLVMTypeRef i8_ptr_ptr = LLVMPointerType(i8_ptr_ty, 0);
+        LLVMTypeRef  i64_ty   = LLVMInt64TypeInContext(ctx->context);
+        LLVMValueRef null_ptr = LLVMConstNull(LLVMPointerTypeInContext(ctx->context, 0));
 
         if (forwards_varargs)
         {
-            LLVMValueRef count_val  = ctx->current_vararg_count_value ? ctx->current_vararg_count_value : LLVMConstInt(i64_ty, 0, false);
-            args[fixed_param_count] = count_val;
-
-            if (ctx->current_vararg_array)
-            {
-                args[fixed_param_count + 1] = ctx->current_vararg_array;
-            }
-            else
-            {
-                args[fixed_param_count + 1] = LLVMConstNull(i8_ptr_ptr);
-            }
+            args[fixed_param_count]     = ctx->current_vararg_count_value ? ctx->current_vararg_count_value : LLVMConstInt(i64_ty, 0, false);
+            args[fixed_param_count + 1] = ctx->current_vararg_data ? ctx->current_vararg_data : null_ptr;
+            args[fixed_param_count + 2] = ctx->current_vararg_desc ? ctx->current_vararg_desc : null_ptr;
         }
         else
         {
-            args[fixed_param_count] = LLVMConstInt(i64_ty, (unsigned long long)extra_arg_count, false);
+            args[fixed_param_count]     = LLVMConstInt(i64_ty, (unsigned long long)extra_arg_count, false);
+            args[fixed_param_count + 1] = null_ptr;
+            args[fixed_param_count + 2] = null_ptr;
 
             if (extra_arg_count > 0)
             {
-                LLVMValueRef count_val   = LLVMConstInt(i64_ty, (unsigned long long)extra_arg_count, false);
-                LLVMValueRef array_alloc = LLVMBuildArrayAlloca(ctx->builder, i8_ptr_ty, count_val, "mach_vararg_array");
+                // the argument types are known here, so the values share one struct-typed block
+                // and the descriptor is a constant; after inlining both fold away
+                LLVMValueRef *values = malloc(sizeof(LLVMValueRef) * extra_arg_count);
+                LLVMTypeRef  *types  = malloc(sizeof(LLVMTypeRef) * extra_arg_count);
 
                 for (int j = 0; j < extra_arg_count; j++)
                 {
@@ -2752,6 +4508,8 @@ LLVMValueRef codegen_expr_call(CodegenContext *ctx, AstNode *expr)
                     LLVMValueRef value    = codegen_expr(ctx, arg_node);
                     if (!value)
                     {
+                        free(values);
+                        free(types);
                         free(args);
                         codegen_error(ctx, expr, "failed to generate variadic argument %d", fixed_param_count + j);
                         return NULL;
@@ -2776,39 +4534,53 @@ LLVMValueRef codegen_expr_call(CodegenContext *ctx, AstNode *expr)
                         value = codegen_load_if_needed(ctx, value, arg_node->type, arg_node);
                     }
 
-                    LLVMValueRef stored_value = value;
-                    LLVMTypeRef  value_ty     = LLVMTypeOf(value);
-
+                    // small integers are widened so callees may read any integer argument as 64 bits
                     if (arg_type && type_is_integer(arg_type) && arg_type->size < 8)
                     {
                         if (type_is_signed(arg_type))
-                        {
-                            stored_value = LLVMBuildSExt(ctx->builder, value, i64_ty, "vararg_promote_signed");
-                            value_ty     = i64_ty;
-                        }
+                            value = LLVMBuildSExt(ctx->builder, value, i64_ty, "vararg_promote_signed");
                         else
-                        {
-                            stored_value = LLVMBuildZExt(ctx->builder, value, i64_ty, "vararg_promote_unsigned");
-                            value_ty     = i64_ty;
-                        }
+                            value = LLVMBuildZExt(ctx->builder, value, i64_ty, "vararg_promote_unsigned");
                     }
 
-                    char slot_name[32];
-                    snprintf(slot_name, sizeof(slot_name), "mach_vararg_val_%d", j);
-                    LLVMValueRef value_alloca = codegen_create_alloca(ctx, value_ty, slot_name);
-                    LLVMBuildStore(ctx->builder, stored_value, value_alloca);
-                    LLVMValueRef data_ptr = LLVMBuildBitCast(ctx->builder, value_alloca, i8_ptr_ty, "mach_vararg_cast");
+                    values[j] = value;
+                    types[j]  = LLVMTypeOf(value);
+                }
 
-                    LLVMValueRef idx_val = LLVMConstInt(i64_ty, (unsigned long long)j, false);
-                    LLVMValueRef slot    = LLVMBuildInBoundsGEP2(ctx->builder, i8_ptr_ty, array_alloc, &idx_val, 1, "mach_vararg_slot");
-                    LLVMBuildStore(ctx->builder, data_ptr, slot);
+                LLVMTypeRef   pack_ty = LLVMStructTypeInContext(ctx->context, types, (unsigned)extra_arg_count, false);
+                LLVMValueRef  pack    = codegen_create_alloca(ctx, pack_ty, "mach_vararg_pack");
+                LLVMTypeRef   desc_ty = codegen_vararg_desc_type(ctx);
+                LLVMValueRef *entries = malloc(sizeof(LLVMValueRef) * extra_arg_count);
+                for (int j = 0; j < extra_arg_count; j++)
+                {
+                    LLVMBuildStore(ctx->builder, values[j], LLVMBuildStructGEP2(ctx->builder, pack_ty, pack, (unsigned)j, "mach_vararg_slot"));
+
+                    AstNode     *arg_node  = expr->call_expr.args->items[fixed_param_count + j];
+                    LLVMValueRef fields[2] = {
+                        LLVMConstInt(i64_ty, codegen_type_tag(arg_node->type), false),
+                        LLVMConstInt(i64_ty, LLVMOffsetOfElement(ctx->data_layout, pack_ty, (unsigned)j), false),
+                    };
+                    entries[j] = LLVMConstStructInContext(ctx->context, fields, 2, false);
                 }
 
-                args[fixed_param_count + 1] = array_alloc;
-            }
-            else
-            {
-                args[fixed_param_count + 1] = LLVMConstNull(i8_ptr_ptr);
+                // call sites with the same argument types share one descriptor per module
+                LLVMValueRef init = LLVMConstArray(desc_ty, entries, (unsigned)extra_arg_count);
+                LLVMValueRef desc = NULL;
+                if (!query_lookup(&ctx->queries, QUERY_VARARG_DESC, init, (void **)&desc))
+                {
+                    desc = LLVMAddGlobal(ctx->module, LLVMTypeOf(init), "__mach_vararg_desc");
+                    LLVMSetInitializer(desc, init);
+                    LLVMSetGlobalConstant(desc, true);
+                    LLVMSetLinkage(desc, LLVMPrivateLinkage);
+                    LLVMSetUnnamedAddress(desc, LLVMGlobalUnnamedAddr);
+                    query_store(&ctx->queries, QUERY_VARARG_DESC, init, desc);
+                }
+
+                args[fixed_param_count + 1] = pack;
+                args[fixed_param_count + 2] = desc;
+                free(entries);
+                free(values);
+                free(types);
             }
         }
     }
@@ -2856,32 +4628,34 @@ LLVMValueRef codegen_expr_call(CodegenContext *ctx, AstNode *expr)
         }
     }
 
-    // build the actual function type for the call
-    LLVMTypeRef return_type = func_type->function.return_type ? codegen_get_llvm_type(ctx, func_type->function.return_type) : LLVMVoidTypeInContext(ctx->context);
-
-    size_t       llvm_param_count = fixed_param_count + (uses_mach_varargs ? 2 : 0);
-    LLVMTypeRef *param_types      = NULL;
-    if (llvm_param_count > 0)
+    // sret callees write their result into the destination reserved for this call,
+    // or into a temporary the caller then reads like any other aggregate in memory
+    LLVMValueRef sret_slot = NULL;
+    if (codegen_returns_sret(func_type))
     {
-        param_types = malloc(sizeof(LLVMTypeRef) * llvm_param_count);
-        for (size_t i = 0; i < fixed_param_count; i++)
-        {
-            param_types[i] = codegen_get_llvm_type(ctx, func_type->function.param_types[i]);
-        }
-        if (uses_mach_varargs)
-        {
-            LLVMTypeRef i64_ty                 = LLVMInt64TypeInContext(ctx->context);
-            LLVMTypeRef i8_ptr                 = LLVMPointerType(LLVMInt8TypeInContext(ctx->context), 0);
-            param_types[fixed_param_count]     = i64_ty;
-            param_types[fixed_param_count + 1] = LLVMPointerType(i8_ptr, 0);
-        }
+        sret_slot = codegen_take_result_slot(ctx, expr);
+        if (!sret_slot)
+            sret_slot = codegen_create_alloca(ctx, codegen_get_llvm_type(ctx, func_type->function.return_type), "sret_tmp");
+
+        LLVMValueRef *sret_args = malloc(sizeof(LLVMValueRef) * (total_args + 1));
+        sret_args[0]            = sret_slot;
+        if (total_args > 0)
+            memcpy(sret_args + 1, args, sizeof(LLVMValueRef) * total_args);
+        free(args);
+        args = sret_args;
+        total_args++;
     }
 
-    LLVMTypeRef  llvm_func_type = LLVMFunctionType(return_type, param_types, llvm_param_count, uses_mach_varargs ? false : func_type->function.is_variadic);
+    // build the actual function type for the call
+    LLVMTypeRef  llvm_func_type = codegen_function_llvm_type(ctx, func_type, uses_mach_varargs);
     LLVMValueRef result         = LLVMBuildCall2(ctx->builder, llvm_func_type, func, args, total_args, "");
 
-    free(param_types);
     free(args);
+    if (sret_slot)
+    {
+        LLVMAddCallSiteAttribute(result, 1, codegen_sret_attribute(ctx, func_type));
+        return sret_slot;
+    }
     return result;
 }
 
@@ -2920,6 +4694,12 @@ LLVMValueRef codegen_expr_cast(CodegenContext *ctx, AstNode *expr)
 
     LLVMTypeRef to_llvm_type = codegen_get_llvm_type(ctx, to_type);
 
+    // vectors only reinterpret bits between types of the same size
+    if (resolved_from_type->kind == TYPE_VECTOR || resolved_to_type->kind == TYPE_VECTOR)
+    {
+        return LLVMBuildBitCast(ctx->builder, value, to_llvm_type, "vec.bitcast");
+    }
+
     // numeric casts
     if (type_is_numeric(resolved_from_type) && type_is_numeric(resolved_to_type))
     {
@@ -3267,18 +5047,8 @@ LLVMValueRef codegen_expr_field(CodegenContext *ctx, AstNode *expr)
         object = tmp;
     }
 
-    // find the field
-    Symbol *field_symbol = NULL;
-    int     field_index  = 0;
-    for (Symbol *field = object_type->composite.fields; field; field = field->next)
-    {
-        if (field->name && strcmp(field->name, expr->field_expr.field) == 0)
-        {
-            field_symbol = field;
-            break;
-        }
-        field_index++;
-    }
+    // find the field; its index is the gep element index
+    Symbol *field_symbol = type_find_field(object_type, expr->field_expr.field);
 
     if (!field_symbol)
     {
@@ -3299,7 +5069,7 @@ LLVMValueRef codegen_expr_field(CodegenContext *ctx, AstNode *expr)
         return LLVMBuildBitCast(ctx->builder, storage_ptr, field_ptr_type, "union_field");
     }
 
-    LLVMValueRef indices[] = {LLVMConstInt(llvm_i32, 0, false), LLVMConstInt(llvm_i32, field_index, false)};
+    LLVMValueRef indices[] = {LLVMConstInt(llvm_i32, 0, false), LLVMConstInt(llvm_i32, field_symbol->field.index, false)};
 
     LLVMTypeRef struct_type = codegen_get_llvm_type(ctx, object_type);
     return LLVMBuildGEP2(ctx->builder, struct_type, object, indices, 2, "field");
@@ -3327,45 +5097,15 @@ LLVMValueRef codegen_expr_index(CodegenContext *ctx, AstNode *expr)
     {
         if (array_type->array.is_slice)
         {
-            // slice/fat pointer []T - runtime bounds checking
-            LLVMBasicBlockRef bounds_fail_block = LLVMAppendBasicBlockInContext(ctx->context, ctx->current_function, "bounds_fail");
-            LLVMBasicBlockRef bounds_ok_block   = LLVMAppendBasicBlockInContext(ctx->context, ctx->current_function, "bounds_ok");
-
-            // extract fat pointer fields
+            // slice/fat pointer []T - runtime bounds checking unless the analyser proved the access safe
             LLVMValueRef fat_ptr  = codegen_load_if_needed(ctx, array, array_type, expr->index_expr.array);
-            LLVMValueRef length   = LLVMBuildExtractValue(ctx->builder, fat_ptr, 1, "array_length");
             LLVMValueRef data_ptr = LLVMBuildExtractValue(ctx->builder, fat_ptr, 0, "array_data");
-
-            LLVMValueRef bounds_violated;
-            if (type_is_signed(expr->index_expr.index->type))
-            {
-                LLVMValueRef zero         = LLVMConstInt(LLVMTypeOf(index), 0, false);
-                LLVMValueRef is_negative  = LLVMBuildICmp(ctx->builder, LLVMIntSLT, index, zero, "is_negative");
-                LLVMValueRef index_ext    = LLVMBuildSExt(ctx->builder, index, LLVMTypeOf(length), "index_ext");
-                LLVMValueRef is_too_large = LLVMBuildICmp(ctx->builder, LLVMIntSGE, index_ext, length, "is_too_large");
-                bounds_violated           = LLVMBuildOr(ctx->builder, is_negative, is_too_large, "bounds_violated");
-            }
-            else
-            {
-                LLVMValueRef index_ext = LLVMBuildZExt(ctx->builder, index, LLVMTypeOf(length), "index_ext");
-                bounds_violated        = LLVMBuildICmp(ctx->builder, LLVMIntUGE, index_ext, length, "bounds_violated");
-            }
-
-            LLVMBuildCondBr(ctx->builder, bounds_violated, bounds_fail_block, bounds_ok_block);
-
-            // bounds fail: call abort
-            LLVMPositionBuilderAtEnd(ctx->builder, bounds_fail_block);
-            LLVMTypeRef  abort_type = LLVMFunctionType(LLVMVoidTypeInContext(ctx->context), NULL, 0, false);
-            LLVMValueRef abort_func = LLVMGetNamedFunction(ctx->module, "abort");
-            if (!abort_func)
+            if (!expr->index_expr.bounds_safe)
             {
-                abort_func = LLVMAddFunction(ctx->module, "abort", abort_type);
+                LLVMValueRef length = LLVMBuildExtractValue(ctx->builder, fat_ptr, 1, "array_length");
+                codegen_emit_bounds_check(ctx, index, type_is_signed(expr->index_expr.index->type), length);
             }
-            LLVMBuildCall2(ctx->builder, abort_type, abort_func, NULL, 0, "");
-            LLVMBuildUnreachable(ctx->builder);
 
-            // continue with bounds ok - do the actual indexing
-            LLVMPositionBuilderAtEnd(ctx->builder, bounds_ok_block);
             LLVMTypeRef elem_type = codegen_get_llvm_type(ctx, array_type->array.elem_type);
             return LLVMBuildGEP2(ctx->builder, elem_type, data_ptr, &index, 1, "index");
         }
@@ -3378,6 +5118,17 @@ LLVMValueRef codegen_expr_index(CodegenContext *ctx, AstNode *expr)
             return LLVMBuildGEP2(ctx->builder, codegen_get_llvm_type(ctx, array_type), array, indices, 2, "index");
         }
     }
+    else if (array_type->kind == TYPE_VECTOR)
+    {
+        // lanes of a vector in memory are addressable; vector values use extractelement
+        if (LLVMIsAAllocaInst(array) || LLVMIsAGlobalVariable(array) || LLVMIsAGetElementPtrInst(array))
+        {
+            LLVMValueRef zero       = LLVMConstInt(LLVMInt32TypeInContext(ctx->context), 0, false);
+            LLVMValueRef indices[2] = {zero, index};
+            return LLVMBuildGEP2(ctx->builder, codegen_get_llvm_type(ctx, array_type), array, indices, 2, "lane");
+        }
+        return LLVMBuildExtractElement(ctx->builder, array, index, "lane");
+    }
     else if (array_type->kind == TYPE_POINTER || array_type->kind == TYPE_PTR)
     {
         // pointer indexing - need to load the actual pointer value from the variable
@@ -3396,6 +5147,53 @@ LLVMValueRef codegen_expr_index(CodegenContext *ctx, AstNode *expr)
     }
 }
 
+// widen or narrow a scalar to the lane type; the analyser already checked assignability
+static LLVMValueRef codegen_vector_lane(CodegenContext *ctx, LLVMValueRef value, Type *from_type, Type *vector_type)
+{
+    LLVMTypeRef lane_ty = codegen_get_llvm_type(ctx, vector_type->vector.elem_type);
+    if (LLVMTypeOf(value) == lane_ty)
+        return value;
+
+    if (LLVMGetTypeKind(lane_ty) == LLVMIntegerTypeKind)
+        return LLVMBuildIntCast2(ctx->builder, value, lane_ty, type_is_signed(from_type), "lane.cast");
+    return LLVMBuildFPCast(ctx->builder, value, lane_ty, "lane.cast");
+}
+
+static LLVMValueRef codegen_vector_splat(CodegenContext *ctx, LLVMValueRef value, Type *vector_type)
+{
+    LLVMTypeRef  llvm_type = codegen_get_llvm_type(ctx, vector_type);
+    LLVMTypeRef  i32_ty    = LLVMInt32TypeInContext(ctx->context);
+    LLVMValueRef undef     = LLVMGetUndef(llvm_type);
+    LLVMValueRef lane0     = LLVMBuildInsertElement(ctx->builder, undef, value, LLVMConstInt(i32_ty, 0, false), "splat.lane");
+    LLVMValueRef mask      = LLVMConstNull(LLVMVectorType(i32_ty, (unsigned)vector_type->vector.count));
+    return LLVMBuildShuffleVector(ctx->builder, lane0, undef, mask, "splat");
+}
+
+// vector literals are built in registers: one element is splatted, otherwise lanes are inserted in order
+static LLVMValueRef codegen_expr_vector(CodegenContext *ctx, AstNode *expr, Type *vector_type)
+{
+    size_t       elem_count = expr->array_expr.elems ? (size_t)expr->array_expr.elems->count : 0;
+    LLVMTypeRef  i32_ty     = LLVMInt32TypeInContext(ctx->context);
+    LLVMValueRef vector     = LLVMGetUndef(codegen_get_llvm_type(ctx, vector_type));
+
+    for (size_t i = 0; i < elem_count; i++)
+    {
+        AstNode     *elem  = expr->array_expr.elems->items[i];
+        LLVMValueRef value = codegen_expr(ctx, elem);
+        if (!value)
+            return NULL;
+        value = codegen_load_if_needed(ctx, value, elem->type, elem);
+        value = codegen_vector_lane(ctx, value, elem->type, vector_type);
+
+        if (elem_count == 1)
+            return codegen_vector_splat(ctx, value, vector_type);
+
+        vector = LLVMBuildInsertElement(ctx->builder, vector, value, LLVMConstInt(i32_ty, i, false), "lane");
+    }
+
+    return vector;
+}
+
 LLVMValueRef codegen_expr_array(CodegenContext *ctx, AstNode *expr)
 {
     Type *array_type = expr->type;
@@ -3405,6 +5203,9 @@ LLVMValueRef codegen_expr_array(CodegenContext *ctx, AstNode *expr)
     if (!resolved_type)
         resolved_type = array_type;
 
+    if (resolved_type && resolved_type->kind == TYPE_VECTOR)
+        return codegen_expr_vector(ctx, expr, resolved_type);
+
     if (!resolved_type || resolved_type->kind != TYPE_ARRAY)
     {
         codegen_error(ctx, expr, "array literal has invalid type");
@@ -3657,8 +5458,10 @@ LLVMValueRef codegen_expr_struct(CodegenContext *ctx, AstNode *expr)
             return NULL;
         }
 
-        LLVMValueRef union_alloca = codegen_create_alloca(ctx, llvm_union_type, "union_lit");
-        LLVMBuildStore(ctx->builder, LLVMConstNull(llvm_union_type), union_alloca);
+        LLVMValueRef union_alloca = codegen_take_result_slot(ctx, expr);
+        if (!union_alloca)
+            union_alloca = codegen_create_alloca(ctx, llvm_union_type, "union_lit");
+        codegen_store_zero(ctx, union_alloca, struct_type, llvm_union_type);
 
         if (expr->struct_expr.fields && expr->struct_expr.fields->count > 0)
         {
@@ -3672,15 +5475,7 @@ LLVMValueRef codegen_expr_struct(CodegenContext *ctx, AstNode *expr)
             const char *field_name = field_init->field_expr.field;
             AstNode    *init_value = field_init->field_expr.object;
 
-            Symbol *field_symbol = NULL;
-            for (Symbol *field = struct_type->composite.fields; field; field = field->next)
-            {
-                if (field->name && strcmp(field->name, field_name) == 0)
-                {
-                    field_symbol = field;
-                    break;
-                }
-            }
+            Symbol *field_symbol = type_find_field(struct_type, field_name);
 
             if (!field_symbol)
             {
@@ -3712,11 +5507,13 @@ LLVMValueRef codegen_expr_struct(CodegenContext *ctx, AstNode *expr)
 
     LLVMTypeRef llvm_struct_type = codegen_get_llvm_type(ctx, struct_type);
 
-    // create a temporary alloca for the struct
-    LLVMValueRef struct_alloca = codegen_create_alloca(ctx, llvm_struct_type, "struct_lit");
+    // build into the reserved destination, or a temporary alloca for the struct
+    LLVMValueRef struct_alloca = codegen_take_result_slot(ctx, expr);
+    if (!struct_alloca)
+        struct_alloca = codegen_create_alloca(ctx, llvm_struct_type, "struct_lit");
 
     // initialize to zero
-    LLVMBuildStore(ctx->builder, LLVMConstNull(llvm_struct_type), struct_alloca);
+    codegen_store_zero(ctx, struct_alloca, struct_type, llvm_struct_type);
 
     // process field initializers if any
     if (expr->struct_expr.fields && expr->struct_expr.fields->count > 0)
@@ -3732,17 +5529,7 @@ LLVMValueRef codegen_expr_struct(CodegenContext *ctx, AstNode *expr)
                 AstNode    *init_value = field_init->field_expr.object;
 
                 // find the field
-                Symbol *field_symbol = NULL;
-                int     field_index  = 0;
-                for (Symbol *field = struct_type->composite.fields; field; field = field->next)
-                {
-                    if (field->name && strcmp(field->name, field_name) == 0)
-                    {
-                        field_symbol = field;
-                        break;
-                    }
-                    field_index++;
-                }
+                Symbol *field_symbol = type_find_field(struct_type, field_name);
 
                 if (!field_symbol)
                 {
@@ -3758,13 +5545,15 @@ LLVMValueRef codegen_expr_struct(CodegenContext *ctx, AstNode *expr)
                     return NULL;
                 }
 
-                value = codegen_load_if_needed(ctx, value, init_value->type, init_value);
-
                 // generate GEP for field and store
-                LLVMValueRef indices[] = {LLVMConstInt(LLVMInt32TypeInContext(ctx->context), 0, false), LLVMConstInt(LLVMInt32TypeInContext(ctx->context), field_index, false)};
+                LLVMValueRef indices[] = {LLVMConstInt(LLVMInt32TypeInContext(ctx->context), 0, false), LLVMConstInt(LLVMInt32TypeInContext(ctx->context), field_symbol->field.index, false)};
 
                 LLVMValueRef field_ptr = LLVMBuildGEP2(ctx->builder, llvm_struct_type, struct_alloca, indices, 2, "field_ptr");
-                LLVMBuildStore(ctx->builder, value, field_ptr);
+                if (!codegen_copy_aggregate(ctx, field_ptr, value, field_symbol->type))
+                {
+                    value = codegen_load_if_needed(ctx, value, init_value->type, init_value);
+                    LLVMBuildStore(ctx->builder, value, field_ptr);
+                }
             }
         }
     }
@@ -10,18 +10,25 @@ void mach_print_usage(const char *program_name)
     fprintf(stderr, "usage: %s build <file> [options]\n", program_name);
     fprintf(stderr, "options:\n");
     fprintf(stderr, "  -o <file>     set output file name\n");
-    fprintf(stderr, "  -O<level>     optimization level (0-3, default: 2)\n");
+    fprintf(stderr, "  -O<level>     optimization level (0-3, s, z; default: 2)\n");
+    fprintf(stderr, "  --passes=<p>  run a custom llvm pass pipeline instead of default<O*>\n");
+    fprintf(stderr, "  --profile-generate    instrument for profile-guided optimization\n");
+    fprintf(stderr, "  --profile-use=<file>  optimize using an indexed profile (.profdata)\n");
+    fprintf(stderr, "  --bounds-checks=<mode> slice bounds checks: full, loops, off (default: loops)\n");
     fprintf(stderr, "  --emit-obj    emit object file (.o file)\n");
     fprintf(stderr, "  --emit-ast[=<file>]  dump parsed AST for debugging\n");
     fprintf(stderr, "  --emit-ir[=<file>]   dump LLVM IR\n");
     fprintf(stderr, "  --emit-asm[=<file>]  dump target assembly\n");
     fprintf(stderr, "  --no-link     don't create executable (just compile)\n");
     fprintf(stderr, "  --no-pie      disable position independent executable\n");
+    fprintf(stderr, "  -mcpu=<cpu>   target cpu (e.g. x86-64-v3, native; default: host)\n");
+    fprintf(stderr, "  -mattr=<list> target features (e.g. +avx2,-sse4.2)\n");
     fprintf(stderr, "  --link <obj>  link with additional object file\n");
     fprintf(stderr, "  -g, --debug   include debug info (default)\n");
     fprintf(stderr, "  --no-debug    disable debug info\n");
     fprintf(stderr, "  -I <dir>      add module search directory\n");
     fprintf(stderr, "  -M n=dir      map module prefix 'n' to base directory 'dir'\n");
+    fprintf(stderr, "  -v, --verbose report codegen statistics\n");
 }
 
 int mach_cmd_build(int argc, char **argv)
@@ -49,9 +56,15 @@ int mach_cmd_build(int argc, char **argv)
                 return 1;
             }
         }
+        else if (strcmp(argv[i], "-Os") == 0 || strcmp(argv[i], "-Oz") == 0)
+        {
+            opts.opt_level  = 2;
+            opts.size_level = argv[i][2] == 's' ? 1 : 2;
+        }
         else if (strncmp(argv[i], "-O", 2) == 0)
         {
-            opts.opt_level = atoi(argv[i] + 2);
+            opts.opt_level  = atoi(argv[i] + 2);
+            opts.size_level = 0;
             if (opts.opt_level < 0 || opts.opt_level > 3)
             {
                 fprintf(stderr, "error: invalid optimization level\n");
@@ -59,6 +72,46 @@ int mach_cmd_build(int argc, char **argv)
                 return 1;
             }
         }
+        else if (strncmp(argv[i], "--passes=", 9) == 0)
+        {
+            opts.passes = argv[i] + 9;
+            if (opts.passes[0] == '\0')
+            {
+                fprintf(stderr, "error: --passes requires a pipeline\n");
+                build_options_dnit(&opts);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--profile-generate") == 0)
+        {
+            opts.profile_generate = 1;
+        }
+        else if (strncmp(argv[i], "--profile-use=", 14) == 0)
+        {
+            opts.profile_use = argv[i] + 14;
+            if (opts.profile_use[0] == '\0')
+            {
+                fprintf(stderr, "error: --profile-use requires a profile file\n");
+                build_options_dnit(&opts);
+                return 1;
+            }
+        }
+        else if (strncmp(argv[i], "--bounds-checks=", 16) == 0)
+        {
+            const char *mode = argv[i] + 16;
+            if (strcmp(mode, "full") == 0)
+                opts.bounds_checks = BOUNDS_CHECKS_FULL;
+            else if (strcmp(mode, "loops") == 0)
+                opts.bounds_checks = BOUNDS_CHECKS_LOOPS;
+            else if (strcmp(mode, "off") == 0)
+                opts.bounds_checks = BOUNDS_CHECKS_OFF;
+            else
+            {
+                fprintf(stderr, "error: invalid bounds check mode '%s' (expected full, loops or off)\n", mode);
+                build_options_dnit(&opts);
+                return 1;
+            }
+        }
         else if (strcmp(argv[i], "--emit-obj") == 0)
         {
             opts.link_exe = 0;
@@ -89,6 +142,20 @@ int mach_cmd_build(int argc, char **argv)
         {
             opts.no_pie = 1;
         }
+        else if (strncmp(argv[i], "-mcpu=", 6) == 0)
+        {
+            opts.target_cpu = argv[i] + 6;
+            if (opts.target_cpu[0] == '\0')
+            {
+                fprintf(stderr, "error: -mcpu requires a cpu name\n");
+                build_options_dnit(&opts);
+                return 1;
+            }
+        }
+        else if (strncmp(argv[i], "-mattr=", 7) == 0)
+        {
+            opts.target_features = argv[i] + 7;
+        }
         else if (strcmp(argv[i], "-g") == 0 || strcmp(argv[i], "--debug") == 0)
         {
             opts.debug_info = 1;
@@ -97,6 +164,10 @@ int mach_cmd_build(int argc, char **argv)
         {
             opts.debug_info = 0;
         }
+        else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0)
+        {
+            opts.verbose = 1;
+        }
         else if (strcmp(argv[i], "--link") == 0)
         {
             if (i + 1 < argc)
@@ -151,6 +222,13 @@ int mach_cmd_build(int argc, char **argv)
         }
     }
 
+    if (opts.profile_generate && opts.profile_use)
+    {
+        fprintf(stderr, "error: --profile-generate and --profile-use are mutually exclusive\n");
+        build_options_dnit(&opts);
+        return 1;
+    }
+
     CompilationContext ctx;
     if (!compilation_context_init(&ctx, &opts))
     {
@@ -160,8 +238,12 @@ int mach_cmd_build(int argc, char **argv)
 
     bool success = compilation_run(&ctx);
 
+    // the process ends right after a build, so release builds leave reclaiming memory to the os;
+    // debug builds still tear everything down to keep leak checkers quiet
+#ifdef DEBUG
     compilation_context_dnit(&ctx);
     build_options_dnit(&opts);
+#endif
 
     return success ? 0 : 1;
 }
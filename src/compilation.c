@@ -74,9 +74,11 @@ static void alias_vec_dnit(AliasVec *v)
 void build_options_init(BuildOptions *opts)
 {
     memset(opts, 0, sizeof(BuildOptions));
-    opts->opt_level  = 2;
-    opts->link_exe   = 1;
-    opts->debug_info = 1;
+    opts->opt_level     = -1;
+    opts->size_level    = -1;
+    opts->bounds_checks = BOUNDS_CHECKS_LOOPS;
+    opts->link_exe      = 1;
+    opts->debug_info    = 1;
 }
 
 void build_options_dnit(BuildOptions *opts)
@@ -168,6 +170,7 @@ bool compilation_context_init(CompilationContext *ctx, BuildOptions *opts)
         fprintf(stderr, "error: failed to create semantic driver\n");
         return false;
     }
+    ctx->driver->bounds_checks = opts->bounds_checks;
     return true;
 }
 
@@ -205,6 +208,52 @@ void compilation_context_dnit(CompilationContext *ctx)
     memset(ctx, 0, sizeof(CompilationContext));
 }
 
+// merge optimization settings: command line first, then the active target, then defaults
+static bool compilation_resolve_pipeline(CompilationContext *ctx)
+{
+    BuildOptions *opts   = ctx->options;
+    TargetConfig *target = ctx->config ? config_get_default_target(ctx->config) : NULL;
+
+    codegen_pipeline_init(&ctx->pipeline);
+
+    if (target)
+    {
+        if (target->opt_level < 0 || target->opt_level > 3)
+        {
+            fprintf(stderr, "error: invalid opt-level for target '%s'\n", target->name);
+            return false;
+        }
+        if (opts->opt_level < 0)
+        {
+            opts->opt_level  = target->opt_level;
+            opts->size_level = opts->size_level < 0 ? target->size_level : opts->size_level;
+        }
+        ctx->pipeline.passes           = target->passes;
+        ctx->pipeline.loop_vectorize   = target->loop_vectorize;
+        ctx->pipeline.slp_vectorize    = target->slp_vectorize;
+        ctx->pipeline.loop_unroll      = target->unroll_loops;
+        ctx->pipeline.inline_threshold = target->inline_threshold;
+    }
+
+    if (opts->opt_level < 0)
+        opts->opt_level = 2;
+    if (opts->size_level < 0)
+        opts->size_level = 0;
+    if (opts->passes)
+        ctx->pipeline.passes = opts->passes;
+    ctx->pipeline.size_level = opts->size_level;
+
+    if (opts->profile_use && !fs_file_exists(opts->profile_use))
+    {
+        fprintf(stderr, "error: profile file '%s' not found\n", opts->profile_use);
+        return false;
+    }
+    ctx->pipeline.profile_generate = opts->profile_generate;
+    ctx->pipeline.profile_use      = opts->profile_use;
+
+    return true;
+}
+
 bool compilation_load_and_preprocess(CompilationContext *ctx)
 {
     ctx->project_root = fs_find_project_root(ctx->options->input_file);
@@ -220,6 +269,11 @@ bool compilation_load_and_preprocess(CompilationContext *ctx)
         module_manager_set_config(&ctx->driver->module_manager, ctx->config, ctx->project_root);
     }
 
+    if (!compilation_resolve_pipeline(ctx))
+        return false;
+
+    module_manager_set_target_cpu(&ctx->driver->module_manager, ctx->options->target_cpu, ctx->options->target_features);
+
     for (int i = 0; i < ctx->options->include_paths.count; i++)
         module_manager_add_search_path(&ctx->driver->module_manager, ctx->options->include_paths.items[i]);
 
@@ -233,7 +287,7 @@ bool compilation_load_and_preprocess(CompilationContext *ctx)
         return false;
     }
 
-    PreprocessorConstant constants[32];
+    PreprocessorConstant constants[PREPROCESSOR_MAX_CONSTANTS];
     size_t               constant_count = module_manager_collect_constants(&ctx->driver->module_manager, constants, sizeof(constants) / sizeof(constants[0]));
 
     PreprocessorOutput pp_output;
@@ -293,13 +347,19 @@ bool compilation_codegen(CompilationContext *ctx)
 {
     const char *semantic_module_name = ctx->module_name ? ctx->module_name : ctx->options->input_file;
 
-    codegen_context_init(&ctx->codegen, semantic_module_name, ctx->options->no_pie);
-    ctx->codegen_initialized  = true;
-    ctx->codegen.opt_level    = ctx->options->opt_level;
-    ctx->codegen.debug_info   = ctx->options->debug_info;
-    ctx->codegen.source_file  = ctx->options->input_file;
-    ctx->codegen.source_lexer = &ctx->lexer;
-    ctx->codegen.spec_cache   = &ctx->driver->spec_cache;
+    ModuleManager *manager = &ctx->driver->module_manager;
+    codegen_context_init(&ctx->codegen, semantic_module_name, manager->target_triple, manager->target_cpu, manager->target_feats, ctx->options->no_pie);
+    ctx->codegen_initialized       = true;
+    ctx->codegen.opt_level         = ctx->options->opt_level;
+    ctx->codegen.pipeline          = ctx->pipeline;
+    ctx->codegen.emit_profile_hook = true;
+    ctx->codegen.is_entry_module   = true;
+    ctx->codegen.verbose           = ctx->options->verbose;
+    ctx->codegen.debug_info        = ctx->options->debug_info;
+    ctx->codegen.source_file       = ctx->options->input_file;
+    ctx->codegen.source_lexer      = &ctx->lexer;
+    ctx->codegen.spec_cache        = &ctx->driver->spec_cache;
+    ctx->codegen.prune_unreachable = manager->prune_unreachable;
 
     if (!codegen_generate(&ctx->codegen, ctx->ast, &ctx->driver->symbol_table))
     {
@@ -429,7 +489,8 @@ bool compilation_compile_dependencies(CompilationContext *ctx)
     snprintf(dep_out_dir, sizeof(dep_out_dir), "%s/out/obj", ctx->project_root);
     fs_ensure_dir_recursive(dep_out_dir);
 
-    if (!module_manager_compile_dependencies(&ctx->driver->module_manager, dep_out_dir, ctx->options->opt_level, ctx->options->no_pie, ctx->options->debug_info, &ctx->driver->spec_cache))
+    ctx->driver->module_manager.verbose = ctx->options->verbose;
+    if (!module_manager_compile_dependencies(&ctx->driver->module_manager, dep_out_dir, ctx->options->opt_level, &ctx->pipeline, ctx->options->no_pie, ctx->options->debug_info, &ctx->driver->spec_cache))
     {
         fprintf(stderr, "error: failed to compile dependencies\n");
         return false;
@@ -480,13 +541,17 @@ bool compilation_link(CompilationContext *ctx)
         return false;
     }
 
-    strcpy(cmd, "cc -nostartfiles -nostdlib");
+    // the profile runtime and -fprofile-instr-generate are clang's, so instrumented builds link with clang
+    strcpy(cmd, ctx->options->profile_generate ? "clang" : "cc");
+    strcat(cmd, " -nostartfiles -nostdlib");
     if (ctx->options->no_pie)
         strcat(cmd, " -no-pie");
     else
         strcat(cmd, " -pie");
     if (ctx->options->debug_info)
         strcat(cmd, " -g");
+    if (ctx->options->profile_generate)
+        strcat(cmd, " -fprofile-instr-generate -lc"); // profile runtime needs libc
     strcat(cmd, " -o ");
     strcat(cmd, exe);
     strcat(cmd, " ");
@@ -507,6 +572,8 @@ bool compilation_link(CompilationContext *ctx)
     if (result != 0)
     {
         fprintf(stderr, "error: failed to link executable '%s'\n", exe);
+        if (ctx->options->profile_generate)
+            fprintf(stderr, "note: --profile-generate links with clang, which must be on PATH\n");
         free(cmd);
         free(exe);
         return false;
@@ -517,6 +584,30 @@ bool compilation_link(CompilationContext *ctx)
     return true;
 }
 
+// once the entry object is written, drop its llvm module, lexer and function bodies so dependency
+// codegen does not run on top of them. this trims the codegen tail only: every module was analysed
+// before any object was emitted (reachability, effects and specializations are whole-program),
+// so the analysis peak still holds all modules at once
+static void compilation_release_entry(CompilationContext *ctx)
+{
+    if (ctx->codegen_initialized)
+    {
+        codegen_context_dnit(&ctx->codegen);
+        ctx->codegen_initialized = false;
+    }
+    if (ctx->parser_initialized)
+    {
+        parser_dnit(&ctx->parser);
+        ctx->parser_initialized = false;
+    }
+    if (ctx->lexer_initialized)
+    {
+        lexer_dnit(&ctx->lexer);
+        ctx->lexer_initialized = false;
+    }
+    ast_release_bodies(ctx->ast);
+}
+
 bool compilation_run(CompilationContext *ctx)
 {
     if (!compilation_load_and_preprocess(ctx))
@@ -534,6 +625,8 @@ bool compilation_run(CompilationContext *ctx)
     if (!compilation_emit_artifacts(ctx))
         return false;
 
+    compilation_release_entry(ctx);
+
     if (!compilation_compile_dependencies(ctx))
         return false;
 
@@ -0,0 +1,1480 @@
+#include "comptime.h"
+#include "token.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// growable byte region; an address is base + offset
+typedef struct CtRegion
+{
+    uint8_t *data;
+    size_t   size;
+    size_t   capacity;
+    uint64_t base;
+} CtRegion;
+
+typedef struct CtBinding
+{
+    Symbol  *symbol;
+    uint64_t addr;
+} CtBinding;
+
+// one active mach call
+typedef struct CtFrame
+{
+    Symbol    *function;
+    CtBinding *locals;
+    size_t     local_count;
+    size_t     local_capacity;
+    uint64_t  *params;
+    size_t     param_count;
+    uint64_t   result; // slot 'ret' stores into
+    Type      *result_type;
+} CtFrame;
+
+// global val evaluated on first use
+typedef struct CtGlobal
+{
+    Symbol  *symbol;
+    uint64_t addr;
+    bool     ready;
+} CtGlobal;
+
+typedef enum CtFlow
+{
+    CT_NEXT,
+    CT_BREAK,
+    CT_CONTINUE,
+    CT_RETURN,
+    CT_ERROR,
+} CtFlow;
+
+typedef struct Ct
+{
+    ComptimeLimits limits;
+    uint64_t       steps;
+    CtRegion       stack;   // locals and temporaries, released per statement and block
+    CtRegion       statics; // string and array literal storage, kept for the result
+    ComptimeAlloc *allocs;
+    size_t         alloc_count;
+    size_t         alloc_capacity;
+    CtGlobal      *globals;
+    size_t         global_count;
+    size_t         global_capacity;
+    Symbol       **functions;
+    size_t         function_count;
+    size_t         function_capacity;
+    CtFrame       *frame;
+    int            depth;
+    ComptimeError *error;
+    bool           failed;
+} Ct;
+
+static bool   ct_eval(Ct *ct, AstNode *expr, uint64_t *out);
+static CtFlow ct_exec(Ct *ct, AstNode *stmt);
+
+ComptimeLimits comptime_default_limits(void)
+{
+    ComptimeLimits limits = {COMPTIME_DEFAULT_FUEL, COMPTIME_DEFAULT_MEMORY, COMPTIME_MAX_DEPTH};
+    return limits;
+}
+
+// records the first failure; always returns false so callers can unwind with it
+static bool ct_fail(Ct *ct, AstNode *node, const char *fmt, ...)
+{
+    if (ct->failed)
+        return false;
+
+    ct->failed          = true;
+    ct->error->node     = node;
+    ct->error->function = ct->frame ? ct->frame->function : NULL;
+
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(ct->error->message, sizeof(ct->error->message), fmt, args);
+    va_end(args);
+    return false;
+}
+
+static bool ct_step(Ct *ct, AstNode *node)
+{
+    if (++ct->steps <= ct->limits.fuel)
+        return true;
+    return ct_fail(ct, node, "compile-time evaluation ran out of fuel after %llu steps", (unsigned long long)ct->limits.fuel);
+}
+
+static Symbol *ct_origin(Symbol *symbol)
+{
+    while (symbol && symbol->import_origin && symbol->import_origin != symbol)
+        symbol = symbol->import_origin;
+    return symbol;
+}
+
+static size_t ct_sizeof(Type *type)
+{
+    Type *resolved = type_resolve_alias(type);
+    return resolved ? type_sizeof(resolved) : 0;
+}
+
+// memory
+
+static bool ct_alloc(Ct *ct, CtRegion *region, size_t size, size_t align, AstNode *node, uint64_t *out)
+{
+    if (align == 0)
+        align = 1;
+
+    size_t offset = (region->size + align - 1) / align * align;
+    size_t end    = offset + size;
+    if (ct->stack.size + ct->statics.size + (end - region->size) > ct->limits.memory)
+        return ct_fail(ct, node, "compile-time evaluation exceeded its memory limit of %zu bytes", ct->limits.memory);
+
+    if (end > region->capacity)
+    {
+        size_t capacity = region->capacity ? region->capacity * 2 : 4096;
+        while (capacity < end)
+            capacity *= 2;
+
+        uint8_t *data = realloc(region->data, capacity);
+        if (!data)
+            return ct_fail(ct, node, "out of memory during compile-time evaluation");
+        region->data     = data;
+        region->capacity = capacity;
+    }
+
+    memset(region->data + region->size, 0, end - region->size);
+    region->size = end;
+    *out         = region->base + offset;
+    return true;
+}
+
+static bool ct_alloc_static(Ct *ct, size_t size, size_t align, AstNode *node, uint64_t *out)
+{
+    if (!ct_alloc(ct, &ct->statics, size, align, node, out))
+        return false;
+
+    if (ct->alloc_count >= ct->alloc_capacity)
+    {
+        size_t         capacity = ct->alloc_capacity ? ct->alloc_capacity * 2 : 16;
+        ComptimeAlloc *allocs   = realloc(ct->allocs, capacity * sizeof(ComptimeAlloc));
+        if (!allocs)
+            return ct_fail(ct, node, "out of memory during compile-time evaluation");
+        ct->allocs         = allocs;
+        ct->alloc_capacity = capacity;
+    }
+
+    ct->allocs[ct->alloc_count].addr = *out;
+    ct->allocs[ct->alloc_count].size = size;
+    ct->alloc_count++;
+    return true;
+}
+
+// temporary on the stack region holding a value of type
+static bool ct_temp(Ct *ct, Type *type, AstNode *node, uint64_t *out)
+{
+    Type *resolved = type_resolve_alias(type);
+    if (!resolved)
+        return ct_fail(ct, node, "expression has no type at compile time");
+    return ct_alloc(ct, &ct->stack, type_sizeof(resolved), type_alignof(resolved), node, out);
+}
+
+// host pointer for size bytes at addr; never kept across an allocation
+static uint8_t *ct_memory(Ct *ct, uint64_t addr, size_t size, AstNode *node)
+{
+    CtRegion *regions[2] = {&ct->stack, &ct->statics};
+    for (int i = 0; i < 2; i++)
+    {
+        CtRegion *region = regions[i];
+        if (addr >= region->base && addr - region->base <= region->size && size <= region->size - (addr - region->base))
+            return region->data + (addr - region->base);
+    }
+
+    if (addr == 0)
+        ct_fail(ct, node, "nil dereference at compile time");
+    else
+        ct_fail(ct, node, "invalid memory access at compile time");
+    return NULL;
+}
+
+static bool ct_copy(Ct *ct, uint64_t dst, uint64_t src, size_t size, AstNode *node)
+{
+    uint8_t *from = ct_memory(ct, src, size, node);
+    uint8_t *to   = from ? ct_memory(ct, dst, size, node) : NULL;
+    if (!to)
+        return false;
+    memmove(to, from, size);
+    return true;
+}
+
+static bool ct_load_bits(Ct *ct, uint64_t addr, size_t size, AstNode *node, uint64_t *out)
+{
+    uint8_t *p = ct_memory(ct, addr, size, node);
+    if (!p)
+        return false;
+
+    switch (size)
+    {
+    case 1:
+        *out = p[0];
+        return true;
+    case 2:
+    {
+        uint16_t v;
+        memcpy(&v, p, 2);
+        *out = v;
+        return true;
+    }
+    case 4:
+    {
+        uint32_t v;
+        memcpy(&v, p, 4);
+        *out = v;
+        return true;
+    }
+    case 8:
+        memcpy(out, p, 8);
+        return true;
+    default:
+        return ct_fail(ct, node, "unsupported scalar size %zu at compile time", size);
+    }
+}
+
+static bool ct_store_bits(Ct *ct, uint64_t addr, size_t size, uint64_t value, AstNode *node)
+{
+    uint8_t *p = ct_memory(ct, addr, size, node);
+    if (!p)
+        return false;
+
+    switch (size)
+    {
+    case 1:
+        p[0] = (uint8_t)value;
+        return true;
+    case 2:
+    {
+        uint16_t v = (uint16_t)value;
+        memcpy(p, &v, 2);
+        return true;
+    }
+    case 4:
+    {
+        uint32_t v = (uint32_t)value;
+        memcpy(p, &v, 4);
+        return true;
+    }
+    case 8:
+        memcpy(p, &value, 8);
+        return true;
+    default:
+        return ct_fail(ct, node, "unsupported scalar size %zu at compile time", size);
+    }
+}
+
+static uint64_t ct_extend(uint64_t bits, size_t size, bool is_signed)
+{
+    if (size >= 8)
+        return bits;
+
+    unsigned width = (unsigned)size * 8;
+    bits &= (1ULL << width) - 1ULL;
+    if (is_signed && (bits >> (width - 1)) & 1ULL)
+        bits |= ~((1ULL << width) - 1ULL);
+    return bits;
+}
+
+// integers, booleans and pointers, extended to 64 bits by the type's signedness
+static bool ct_load_int(Ct *ct, uint64_t addr, Type *type, AstNode *node, uint64_t *out)
+{
+    Type  *resolved = type_resolve_alias(type);
+    size_t size     = resolved ? type_sizeof(resolved) : 0;
+    if (!ct_load_bits(ct, addr, size, node, out))
+        return false;
+    *out = ct_extend(*out, size, type_is_signed(resolved));
+    return true;
+}
+
+static bool ct_store_int(Ct *ct, uint64_t addr, Type *type, uint64_t value, AstNode *node)
+{
+    return ct_store_bits(ct, addr, ct_sizeof(type), value, node);
+}
+
+static bool ct_load_float(Ct *ct, uint64_t addr, Type *type, AstNode *node, double *out)
+{
+    Type    *resolved = type_resolve_alias(type);
+    uint8_t *p        = NULL;
+    switch (resolved->kind)
+    {
+    case TYPE_F32:
+    {
+        float v;
+        if (!(p = ct_memory(ct, addr, sizeof(v), node)))
+            return false;
+        memcpy(&v, p, sizeof(v));
+        *out = v;
+        return true;
+    }
+    case TYPE_F64:
+        if (!(p = ct_memory(ct, addr, sizeof(*out), node)))
+            return false;
+        memcpy(out, p, sizeof(*out));
+        return true;
+    default:
+        return ct_fail(ct, node, "f16 arithmetic is not supported at compile time");
+    }
+}
+
+static bool ct_store_float(Ct *ct, uint64_t addr, Type *type, double value, AstNode *node)
+{
+    Type    *resolved = type_resolve_alias(type);
+    uint8_t *p        = NULL;
+    switch (resolved->kind)
+    {
+    case TYPE_F32:
+    {
+        float v = (float)value;
+        if (!(p = ct_memory(ct, addr, sizeof(v), node)))
+            return false;
+        memcpy(p, &v, sizeof(v));
+        return true;
+    }
+    case TYPE_F64:
+        if (!(p = ct_memory(ct, addr, sizeof(value), node)))
+            return false;
+        memcpy(p, &value, sizeof(value));
+        return true;
+    default:
+        return ct_fail(ct, node, "f16 arithmetic is not supported at compile time");
+    }
+}
+
+static bool ct_is_scalar(Type *type)
+{
+    return type_is_integer(type) || type_is_pointer_like(type);
+}
+
+// any numeric or pointer value as a double
+static bool ct_load_number(Ct *ct, uint64_t addr, Type *type, AstNode *node, double *out)
+{
+    if (type_is_float(type))
+        return ct_load_float(ct, addr, type, node, out);
+
+    uint64_t bits = 0;
+    if (!ct_load_int(ct, addr, type, node, &bits))
+        return false;
+    *out = type_is_signed(type) ? (double)(int64_t)bits : (double)bits;
+    return true;
+}
+
+static bool ct_truthy(Ct *ct, uint64_t addr, Type *type, AstNode *node, bool *out)
+{
+    if (type_is_float(type))
+    {
+        double value = 0.0;
+        if (!ct_load_float(ct, addr, type, node, &value))
+            return false;
+        *out = value != 0.0;
+        return true;
+    }
+
+    if (!ct_is_scalar(type))
+        return ct_fail(ct, node, "condition is not a scalar at compile time");
+
+    uint64_t bits = 0;
+    if (!ct_load_int(ct, addr, type, node, &bits))
+        return false;
+    *out = bits != 0;
+    return true;
+}
+
+// write the value of type from at src into a slot of type to, as an assignment or cast would
+static bool ct_convert(Ct *ct, uint64_t src, Type *from, uint64_t dst, Type *to, AstNode *node)
+{
+    Type *source = type_resolve_alias(from);
+    Type *target = type_resolve_alias(to);
+    if (!source || !target)
+        return ct_fail(ct, node, "expression has no type at compile time");
+
+    if (type_is_float(target) && (type_is_float(source) || type_is_integer(source)))
+    {
+        double value = 0.0;
+        return ct_load_number(ct, src, source, node, &value) && ct_store_float(ct, dst, target, value, node);
+    }
+
+    if (type_is_integer(target) && type_is_float(source))
+    {
+        double value = 0.0;
+        if (!ct_load_float(ct, src, source, node, &value))
+            return false;
+        if (isnan(value) || value <= -9223372036854775809.0 || value >= 18446744073709551616.0)
+            return ct_fail(ct, node, "float to integer conversion out of range at compile time");
+
+        uint64_t bits = value < 0.0 ? (uint64_t)(int64_t)value : (uint64_t)value;
+        return ct_store_int(ct, dst, target, bits, node);
+    }
+
+    if (ct_is_scalar(target) && ct_is_scalar(source))
+    {
+        uint64_t bits = 0;
+        return ct_load_int(ct, src, source, node, &bits) && ct_store_int(ct, dst, target, bits, node);
+    }
+
+    // a slice decays to its data pointer
+    if (type_is_pointer_like(target) && source->kind == TYPE_ARRAY && source->array.is_slice)
+        return ct_copy(ct, dst, src, 8, node);
+
+    if (type_sizeof(source) == type_sizeof(target))
+        return ct_copy(ct, dst, src, type_sizeof(target), node);
+
+    return ct_fail(ct, node, "unsupported conversion at compile time");
+}
+
+static bool ct_bind(Ct *ct, Symbol *symbol, uint64_t addr, AstNode *node)
+{
+    CtFrame *frame = ct->frame;
+    if (frame->local_count >= frame->local_capacity)
+    {
+        size_t     capacity = frame->local_capacity ? frame->local_capacity * 2 : 8;
+        CtBinding *locals   = realloc(frame->locals, capacity * sizeof(CtBinding));
+        if (!locals)
+            return ct_fail(ct, node, "out of memory during compile-time evaluation");
+        frame->locals         = locals;
+        frame->local_capacity = capacity;
+    }
+
+    frame->locals[frame->local_count].symbol = symbol;
+    frame->locals[frame->local_count].addr   = addr;
+    frame->local_count++;
+    return true;
+}
+
+static bool ct_function_addr(Ct *ct, Symbol *function, AstNode *node, uint64_t *out)
+{
+    for (size_t i = 0; i < ct->function_count; i++)
+    {
+        if (ct->functions[i] == function)
+        {
+            *out = COMPTIME_FUNC_BASE + i;
+            return true;
+        }
+    }
+
+    if (ct->function_count >= ct->function_capacity)
+    {
+        size_t   capacity  = ct->function_capacity ? ct->function_capacity * 2 : 8;
+        Symbol **functions = realloc(ct->functions, capacity * sizeof(Symbol *));
+        if (!functions)
+            return ct_fail(ct, node, "out of memory during compile-time evaluation");
+        ct->functions         = functions;
+        ct->function_capacity = capacity;
+    }
+
+    ct->functions[ct->function_count] = function;
+    *out                              = COMPTIME_FUNC_BASE + ct->function_count++;
+    return true;
+}
+
+// symbols
+
+static bool ct_eval_global(Ct *ct, Symbol *symbol, AstNode *node, uint64_t *out)
+{
+    size_t index = 0;
+    while (index < ct->global_count && ct->globals[index].symbol != symbol)
+        index++;
+
+    if (index < ct->global_count)
+    {
+        if (!ct->globals[index].ready)
+            return ct_fail(ct, node, "initializer of '%s' depends on itself at compile time", symbol->name);
+        *out = ct->globals[index].addr;
+        return true;
+    }
+
+    AstNode *decl = symbol->decl;
+    if (!decl || (decl->kind != AST_STMT_VAL && decl->kind != AST_STMT_VAR) || !decl->var_stmt.init)
+        return ct_fail(ct, node, "'%s' has no initializer to evaluate at compile time", symbol->name);
+
+    if (ct->global_count >= ct->global_capacity)
+    {
+        size_t    capacity = ct->global_capacity ? ct->global_capacity * 2 : 8;
+        CtGlobal *globals  = realloc(ct->globals, capacity * sizeof(CtGlobal));
+        if (!globals)
+            return ct_fail(ct, node, "out of memory during compile-time evaluation");
+        ct->globals         = globals;
+        ct->global_capacity = capacity;
+    }
+
+    Type    *type = type_resolve_alias(symbol->type);
+    uint64_t addr = 0;
+    if (!type)
+        return ct_fail(ct, node, "'%s' has no type at compile time", symbol->name);
+    if (!ct_alloc_static(ct, type_sizeof(type), type_alignof(type), node, &addr))
+        return false;
+
+    ct->globals[ct->global_count++] = (CtGlobal){symbol, addr, false};
+
+    // the initializer sees no locals of the frame that reached it
+    CtFrame *frame = ct->frame;
+    size_t   mark  = ct->stack.size;
+    uint64_t value = 0;
+    ct->frame      = NULL;
+    bool ok        = ct_eval(ct, decl->var_stmt.init, &value) && ct_convert(ct, value, decl->var_stmt.init->type, addr, type, node);
+    ct->frame      = frame;
+    ct->stack.size = mark;
+    if (!ok)
+        return false;
+
+    ct->globals[index].ready = true;
+    *out                     = addr;
+    return true;
+}
+
+static bool ct_eval_symbol(Ct *ct, AstNode *expr, Symbol *symbol, uint64_t *out)
+{
+    symbol = ct_origin(symbol);
+    if (!symbol)
+        return ct_fail(ct, expr, "unresolved name at compile time");
+
+    switch (symbol->kind)
+    {
+    case SYMBOL_PARAM:
+        if (ct->frame && symbol->param.index < ct->frame->param_count)
+        {
+            *out = ct->frame->params[symbol->param.index];
+            return true;
+        }
+        break;
+
+    case SYMBOL_VAR:
+    case SYMBOL_VAL:
+        if (ct->frame)
+        {
+            for (size_t i = ct->frame->local_count; i > 0; i--)
+            {
+                if (ct->frame->locals[i - 1].symbol == symbol)
+                {
+                    *out = ct->frame->locals[i - 1].addr;
+                    return true;
+                }
+            }
+        }
+
+        if (symbol->has_const_i64)
+            return ct_temp(ct, symbol->type, expr, out) && ct_store_int(ct, *out, symbol->type, (uint64_t)symbol->const_i64, expr);
+
+        if (symbol->var.is_global && symbol->kind == SYMBOL_VAR)
+            return ct_fail(ct, expr, "cannot read mutable global '%s' at compile time", symbol->name);
+        if (symbol->var.is_global)
+            return ct_eval_global(ct, symbol, expr, out);
+        break;
+
+    case SYMBOL_FUNC:
+    {
+        uint64_t addr = 0;
+        return ct_function_addr(ct, symbol, expr, &addr) && ct_temp(ct, expr->type, expr, out) && ct_store_bits(ct, *out, 8, addr, expr);
+    }
+
+    default:
+        break;
+    }
+
+    return ct_fail(ct, expr, "'%s' is not known at compile time", symbol->name);
+}
+
+// expressions
+
+static bool ct_eval_literal(Ct *ct, AstNode *expr, uint64_t *out)
+{
+    Type *type = type_resolve_alias(expr->type);
+    if (!ct_temp(ct, type, expr, out))
+        return false;
+
+    switch (expr->lit_expr.kind)
+    {
+    case TOKEN_LIT_STRING:
+    {
+        // string bytes live in the static region, nul-terminated like the runtime literal
+        const char *str  = expr->lit_expr.string_val;
+        size_t      len  = strlen(str);
+        uint64_t    data = 0;
+        if (!ct_alloc_static(ct, len + 1, 1, expr, &data))
+            return false;
+        memcpy(ct_memory(ct, data, len + 1, expr), str, len + 1);
+
+        if (!ct_store_bits(ct, *out, 8, data, expr))
+            return false;
+        if (type->kind == TYPE_ARRAY && type->array.is_slice)
+            return ct_store_bits(ct, *out + 8, 8, len, expr);
+        return true;
+    }
+    case TOKEN_LIT_FLOAT:
+        if (type_is_float(type))
+            return ct_store_float(ct, *out, type, expr->lit_expr.float_val, expr);
+        return ct_store_int(ct, *out, type, (uint64_t)(int64_t)expr->lit_expr.float_val, expr);
+    case TOKEN_LIT_CHAR:
+        return ct_store_int(ct, *out, type, (uint64_t)(unsigned char)expr->lit_expr.char_val, expr);
+    default:
+        if (type_is_float(type))
+            return ct_store_float(ct, *out, type, (double)expr->lit_expr.int_val, expr);
+        return ct_store_int(ct, *out, type, expr->lit_expr.int_val, expr);
+    }
+}
+
+static bool ct_is_comparison(TokenKind op)
+{
+    return op == TOKEN_EQUAL_EQUAL || op == TOKEN_BANG_EQUAL || op == TOKEN_LESS || op == TOKEN_LESS_EQUAL || op == TOKEN_GREATER || op == TOKEN_GREATER_EQUAL;
+}
+
+static bool ct_compare(TokenKind op, int order)
+{
+    switch (op)
+    {
+    case TOKEN_EQUAL_EQUAL:
+        return order == 0;
+    case TOKEN_BANG_EQUAL:
+        return order != 0;
+    case TOKEN_LESS:
+        return order < 0;
+    case TOKEN_LESS_EQUAL:
+        return order <= 0;
+    case TOKEN_GREATER:
+        return order > 0;
+    default:
+        return order >= 0;
+    }
+}
+
+static bool ct_eval_float_binary(Ct *ct, AstNode *expr, uint64_t lhs, Type *lhs_type, uint64_t rhs, Type *rhs_type, uint64_t *out)
+{
+    TokenKind op = expr->binary_expr.op;
+    double    a  = 0.0;
+    double    b  = 0.0;
+    if (!ct_load_number(ct, lhs, lhs_type, expr, &a) || !ct_load_number(ct, rhs, rhs_type, expr, &b) || !ct_temp(ct, expr->type, expr, out))
+        return false;
+
+    if (ct_is_comparison(op))
+    {
+        // nan compares unordered: only '!=' holds
+        bool result = (isnan(a) || isnan(b)) ? op == TOKEN_BANG_EQUAL : ct_compare(op, (a > b) - (a < b));
+        return ct_store_int(ct, *out, expr->type, result, expr);
+    }
+
+    double result = 0.0;
+    switch (op)
+    {
+    case TOKEN_PLUS:
+        result = a + b;
+        break;
+    case TOKEN_MINUS:
+        result = a - b;
+        break;
+    case TOKEN_STAR:
+        result = a * b;
+        break;
+    case TOKEN_SLASH:
+        result = a / b;
+        break;
+    case TOKEN_PERCENT:
+        result = fmod(a, b);
+        break;
+    default:
+        return ct_fail(ct, expr, "operator is not supported on floats at compile time");
+    }
+    return ct_store_float(ct, *out, expr->type, result, expr);
+}
+
+// integer operators follow codegen: the narrower operand is extended by its own signedness and
+// the operation is signed when the result or either operand is
+static bool ct_eval_int_binary(Ct *ct, AstNode *expr, uint64_t lhs, Type *lhs_type, uint64_t rhs, Type *rhs_type, uint64_t *out)
+{
+    TokenKind op = expr->binary_expr.op;
+    uint64_t  a  = 0;
+    uint64_t  b  = 0;
+    if (!ct_load_int(ct, lhs, lhs_type, expr, &a) || !ct_load_int(ct, rhs, rhs_type, expr, &b) || !ct_temp(ct, expr->type, expr, out))
+        return false;
+
+    size_t   size      = type_sizeof(lhs_type) > type_sizeof(rhs_type) ? type_sizeof(lhs_type) : type_sizeof(rhs_type);
+    unsigned width     = (unsigned)size * 8;
+    bool     is_signed = type_is_signed(expr->type) || type_is_signed(lhs_type) || type_is_signed(rhs_type);
+    uint64_t ua        = ct_extend(a, size, false);
+    uint64_t ub        = ct_extend(b, size, false);
+    int64_t  sa        = (int64_t)ct_extend(a, size, true);
+    int64_t  sb        = (int64_t)ct_extend(b, size, true);
+
+    if (ct_is_comparison(op))
+    {
+        int order = is_signed ? (sa > sb) - (sa < sb) : (ua > ub) - (ua < ub);
+        return ct_store_int(ct, *out, expr->type, ct_compare(op, order), expr);
+    }
+
+    uint64_t result = 0;
+    switch (op)
+    {
+    case TOKEN_PLUS:
+        result = ua + ub;
+        break;
+    case TOKEN_MINUS:
+        result = ua - ub;
+        break;
+    case TOKEN_STAR:
+        result = ua * ub;
+        break;
+    case TOKEN_SLASH:
+    case TOKEN_PERCENT:
+        if (ub == 0)
+            return ct_fail(ct, expr, "division by zero at compile time");
+        if (is_signed)
+        {
+            if (sb == -1 && sa == (int64_t)ct_extend(1ULL << (width - 1), size, true))
+                return ct_fail(ct, expr, "signed division overflow at compile time");
+            result = (uint64_t)(op == TOKEN_SLASH ? sa / sb : sa % sb);
+        }
+        else
+        {
+            result = op == TOKEN_SLASH ? ua / ub : ua % ub;
+        }
+        break;
+    case TOKEN_AMPERSAND:
+        result = ua & ub;
+        break;
+    case TOKEN_PIPE:
+        result = ua | ub;
+        break;
+    case TOKEN_CARET:
+        result = ua ^ ub;
+        break;
+    case TOKEN_LESS_LESS:
+    case TOKEN_GREATER_GREATER:
+        if (ub >= width)
+            return ct_fail(ct, expr, "shift amount %llu out of range for a %u-bit value at compile time", (unsigned long long)ub, width);
+        if (op == TOKEN_LESS_LESS)
+            result = ua << ub;
+        else
+            result = is_signed ? (uint64_t)(sa >> ub) : ua >> ub;
+        break;
+    default:
+        return ct_fail(ct, expr, "operator is not supported at compile time");
+    }
+    return ct_store_int(ct, *out, expr->type, result, expr);
+}
+
+static bool ct_eval_binary(Ct *ct, AstNode *expr, uint64_t *out)
+{
+    TokenKind op = expr->binary_expr.op;
+
+    if (op == TOKEN_EQUAL)
+    {
+        uint64_t value = 0;
+        if (!ct_eval(ct, expr->binary_expr.left, out) || !ct_eval(ct, expr->binary_expr.right, &value))
+            return false;
+        return ct_convert(ct, value, expr->binary_expr.right->type, *out, expr->binary_expr.left->type, expr);
+    }
+
+    uint64_t lhs      = 0;
+    uint64_t rhs      = 0;
+    Type    *lhs_type = type_resolve_alias(expr->binary_expr.left->type);
+    Type    *rhs_type = type_resolve_alias(expr->binary_expr.right->type);
+
+    // logical operators short-circuit, which only makes more programs evaluable
+    if (op == TOKEN_AMPERSAND_AMPERSAND || op == TOKEN_PIPE_PIPE || op == TOKEN_KW_OR)
+    {
+        bool result = false;
+        if (!ct_eval(ct, expr->binary_expr.left, &lhs) || !ct_truthy(ct, lhs, lhs_type, expr, &result))
+            return false;
+        if (result == (op == TOKEN_AMPERSAND_AMPERSAND))
+        {
+            if (!ct_eval(ct, expr->binary_expr.right, &rhs) || !ct_truthy(ct, rhs, rhs_type, expr, &result))
+                return false;
+        }
+        return ct_temp(ct, expr->type, expr, out) && ct_store_int(ct, *out, expr->type, result, expr);
+    }
+
+    if (!ct_eval(ct, expr->binary_expr.left, &lhs) || !ct_eval(ct, expr->binary_expr.right, &rhs))
+        return false;
+
+    if (!lhs_type || !rhs_type || lhs_type->kind == TYPE_VECTOR || rhs_type->kind == TYPE_VECTOR)
+        return ct_fail(ct, expr, "vector arithmetic is not supported at compile time");
+
+    // pointer +/- integer scales by the pointee, or by bytes for 'ptr'
+    if ((op == TOKEN_PLUS || op == TOKEN_MINUS) && type_is_pointer_like(lhs_type) && type_is_integer(rhs_type))
+    {
+        uint64_t base   = 0;
+        uint64_t offset = 0;
+        if (!ct_load_bits(ct, lhs, 8, expr, &base) || !ct_load_int(ct, rhs, rhs_type, expr, &offset))
+            return false;
+
+        uint64_t scale = lhs_type->kind == TYPE_POINTER ? ct_sizeof(lhs_type->pointer.base) : 1;
+        uint64_t bytes = offset * scale;
+        return ct_temp(ct, expr->type, expr, out) && ct_store_bits(ct, *out, 8, op == TOKEN_PLUS ? base + bytes : base - bytes, expr);
+    }
+
+    if (type_is_float(lhs_type) || type_is_float(rhs_type))
+        return ct_eval_float_binary(ct, expr, lhs, lhs_type, rhs, rhs_type, out);
+
+    if (!ct_is_scalar(lhs_type) || !ct_is_scalar(rhs_type))
+        return ct_fail(ct, expr, "operator is not supported on these operands at compile time");
+
+    return ct_eval_int_binary(ct, expr, lhs, lhs_type, rhs, rhs_type, out);
+}
+
+static bool ct_eval_unary(Ct *ct, AstNode *expr, uint64_t *out)
+{
+    AstNode *operand = expr->unary_expr.expr;
+    Type    *type    = type_resolve_alias(operand->type);
+    uint64_t value   = 0;
+    if (!ct_eval(ct, operand, &value))
+        return false;
+
+    switch (expr->unary_expr.op)
+    {
+    case TOKEN_QUESTION:
+        // the operand evaluated to its location
+        return ct_temp(ct, expr->type, expr, out) && ct_store_bits(ct, *out, 8, value, expr);
+
+    case TOKEN_AT:
+    {
+        uint64_t target = 0;
+        if (!ct_load_bits(ct, value, 8, expr, &target) || !ct_memory(ct, target, ct_sizeof(expr->type), expr))
+            return false;
+        *out = target;
+        return true;
+    }
+
+    case TOKEN_PLUS:
+        return ct_temp(ct, expr->type, expr, out) && ct_convert(ct, value, type, *out, expr->type, expr);
+
+    case TOKEN_BANG:
+    {
+        bool truth = false;
+        return ct_truthy(ct, value, type, expr, &truth) && ct_temp(ct, expr->type, expr, out) && ct_store_int(ct, *out, expr->type, !truth, expr);
+    }
+
+    case TOKEN_MINUS:
+    case TOKEN_TILDE:
+        if (!ct_temp(ct, expr->type, expr, out))
+            return false;
+
+        if (type_is_float(type) && expr->unary_expr.op == TOKEN_MINUS)
+        {
+            double number = 0.0;
+            return ct_load_float(ct, value, type, expr, &number) && ct_store_float(ct, *out, expr->type, -number, expr);
+        }
+
+        if (type_is_integer(type))
+        {
+            uint64_t bits = 0;
+            if (!ct_load_int(ct, value, type, expr, &bits))
+                return false;
+            return ct_store_int(ct, *out, expr->type, expr->unary_expr.op == TOKEN_MINUS ? 0 - bits : ~bits, expr);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return ct_fail(ct, expr, "unary operator is not supported at compile time");
+}
+
+static bool ct_eval_intrinsic(Ct *ct, AstNode *expr, const char *name, uint64_t *out)
+{
+    AstList  *list  = expr->call_expr.args;
+    size_t    count = list ? (size_t)list->count : 0;
+    AstNode **args  = list ? list->items : NULL;
+
+    if (strcmp(name, "likely") == 0 || strcmp(name, "unlikely") == 0)
+    {
+        uint64_t value = 0;
+        return count == 1 && ct_eval(ct, args[0], &value) && ct_temp(ct, expr->type, expr, out) && ct_convert(ct, value, args[0]->type, *out, expr->type, expr);
+    }
+
+    if (!ct_temp(ct, expr->type, expr, out))
+        return false;
+
+    if ((strcmp(name, "size_of") == 0 || strcmp(name, "align_of") == 0) && count == 1 && args[0]->type)
+    {
+        Type *type = type_resolve_alias(args[0]->type);
+        return ct_store_int(ct, *out, expr->type, name[0] == 's' ? type_sizeof(type) : type_alignof(type), expr);
+    }
+
+    if (strcmp(name, "offset_of") == 0 && count == 2 && args[0]->type && args[1]->kind == AST_EXPR_IDENT)
+    {
+        Type   *type  = type_resolve_alias(args[0]->type);
+        Symbol *field = type && (type->kind == TYPE_STRUCT || type->kind == TYPE_UNION) ? type_find_field(type, args[1]->ident_expr.name) : NULL;
+        if (field)
+            return ct_store_int(ct, *out, expr->type, field->field.offset, expr);
+    }
+
+    bool is_rotate = strcmp(name, "rotl") == 0 || strcmp(name, "rotr") == 0;
+    bool is_bits   = strcmp(name, "popcount") == 0 || strcmp(name, "clz") == 0 || strcmp(name, "ctz") == 0 || strcmp(name, "bswap") == 0;
+    if ((is_rotate && count == 2) || (is_bits && count == 1))
+    {
+        Type    *type  = type_resolve_alias(args[0]->type);
+        uint64_t value = 0;
+        size_t   mark  = ct->stack.size;
+        if (!ct_eval(ct, args[0], &value) || !ct_load_bits(ct, value, type_sizeof(type), expr, &value))
+            return false;
+
+        unsigned width  = (unsigned)type_sizeof(type) * 8;
+        uint64_t result = 0;
+        if (strcmp(name, "popcount") == 0)
+        {
+            for (; value; value &= value - 1)
+                result++;
+        }
+        else if (strcmp(name, "clz") == 0)
+        {
+            while (result < width && !((value >> (width - 1 - result)) & 1ULL))
+                result++;
+        }
+        else if (strcmp(name, "ctz") == 0)
+        {
+            while (result < width && !((value >> result) & 1ULL))
+                result++;
+        }
+        else if (strcmp(name, "bswap") == 0)
+        {
+            for (unsigned i = 0; i < width; i += 8)
+                result = (result << 8) | ((value >> i) & 0xffULL);
+        }
+        else
+        {
+            // the count is taken modulo the width, as the funnel shift does
+            uint64_t amount = 0;
+            if (!ct_eval(ct, args[1], &amount) || !ct_load_int(ct, amount, args[1]->type, expr, &amount))
+                return false;
+            amount %= width;
+            if (name[3] == 'r')
+                amount = (width - amount) % width;
+            result = amount ? (value << amount) | (value >> (width - amount)) : value;
+        }
+
+        ct->stack.size = mark;
+        return ct_store_int(ct, *out, expr->type, result, expr);
+    }
+
+    return ct_fail(ct, expr, "intrinsic '%s' cannot be evaluated at compile time", name);
+}
+
+static bool ct_call(Ct *ct, AstNode *expr, Symbol *function, uint64_t *out)
+{
+    AstNode *decl = function->decl;
+    if (function->func.is_external)
+        return ct_fail(ct, expr, "external function '%s' cannot run at compile time", function->name);
+    if (!decl || decl->kind != AST_STMT_FUN || !decl->fun_stmt.body)
+        return ct_fail(ct, expr, "'%s' has no body to run at compile time", function->name);
+    if (function->func.uses_mach_varargs || decl->fun_stmt.is_variadic)
+        return ct_fail(ct, expr, "variadic function '%s' cannot run at compile time", function->name);
+    if (ct->depth >= ct->limits.depth)
+        return ct_fail(ct, expr, "compile-time call depth exceeded %d", ct->limits.depth);
+
+    Type   *signature   = type_resolve_alias(function->type);
+    Type   *return_type = signature ? signature->function.return_type : NULL;
+    size_t  count       = expr->call_expr.args ? (size_t)expr->call_expr.args->count : 0;
+    if (!signature || signature->kind != TYPE_FUNCTION || count != signature->function.param_count)
+        return ct_fail(ct, expr, "call to '%s' cannot be evaluated at compile time", function->name);
+
+    // the result slot outlives the callee's stack
+    *out = 0;
+    if (return_type && !ct_temp(ct, return_type, expr, out))
+        return false;
+    size_t mark = ct->stack.size;
+
+    CtFrame frame     = {0};
+    frame.function    = function;
+    frame.result      = *out;
+    frame.result_type = return_type;
+    frame.param_count = count;
+    frame.params      = calloc(count ? count : 1, sizeof(uint64_t));
+    if (!frame.params)
+        return ct_fail(ct, expr, "out of memory during compile-time evaluation");
+
+    bool ok = true;
+    for (size_t i = 0; ok && i < count; i++)
+    {
+        AstNode *arg   = expr->call_expr.args->items[i];
+        Type    *param = signature->function.param_types[i];
+        uint64_t value = 0;
+        ok             = ct_eval(ct, arg, &value) && ct_temp(ct, param, arg, &frame.params[i]) && ct_convert(ct, value, arg->type, frame.params[i], param, arg);
+    }
+
+    CtFlow flow = CT_ERROR;
+    if (ok)
+    {
+        CtFrame *caller = ct->frame;
+        ct->frame       = &frame;
+        ct->depth++;
+        flow = ct_exec(ct, decl->fun_stmt.body);
+        if (flow != CT_ERROR && flow != CT_RETURN && return_type)
+        {
+            ct_fail(ct, expr, "'%s' finished without returning a value at compile time", function->name);
+            flow = CT_ERROR;
+        }
+        ct->depth--;
+        ct->frame = caller;
+    }
+
+    free(frame.params);
+    free(frame.locals);
+    ct->stack.size = mark;
+    return flow != CT_ERROR;
+}
+
+static bool ct_eval_call(Ct *ct, AstNode *expr, uint64_t *out)
+{
+    AstNode *func   = expr->call_expr.func;
+    Symbol  *symbol = ct_origin(func->symbol);
+
+    if (symbol && symbol->kind == SYMBOL_FUNC)
+        return ct_call(ct, expr, symbol, out);
+
+    if (!symbol && func->kind == AST_EXPR_IDENT)
+        return ct_eval_intrinsic(ct, expr, func->ident_expr.name, out);
+
+    // call through a function pointer
+    uint64_t value   = 0;
+    uint64_t address = 0;
+    if (!ct_eval(ct, func, &value) || !ct_load_bits(ct, value, 8, expr, &address))
+        return false;
+    if (address < COMPTIME_FUNC_BASE || address - COMPTIME_FUNC_BASE >= ct->function_count)
+        return ct_fail(ct, expr, address ? "call through an invalid function pointer at compile time" : "call through a nil function pointer at compile time");
+    return ct_call(ct, expr, ct->functions[address - COMPTIME_FUNC_BASE], out);
+}
+
+static bool ct_eval_index(Ct *ct, AstNode *expr, uint64_t *out)
+{
+    Type    *type  = type_resolve_alias(expr->index_expr.array->type);
+    uint64_t base  = 0;
+    uint64_t index = 0;
+    if (!type || !ct_eval(ct, expr->index_expr.array, &base) || !ct_eval(ct, expr->index_expr.index, &index) || !ct_load_int(ct, index, expr->index_expr.index->type, expr, &index))
+        return false;
+
+    size_t   elem_size = ct_sizeof(expr->type);
+    uint64_t length    = UINT64_MAX;
+    switch (type->kind)
+    {
+    case TYPE_ARRAY:
+        if (type->array.is_slice)
+        {
+            if (!ct_load_bits(ct, base + 8, 8, expr, &length) || !ct_load_bits(ct, base, 8, expr, &base))
+                return false;
+        }
+        else
+        {
+            length = type->array.size;
+        }
+        break;
+    case TYPE_VECTOR:
+        length = type->vector.count;
+        break;
+    case TYPE_PTR:
+    case TYPE_POINTER:
+        if (!ct_load_bits(ct, base, 8, expr, &base))
+            return false;
+        break;
+    default:
+        return ct_fail(ct, expr, "indexing is not supported on this type at compile time");
+    }
+
+    if (index >= length)
+        return ct_fail(ct, expr, "index %lld out of bounds for length %llu at compile time", (long long)index, (unsigned long long)length);
+
+    *out = base + index * elem_size;
+    return ct_memory(ct, *out, elem_size, expr) != NULL;
+}
+
+static bool ct_eval_field(Ct *ct, AstNode *expr, uint64_t *out)
+{
+    AstNode *object = expr->field_expr.object;
+
+    // module member: mod.name
+    if (object->kind == AST_EXPR_IDENT && object->symbol && object->symbol->kind == SYMBOL_MODULE)
+        return ct_eval_symbol(ct, expr, expr->symbol, out);
+
+    Type    *type = type_resolve_alias(object->type);
+    uint64_t base = 0;
+    if (!type || !ct_eval(ct, object, &base))
+        return false;
+
+    // fields through a pointer
+    if (type->kind == TYPE_POINTER)
+    {
+        if (!ct_load_bits(ct, base, 8, expr, &base))
+            return false;
+        type = type_resolve_alias(type->pointer.base);
+    }
+
+    if (type->kind == TYPE_ARRAY && type->array.is_slice)
+    {
+        *out = base + (strcmp(expr->field_expr.field, "data") == 0 ? 0 : 8);
+        return ct_memory(ct, *out, 8, expr) != NULL;
+    }
+
+    Symbol *field = (type->kind == TYPE_STRUCT || type->kind == TYPE_UNION) ? type_find_field(type, expr->field_expr.field) : NULL;
+    if (!field)
+        return ct_fail(ct, expr, "field '%s' cannot be evaluated at compile time", expr->field_expr.field);
+
+    *out = base + field->field.offset;
+    return ct_memory(ct, *out, ct_sizeof(field->type), expr) != NULL;
+}
+
+static bool ct_eval_cast(Ct *ct, AstNode *expr, uint64_t *out)
+{
+    AstNode *operand = expr->cast_expr.expr;
+    Type    *from    = type_resolve_alias(operand->type);
+    Type    *to      = type_resolve_alias(expr->type);
+    uint64_t value   = 0;
+    if (!from || !to || !ct_eval(ct, operand, &value) || !ct_temp(ct, to, expr, out))
+        return false;
+
+    // fixed arrays decay to their address
+    if (from->kind == TYPE_ARRAY && !from->array.is_slice && type_is_pointer_like(to))
+        return ct_store_bits(ct, *out, 8, value, expr);
+
+    return ct_convert(ct, value, from, *out, to, expr);
+}
+
+// element i of an array literal converted into dst
+static bool ct_eval_element(Ct *ct, AstNode *elem, Type *elem_type, uint64_t dst)
+{
+    size_t   mark  = ct->stack.size;
+    uint64_t value = 0;
+    if (!ct_eval(ct, elem, &value) || !ct_convert(ct, value, elem->type, dst, elem_type, elem))
+        return false;
+    ct->stack.size = mark;
+    return true;
+}
+
+static bool ct_eval_array(Ct *ct, AstNode *expr, uint64_t *out)
+{
+    Type     *type  = type_resolve_alias(expr->type);
+    size_t    given = expr->array_expr.elems ? (size_t)expr->array_expr.elems->count : 0;
+    AstNode **elems = given ? expr->array_expr.elems->items : NULL;
+    if (!ct_temp(ct, type, expr, out))
+        return false;
+
+    if (type->kind == TYPE_VECTOR || (type->kind == TYPE_ARRAY && !type->array.is_slice))
+    {
+        // a single vector element is splatted across every lane
+        bool   is_vector = type->kind == TYPE_VECTOR;
+        Type  *elem_type = is_vector ? type->vector.elem_type : type->array.elem_type;
+        size_t count     = is_vector ? type->vector.count : type->array.size;
+        for (size_t i = 0; i < count; i++)
+        {
+            AstNode *elem = i < given ? elems[i] : (is_vector && given == 1 ? elems[0] : NULL);
+            if (elem && !ct_eval_element(ct, elem, elem_type, *out + i * ct_sizeof(elem_type)))
+                return false;
+        }
+        return true;
+    }
+
+    if (type->kind != TYPE_ARRAY)
+        return ct_fail(ct, expr, "array literal cannot be evaluated at compile time");
+
+    if (expr->array_expr.is_slice_literal)
+    {
+        // []T{data, len}
+        if (given >= 1 && !ct_eval_element(ct, elems[0], type_ptr(), *out))
+            return false;
+        return given < 2 || ct_eval_element(ct, elems[1], type_u64(), *out + 8);
+    }
+
+    // elements get static storage so a returned slice stays valid
+    Type    *elem_type = type->array.elem_type;
+    size_t   elem_size = ct_sizeof(elem_type);
+    uint64_t data      = 0;
+    if (!ct_alloc_static(ct, given * elem_size, type_alignof(type_resolve_alias(elem_type)), expr, &data))
+        return false;
+
+    for (size_t i = 0; i < given; i++)
+    {
+        if (!ct_eval_element(ct, elems[i], elem_type, data + i * elem_size))
+            return false;
+    }
+    return ct_store_bits(ct, *out, 8, data, expr) && ct_store_bits(ct, *out + 8, 8, given, expr);
+}
+
+static bool ct_eval_struct(Ct *ct, AstNode *expr, uint64_t *out)
+{
+    Type *type = type_resolve_alias(expr->type);
+    if (!ct_temp(ct, type, expr, out))
+        return false;
+
+    // fields without an initializer stay zero
+    AstList *inits = expr->struct_expr.fields;
+    for (int i = 0; inits && i < inits->count; i++)
+    {
+        AstNode *init   = inits->items[i];
+        Type    *field  = NULL;
+        size_t   offset = 0;
+
+        if (type->kind == TYPE_STRUCT || type->kind == TYPE_UNION)
+        {
+            Symbol *symbol = type_find_field(type, init->field_expr.field);
+            field          = symbol ? symbol->type : NULL;
+            offset         = symbol ? symbol->field.offset : 0;
+        }
+        else if (type->kind == TYPE_ARRAY && type->array.is_slice)
+        {
+            bool is_data = strcmp(init->field_expr.field, "data") == 0;
+            field        = is_data ? type_ptr() : type_u64();
+            offset       = is_data ? 0 : 8;
+        }
+
+        if (!field)
+            return ct_fail(ct, init, "field '%s' cannot be evaluated at compile time", init->field_expr.field);
+        if (!ct_eval_element(ct, init->field_expr.object, field, *out + offset))
+            return false;
+    }
+    return true;
+}
+
+static bool ct_eval(Ct *ct, AstNode *expr, uint64_t *out)
+{
+    if (!ct_step(ct, expr))
+        return false;
+
+    switch (expr->kind)
+    {
+    case AST_EXPR_LIT:
+        return ct_eval_literal(ct, expr, out);
+    case AST_EXPR_NULL:
+        return ct_temp(ct, expr->type ? expr->type : type_ptr(), expr, out);
+    case AST_EXPR_IDENT:
+        return ct_eval_symbol(ct, expr, expr->symbol, out);
+    case AST_EXPR_BINARY:
+        return ct_eval_binary(ct, expr, out);
+    case AST_EXPR_UNARY:
+        return ct_eval_unary(ct, expr, out);
+    case AST_EXPR_CALL:
+        return ct_eval_call(ct, expr, out);
+    case AST_EXPR_INDEX:
+        return ct_eval_index(ct, expr, out);
+    case AST_EXPR_FIELD:
+        return ct_eval_field(ct, expr, out);
+    case AST_EXPR_CAST:
+        return ct_eval_cast(ct, expr, out);
+    case AST_EXPR_ARRAY:
+        return ct_eval_array(ct, expr, out);
+    case AST_EXPR_STRUCT:
+        return ct_eval_struct(ct, expr, out);
+    default:
+        return ct_fail(ct, expr, "expression cannot be evaluated at compile time");
+    }
+}
+
+// statements
+
+static CtFlow ct_exec_var(Ct *ct, AstNode *stmt)
+{
+    uint64_t slot = 0;
+    if (!ct_temp(ct, stmt->type, stmt, &slot))
+        return CT_ERROR;
+
+    if (stmt->var_stmt.init)
+    {
+        size_t   mark  = ct->stack.size;
+        uint64_t value = 0;
+        if (!ct_eval(ct, stmt->var_stmt.init, &value) || !ct_convert(ct, value, stmt->var_stmt.init->type, slot, stmt->type, stmt))
+            return CT_ERROR;
+        ct->stack.size = mark;
+    }
+
+    return ct_bind(ct, stmt->symbol, slot, stmt) ? CT_NEXT : CT_ERROR;
+}
+
+// evaluates a condition; temporaries are released before the branch runs
+static bool ct_condition(Ct *ct, AstNode *cond, bool *out)
+{
+    size_t   mark  = ct->stack.size;
+    uint64_t value = 0;
+    if (!ct_eval(ct, cond, &value) || !ct_truthy(ct, value, cond->type, cond, out))
+        return false;
+    ct->stack.size = mark;
+    return true;
+}
+
+static CtFlow ct_exec(Ct *ct, AstNode *stmt)
+{
+    if (!ct_step(ct, stmt))
+        return CT_ERROR;
+
+    switch (stmt->kind)
+    {
+    case AST_STMT_BLOCK:
+    {
+        // locals and temporaries of the block go away with it
+        size_t mark   = ct->stack.size;
+        size_t locals = ct->frame->local_count;
+        CtFlow flow   = CT_NEXT;
+        for (int i = 0; flow == CT_NEXT && stmt->block_stmt.stmts && i < stmt->block_stmt.stmts->count; i++)
+            flow = ct_exec(ct, stmt->block_stmt.stmts->items[i]);
+        ct->stack.size         = mark;
+        ct->frame->local_count = locals;
+        return flow;
+    }
+
+    case AST_STMT_VAL:
+    case AST_STMT_VAR:
+        return ct_exec_var(ct, stmt);
+
+    case AST_STMT_EXPR:
+    {
+        size_t   mark  = ct->stack.size;
+        uint64_t value = 0;
+        if (!ct_eval(ct, stmt->expr_stmt.expr, &value))
+            return CT_ERROR;
+        ct->stack.size = mark;
+        return CT_NEXT;
+    }
+
+    case AST_STMT_RET:
+        if (stmt->ret_stmt.expr && ct->frame->result_type)
+        {
+            size_t   mark  = ct->stack.size;
+            uint64_t value = 0;
+            if (!ct_eval(ct, stmt->ret_stmt.expr, &value) || !ct_convert(ct, value, stmt->ret_stmt.expr->type, ct->frame->result, ct->frame->result_type, stmt))
+                return CT_ERROR;
+            ct->stack.size = mark;
+        }
+        return CT_RETURN;
+
+    case AST_STMT_IF:
+    case AST_STMT_OR:
+        for (AstNode *branch = stmt; branch; branch = branch->cond_stmt.stmt_or)
+        {
+            bool taken = true;
+            if (branch->cond_stmt.cond && !ct_condition(ct, branch->cond_stmt.cond, &taken))
+                return CT_ERROR;
+            if (taken)
+                return ct_exec(ct, branch->cond_stmt.body);
+        }
+        return CT_NEXT;
+
+    case AST_STMT_FOR:
+        for (;;)
+        {
+            bool running = true;
+            if (stmt->for_stmt.cond && !ct_condition(ct, stmt->for_stmt.cond, &running))
+                return CT_ERROR;
+            if (!running)
+                return CT_NEXT;
+
+            CtFlow flow = ct_exec(ct, stmt->for_stmt.body);
+            if (flow == CT_BREAK)
+                return CT_NEXT;
+            if (flow == CT_RETURN || flow == CT_ERROR)
+                return flow;
+        }
+
+    case AST_STMT_BRK:
+        return CT_BREAK;
+
+    case AST_STMT_CNT:
+        return CT_CONTINUE;
+
+    case AST_STMT_ASM:
+        ct_fail(ct, stmt, "inline assembly cannot run at compile time");
+        return CT_ERROR;
+
+    default:
+        ct_fail(ct, stmt, "statement cannot run at compile time");
+        return CT_ERROR;
+    }
+}
+
+// public interface
+
+ComptimeValue *comptime_eval(AstNode *expr, Type *type, ComptimeLimits limits, ComptimeError *error)
+{
+    Ct ct             = {0};
+    ct.limits         = limits;
+    ct.stack.base     = COMPTIME_STACK_BASE;
+    ct.statics.base   = COMPTIME_STATIC_BASE;
+    ct.error          = error;
+    error->node       = NULL;
+    error->function   = NULL;
+    error->message[0] = '\0';
+
+    Type          *target = type_resolve_alias(type);
+    ComptimeValue *result = NULL;
+    uint64_t       value  = 0;
+    uint64_t       slot   = 0;
+    if (target && ct_eval(&ct, expr, &value) && ct_temp(&ct, target, expr, &slot) && ct_convert(&ct, value, expr->type, slot, target, expr))
+    {
+        result = calloc(1, sizeof(ComptimeValue));
+        if (result)
+        {
+            size_t size            = type_sizeof(target);
+            result->type           = target;
+            result->bytes          = malloc(size ? size : 1);
+            result->memory         = ct.statics.data;
+            result->memory_size    = ct.statics.size;
+            result->allocs         = ct.allocs;
+            result->alloc_count    = ct.alloc_count;
+            result->functions      = ct.functions;
+            result->function_count = ct.function_count;
+            if (result->bytes)
+                memcpy(result->bytes, ct.stack.data + (slot - ct.stack.base), size);
+
+            // ownership of the static region moves to the result
+            ct.statics.data = NULL;
+            ct.allocs       = NULL;
+            ct.functions    = NULL;
+        }
+    }
+    else if (!ct.failed)
+    {
+        ct_fail(&ct, expr, "initializer cannot be evaluated at compile time");
+    }
+
+    free(ct.stack.data);
+    free(ct.statics.data);
+    free(ct.allocs);
+    free(ct.globals);
+    free(ct.functions);
+    return result;
+}
+
+void comptime_value_free(ComptimeValue *value)
+{
+    if (!value)
+        return;
+    free(value->bytes);
+    free(value->memory);
+    free(value->allocs);
+    free(value->functions);
+    free(value);
+}
+
+const ComptimeAlloc *comptime_value_find_alloc(const ComptimeValue *value, uint64_t addr)
+{
+    // statics are packed back to back, so the end of one allocation is often the start of the next;
+    // a one-past-the-end pointer only belongs to an allocation when none starts there
+    const ComptimeAlloc *ends_here = NULL;
+    for (size_t i = 0; i < value->alloc_count; i++)
+    {
+        const ComptimeAlloc *alloc = &value->allocs[i];
+        if (addr < alloc->addr)
+            continue;
+        if (addr - alloc->addr < alloc->size)
+            return alloc;
+        if (addr - alloc->addr == alloc->size)
+            ends_here = alloc;
+    }
+    return ends_here;
+}
+
+const uint8_t *comptime_value_memory(const ComptimeValue *value, uint64_t addr)
+{
+    if (addr < COMPTIME_STATIC_BASE || addr - COMPTIME_STATIC_BASE > value->memory_size)
+        return NULL;
+    return value->memory + (addr - COMPTIME_STATIC_BASE);
+}
+
+Symbol *comptime_value_function(const ComptimeValue *value, uint64_t addr)
+{
+    if (addr < COMPTIME_FUNC_BASE || addr - COMPTIME_FUNC_BASE >= value->function_count)
+        return NULL;
+    return value->functions[addr - COMPTIME_FUNC_BASE];
+}
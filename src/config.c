@@ -274,15 +274,22 @@ static char *read_file_to_string(const char *path)
 void target_config_init(TargetConfig *target)
 {
     memset(target, 0, sizeof(TargetConfig));
-    target->opt_level   = 2;    // default optimization level
-    target->emit_object = true; // default to emitting object files
-    target->shared      = true; // default shared when building libraries
+    target->opt_level        = 2;    // default optimization level
+    target->emit_object      = true; // default to emitting object files
+    target->shared           = true; // default shared when building libraries
+    target->loop_vectorize   = -1;
+    target->slp_vectorize    = -1;
+    target->unroll_loops     = -1;
+    target->inline_threshold = -1;
 }
 
 void target_config_dnit(TargetConfig *target)
 {
     free(target->name);
     free(target->target_triple);
+    free(target->cpu);
+    free(target->features);
+    free(target->passes);
     memset(target, 0, sizeof(TargetConfig));
 }
 
@@ -509,9 +516,60 @@ ProjectConfig *config_load(const char *config_path)
                     // target triple already handled above
                     toml_skip_table_value(&parser);
                 }
+                else if (strcmp(key, "cpu") == 0)
+                {
+                    free(target->cpu);
+                    target->cpu = toml_parse_string(&parser);
+                }
+                else if (strcmp(key, "features") == 0)
+                {
+                    free(target->features);
+                    target->features = toml_parse_string(&parser);
+                }
                 else if (strcmp(key, "opt-level") == 0)
                 {
-                    target->opt_level = toml_parse_number(&parser);
+                    // numeric level or "s"/"z" for size
+                    toml_skip_whitespace(&parser);
+                    if (parser.pos < parser.len && parser.input[parser.pos] == '"')
+                    {
+                        char *level = toml_parse_string(&parser);
+                        if (level && (strcmp(level, "s") == 0 || strcmp(level, "z") == 0))
+                        {
+                            target->opt_level  = 2;
+                            target->size_level = level[0] == 's' ? 1 : 2;
+                        }
+                        else
+                        {
+                            target->opt_level = -1; // rejected by validation
+                        }
+                        free(level);
+                    }
+                    else
+                    {
+                        target->opt_level  = toml_parse_number(&parser);
+                        target->size_level = 0;
+                    }
+                }
+                else if (strcmp(key, "passes") == 0)
+                {
+                    free(target->passes);
+                    target->passes = toml_parse_string(&parser);
+                }
+                else if (strcmp(key, "loop-vectorize") == 0)
+                {
+                    target->loop_vectorize = toml_parse_bool(&parser);
+                }
+                else if (strcmp(key, "slp-vectorize") == 0)
+                {
+                    target->slp_vectorize = toml_parse_bool(&parser);
+                }
+                else if (strcmp(key, "unroll-loops") == 0)
+                {
+                    target->unroll_loops = toml_parse_bool(&parser);
+                }
+                else if (strcmp(key, "inline-threshold") == 0)
+                {
+                    target->inline_threshold = toml_parse_number(&parser);
                 }
                 else if (strcmp(key, "emit-ast") == 0)
                 {
@@ -749,7 +807,24 @@ bool config_save(ProjectConfig *config, const char *config_path)
         fprintf(file, "\n[targets.%s]\n", target->name);
         if (target->target_triple)
             fprintf(file, "target = \"%s\"\n", target->target_triple);
-        fprintf(file, "opt-level = %d\n", target->opt_level);
+        if (target->cpu)
+            fprintf(file, "cpu = \"%s\"\n", target->cpu);
+        if (target->features)
+            fprintf(file, "features = \"%s\"\n", target->features);
+        if (target->size_level > 0)
+            fprintf(file, "opt-level = \"%c\"\n", target->size_level > 1 ? 'z' : 's');
+        else
+            fprintf(file, "opt-level = %d\n", target->opt_level);
+        if (target->passes)
+            fprintf(file, "passes = \"%s\"\n", target->passes);
+        if (target->loop_vectorize >= 0)
+            fprintf(file, "loop-vectorize = %s\n", target->loop_vectorize ? "true" : "false");
+        if (target->slp_vectorize >= 0)
+            fprintf(file, "slp-vectorize = %s\n", target->slp_vectorize ? "true" : "false");
+        if (target->unroll_loops >= 0)
+            fprintf(file, "unroll-loops = %s\n", target->unroll_loops ? "true" : "false");
+        if (target->inline_threshold >= 0)
+            fprintf(file, "inline-threshold = %d\n", target->inline_threshold);
         // always write booleans explicitly for transparency
         fprintf(file, "emit-ast = %s\n", target->emit_ast ? "true" : "false");
         fprintf(file, "emit-ir = %s\n", target->emit_ir ? "true" : "false");
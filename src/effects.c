@@ -0,0 +1,538 @@
+#include "effects.h"
+#include "token.h"
+#include <string.h>
+
+// how a place expression is used
+typedef enum EffectsAccess
+{
+    EFFECTS_READ,
+    EFFECTS_WRITE,
+    EFFECTS_ADDRESS, // '?place': the address flows on, nothing is accessed yet
+} EffectsAccess;
+
+// state while scanning one function body
+typedef struct EffectsScan
+{
+    FunEffects result;
+    uint64_t   captured;   // pointer parameters whose value escapes the uses we follow
+    uint64_t   written;    // pointer parameters stored through
+    uint64_t   reassigned; // pointer parameters assigned to or whose slot escapes; they may point anywhere
+} EffectsScan;
+
+static void effects_scan_expr(EffectsScan *scan, AstNode *expr);
+static void effects_scan_place(EffectsScan *scan, AstNode *expr, EffectsAccess access);
+
+static Symbol *effects_origin(Symbol *symbol)
+{
+    while (symbol && symbol->import_origin && symbol->import_origin != symbol)
+        symbol = symbol->import_origin;
+    return symbol;
+}
+
+static bool effects_is_pointer(Type *type)
+{
+    type = type_resolve_alias(type);
+    return type && (type->kind == TYPE_POINTER || type->kind == TYPE_PTR);
+}
+
+// pointer parameters of a signature, one bit each; parameters past 64 are never attributed
+static uint64_t effects_pointer_params(Type *signature)
+{
+    signature = type_resolve_alias(signature);
+    if (!signature || signature->kind != TYPE_FUNCTION)
+        return 0;
+
+    uint64_t mask = 0;
+    for (size_t i = 0; i < signature->function.param_count && i < 64; i++)
+    {
+        if (effects_is_pointer(signature->function.param_types[i]))
+            mask |= 1ULL << i;
+    }
+    return mask;
+}
+
+// index of the pointer parameter a bare identifier names, or -1
+static int effects_param(AstNode *expr)
+{
+    if (!expr || expr->kind != AST_EXPR_IDENT || !expr->symbol || expr->symbol->kind != SYMBOL_PARAM)
+        return -1;
+    if (expr->symbol->param.index >= 64 || !effects_is_pointer(expr->symbol->type))
+        return -1;
+    return (int)expr->symbol->param.index;
+}
+
+// '?name' of a local or parameter slot: memory the caller owns and nobody else sees
+static bool effects_is_local_address(AstNode *expr)
+{
+    if (!expr || expr->kind != AST_EXPR_UNARY || expr->unary_expr.op != TOKEN_QUESTION)
+        return false;
+
+    AstNode *operand = expr->unary_expr.expr;
+    Symbol  *symbol  = operand->kind == AST_EXPR_IDENT ? operand->symbol : NULL;
+    if (!symbol)
+        return false;
+    return symbol->kind == SYMBOL_PARAM || ((symbol->kind == SYMBOL_VAR || symbol->kind == SYMBOL_VAL) && !symbol->var.is_global);
+}
+
+static void effects_access_other(EffectsScan *scan, EffectsAccess access)
+{
+    if (access == EFFECTS_READ)
+        scan->result.memory |= FUN_EFFECT_OTHER_READ;
+    else if (access == EFFECTS_WRITE)
+        scan->result.memory |= FUN_EFFECT_OTHER_WRITE;
+}
+
+static void effects_scan_variable(EffectsScan *scan, AstNode *expr, Symbol *symbol, EffectsAccess access)
+{
+    symbol = effects_origin(symbol);
+    if (!symbol)
+        return;
+
+    // a pointer parameter's slot handed out lets anyone read or replace the pointer
+    if (symbol->kind == SYMBOL_PARAM && access != EFFECTS_READ)
+    {
+        int param = effects_param(expr);
+        if (param >= 0)
+        {
+            scan->reassigned |= 1ULL << param;
+            if (access == EFFECTS_ADDRESS)
+                scan->captured |= 1ULL << param;
+        }
+        return;
+    }
+
+    // locals live in the frame and global vals are constant
+    if (symbol->kind == SYMBOL_VAR && symbol->var.is_global)
+        effects_access_other(scan, access);
+}
+
+// memory reached by dereferencing pointer
+static void effects_through(EffectsScan *scan, AstNode *pointer, EffectsAccess access)
+{
+    int param = effects_param(pointer);
+    if (param < 0)
+    {
+        effects_scan_expr(scan, pointer);
+        effects_access_other(scan, access);
+        return;
+    }
+
+    // once reassigned, the parameter may hold any pointer as well as the argument
+    if ((scan->reassigned >> param) & 1)
+        effects_access_other(scan, access);
+
+    // a derived address may be stored or written through anywhere
+    if (access == EFFECTS_ADDRESS)
+    {
+        scan->captured |= 1ULL << param;
+    }
+    else if (access == EFFECTS_WRITE)
+    {
+        scan->written |= 1ULL << param;
+        scan->result.memory |= FUN_EFFECT_ARG_WRITE;
+    }
+    else
+    {
+        scan->result.memory |= FUN_EFFECT_ARG_READ;
+    }
+}
+
+static void effects_scan_place(EffectsScan *scan, AstNode *expr, EffectsAccess access)
+{
+    switch (expr->kind)
+    {
+    case AST_EXPR_IDENT:
+        effects_scan_variable(scan, expr, expr->symbol, access);
+        return;
+
+    case AST_EXPR_UNARY:
+        if (expr->unary_expr.op != TOKEN_AT)
+            break;
+        effects_through(scan, expr->unary_expr.expr, access);
+        return;
+
+    case AST_EXPR_INDEX:
+    {
+        Type *type = type_resolve_alias(expr->index_expr.array->type);
+        effects_scan_expr(scan, expr->index_expr.index);
+        if (!type)
+            break;
+
+        if (type->kind == TYPE_ARRAY && type->array.is_slice)
+        {
+            if (!expr->index_expr.bounds_safe)
+                scan->result.memory |= FUN_EFFECT_TRAP;
+            effects_scan_expr(scan, expr->index_expr.array);
+            effects_access_other(scan, access);
+        }
+        else if (type->kind == TYPE_POINTER || type->kind == TYPE_PTR)
+        {
+            effects_through(scan, expr->index_expr.array, access);
+        }
+        else
+        {
+            // arrays and vectors hold their elements inline
+            effects_scan_place(scan, expr->index_expr.array, access);
+        }
+        return;
+    }
+
+    case AST_EXPR_FIELD:
+    {
+        AstNode *object = expr->field_expr.object;
+        if (object->kind == AST_EXPR_IDENT && object->symbol && object->symbol->kind == SYMBOL_MODULE)
+        {
+            effects_scan_variable(scan, expr, expr->symbol, access);
+            return;
+        }
+
+        Type *type = type_resolve_alias(object->type);
+        if (type && type->kind == TYPE_POINTER)
+            effects_through(scan, object, access);
+        else
+            effects_scan_place(scan, object, access);
+        return;
+    }
+
+    default:
+        break;
+    }
+
+    // calls, literals and other temporaries
+    effects_scan_expr(scan, expr);
+}
+
+static bool effects_name_in(const char *name, const char *const *names, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (strcmp(name, names[i]) == 0)
+            return true;
+    }
+    return false;
+}
+
+static void effects_scan_args(EffectsScan *scan, AstList *args, int first)
+{
+    for (int i = first; args && i < args->count; i++)
+        effects_scan_expr(scan, args->items[i]);
+}
+
+static void effects_scan_intrinsic(EffectsScan *scan, AstNode *expr, const char *name)
+{
+    static const char *const unevaluated[] = {"size_of", "align_of", "offset_of", "type_of"};
+    static const char *const values[]      = {"va_count", "likely", "unlikely", "popcount", "clz", "ctz", "bswap", "rotl", "rotr", "vec_splat", "vec_shuffle"};
+
+    AstList  *args  = expr->call_expr.args;
+    int       count = args ? args->count : 0;
+    AstNode **items = args ? args->items : NULL;
+
+    if (effects_name_in(name, unevaluated, sizeof(unevaluated) / sizeof(unevaluated[0])))
+        return;
+
+    if (effects_name_in(name, values, sizeof(values) / sizeof(values[0])) || strncmp(name, "vec_reduce_", strlen("vec_reduce_")) == 0)
+    {
+        effects_scan_args(scan, args, 0);
+        return;
+    }
+
+    // variadic accessors read the caller's packed block and check the index
+    if (strcmp(name, "va_arg") == 0 || strcmp(name, "va_type") == 0)
+    {
+        effects_scan_args(scan, args, 0);
+        scan->result.memory |= FUN_EFFECT_OTHER_READ | FUN_EFFECT_TRAP;
+        return;
+    }
+
+    if ((strcmp(name, "mem_copy") == 0 || strcmp(name, "mem_move") == 0) && count == 3)
+    {
+        effects_through(scan, items[0], EFFECTS_WRITE);
+        effects_through(scan, items[1], EFFECTS_READ);
+        effects_scan_expr(scan, items[2]);
+        return;
+    }
+
+    // prefetch is modelled as a write so callers never treat the line as read-only
+    bool writes_first = strcmp(name, "mem_set") == 0 || strcmp(name, "vec_store") == 0 || strcmp(name, "prefetch") == 0;
+    if ((writes_first || strcmp(name, "vec_load") == 0) && count >= 1)
+    {
+        effects_through(scan, items[0], writes_first ? EFFECTS_WRITE : EFFECTS_READ);
+        effects_scan_args(scan, args, 1);
+        return;
+    }
+
+    // ordered atomics synchronise with other threads, so they touch everything
+    if (strncmp(name, "atomic_", strlen("atomic_")) == 0 && count >= 1)
+    {
+        effects_through(scan, items[0], strcmp(name, "atomic_load") == 0 ? EFFECTS_READ : EFFECTS_WRITE);
+        effects_scan_args(scan, args, 1);
+        scan->result.memory |= FUN_EFFECT_OTHER_READ | FUN_EFFECT_OTHER_WRITE;
+        return;
+    }
+
+    // fence and anything not listed above
+    effects_scan_args(scan, args, 0);
+    scan->result.memory |= FUN_EFFECT_OTHER_READ | FUN_EFFECT_OTHER_WRITE;
+}
+
+static void effects_scan_call(EffectsScan *scan, AstNode *expr)
+{
+    AstNode *func   = expr->call_expr.func;
+    AstList *args   = expr->call_expr.args;
+    Symbol  *callee = effects_origin(func->symbol);
+
+    if (!callee && func->kind == AST_EXPR_IDENT)
+    {
+        effects_scan_intrinsic(scan, expr, func->ident_expr.name);
+        return;
+    }
+
+    // externals, generic templates and calls through pointers may do anything
+    FunEffects callee_effects = {0};
+    if (callee && callee->kind == SYMBOL_FUNC)
+        callee_effects = callee->func.effects;
+    else
+        effects_scan_expr(scan, func);
+
+    if (!callee_effects.inferred)
+        callee_effects.memory = FUN_EFFECT_OTHER_READ | FUN_EFFECT_OTHER_WRITE;
+    if (callee && callee->kind == SYMBOL_FUNC && callee->func.hints.is_noreturn)
+        callee_effects.willreturn = false;
+
+    scan->result.memory |= callee_effects.memory & (FUN_EFFECT_OTHER_READ | FUN_EFFECT_OTHER_WRITE | FUN_EFFECT_TRAP);
+    scan->result.nounwind   = scan->result.nounwind && callee_effects.nounwind;
+    scan->result.willreturn = scan->result.willreturn && callee_effects.willreturn;
+
+    // callee argument memory becomes ours, the caller's own frame, or anybody's
+    uint8_t  arg_memory = callee_effects.memory & (FUN_EFFECT_ARG_READ | FUN_EFFECT_ARG_WRITE);
+    uint64_t pointers   = callee_effects.inferred ? effects_pointer_params(callee->type) : 0;
+    for (int i = 0; args && i < args->count; i++)
+    {
+        AstNode *arg     = args->items[i];
+        bool     pointer = i < 64 && ((pointers >> i) & 1);
+        int      param   = effects_param(arg);
+
+        if (pointer && param >= 0 && ((callee_effects.nocapture >> i) & 1))
+        {
+            if (!((callee_effects.readonly >> i) & 1))
+                scan->written |= 1ULL << param;
+            scan->result.memory |= arg_memory;
+            if ((scan->reassigned >> param) & 1)
+                scan->result.memory |= arg_memory << 2;
+            continue;
+        }
+
+        effects_scan_expr(scan, arg);
+        if (pointer && !effects_is_local_address(arg))
+            scan->result.memory |= arg_memory << 2; // ARG_* to OTHER_*
+    }
+}
+
+static void effects_scan_binary(EffectsScan *scan, AstNode *expr)
+{
+    AstNode  *left  = expr->binary_expr.left;
+    AstNode  *right = expr->binary_expr.right;
+    TokenKind op    = expr->binary_expr.op;
+
+    if (op == TOKEN_EQUAL)
+    {
+        effects_scan_place(scan, left, EFFECTS_WRITE);
+        effects_scan_expr(scan, right);
+        return;
+    }
+
+    // comparing a parameter against nil reveals nothing about where it points
+    if ((op == TOKEN_EQUAL_EQUAL || op == TOKEN_BANG_EQUAL) && (left->kind == AST_EXPR_NULL || right->kind == AST_EXPR_NULL))
+    {
+        if (effects_param(left->kind == AST_EXPR_NULL ? right : left) >= 0)
+            return;
+    }
+
+    effects_scan_expr(scan, left);
+    effects_scan_expr(scan, right);
+}
+
+static void effects_scan_expr(EffectsScan *scan, AstNode *expr)
+{
+    if (!expr)
+        return;
+
+    switch (expr->kind)
+    {
+    case AST_EXPR_IDENT:
+    {
+        // a pointer parameter used as a plain value flows somewhere we do not follow
+        int param = effects_param(expr);
+        if (param >= 0)
+            scan->captured |= 1ULL << param;
+        else
+            effects_scan_variable(scan, expr, expr->symbol, EFFECTS_READ);
+        break;
+    }
+
+    case AST_EXPR_INDEX:
+    case AST_EXPR_FIELD:
+        effects_scan_place(scan, expr, EFFECTS_READ);
+        break;
+
+    case AST_EXPR_UNARY:
+        if (expr->unary_expr.op == TOKEN_AT)
+            effects_through(scan, expr->unary_expr.expr, EFFECTS_READ);
+        else if (expr->unary_expr.op == TOKEN_QUESTION)
+            effects_scan_place(scan, expr->unary_expr.expr, EFFECTS_ADDRESS);
+        else
+            effects_scan_expr(scan, expr->unary_expr.expr);
+        break;
+
+    case AST_EXPR_BINARY:
+        effects_scan_binary(scan, expr);
+        break;
+
+    case AST_EXPR_CALL:
+        effects_scan_call(scan, expr);
+        break;
+
+    case AST_EXPR_CAST:
+        effects_scan_expr(scan, expr->cast_expr.expr);
+        break;
+
+    case AST_EXPR_ARRAY:
+        effects_scan_args(scan, expr->array_expr.elems, 0);
+        break;
+
+    case AST_EXPR_STRUCT:
+        for (int i = 0; expr->struct_expr.fields && i < expr->struct_expr.fields->count; i++)
+            effects_scan_expr(scan, expr->struct_expr.fields->items[i]->field_expr.object);
+        break;
+
+    case AST_EXPR_VARARGS:
+        // forwarding copies out of the caller's packed block
+        scan->result.memory |= FUN_EFFECT_OTHER_READ;
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void effects_scan_stmt(EffectsScan *scan, AstNode *stmt)
+{
+    if (!stmt)
+        return;
+
+    switch (stmt->kind)
+    {
+    case AST_STMT_BLOCK:
+        for (int i = 0; stmt->block_stmt.stmts && i < stmt->block_stmt.stmts->count; i++)
+            effects_scan_stmt(scan, stmt->block_stmt.stmts->items[i]);
+        break;
+
+    case AST_STMT_VAL:
+    case AST_STMT_VAR:
+        // evaluated initializers never run
+        if (!stmt->var_stmt.comptime_value)
+            effects_scan_expr(scan, stmt->var_stmt.init);
+        break;
+
+    case AST_STMT_EXPR:
+        effects_scan_expr(scan, stmt->expr_stmt.expr);
+        break;
+
+    case AST_STMT_RET:
+        effects_scan_expr(scan, stmt->ret_stmt.expr);
+        break;
+
+    case AST_STMT_IF:
+    case AST_STMT_OR:
+        effects_scan_expr(scan, stmt->cond_stmt.cond);
+        effects_scan_stmt(scan, stmt->cond_stmt.body);
+        effects_scan_stmt(scan, stmt->cond_stmt.stmt_or);
+        break;
+
+    case AST_STMT_FOR:
+        // termination of loops is not proven
+        scan->result.willreturn = false;
+        if (stmt->for_stmt.bounds_hoisted && stmt->for_stmt.bounds_hoisted->count > 0)
+            scan->result.memory |= FUN_EFFECT_TRAP;
+        effects_scan_expr(scan, stmt->for_stmt.cond);
+        effects_scan_stmt(scan, stmt->for_stmt.body);
+        break;
+
+    case AST_STMT_ASM:
+        scan->result.memory |= FUN_EFFECT_OTHER_READ | FUN_EFFECT_OTHER_WRITE;
+        scan->result.willreturn = false;
+        break;
+
+    default:
+        break;
+    }
+}
+
+static FunEffects effects_scan_function(Symbol *function)
+{
+    // the scan ignores statement order, so a dereference seen before the assignment that retargets
+    // its parameter is only classified correctly on a second scan that starts from the full set
+    EffectsScan scan       = {0};
+    uint64_t    reassigned = 0;
+    for (;;)
+    {
+        scan                   = (EffectsScan){0};
+        scan.reassigned        = reassigned;
+        scan.result.inferred   = true;
+        scan.result.nounwind   = true;
+        scan.result.willreturn = !function->func.hints.is_noreturn;
+
+        effects_scan_stmt(&scan, function->decl->fun_stmt.body);
+        if (scan.reassigned == reassigned)
+            break;
+        reassigned = scan.reassigned;
+    }
+
+    // an aborting bounds check never returns
+    if (scan.result.memory & FUN_EFFECT_TRAP)
+        scan.result.willreturn = false;
+
+    // a captured pointer may be written through later, so readonly implies nocapture here
+    uint64_t pointers     = effects_pointer_params(function->type);
+    scan.result.nocapture = pointers & ~scan.captured;
+    scan.result.readonly  = scan.result.nocapture & ~scan.written;
+    return scan.result;
+}
+
+static bool effects_equal(const FunEffects *a, const FunEffects *b)
+{
+    return a->inferred == b->inferred && a->nounwind == b->nounwind && a->willreturn == b->willreturn && a->memory == b->memory && a->nocapture == b->nocapture &&
+           a->readonly == b->readonly;
+}
+
+void effects_infer(Symbol **functions, size_t count)
+{
+    // optimistic about memory, unwinding and captures, pessimistic about termination;
+    // every rescan only moves each fact one way, so the loop reaches a fixpoint
+    for (size_t i = 0; i < count; i++)
+    {
+        uint64_t    pointers = effects_pointer_params(functions[i]->type);
+        FunEffects *effects  = &functions[i]->func.effects;
+        effects->inferred    = true;
+        effects->nounwind    = true;
+        effects->willreturn  = false;
+        effects->memory      = 0;
+        effects->nocapture   = pointers;
+        effects->readonly    = pointers;
+    }
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t i = 0; i < count; i++)
+        {
+            FunEffects next = effects_scan_function(functions[i]);
+            if (!effects_equal(&next, &functions[i]->func.effects))
+            {
+                functions[i]->func.effects = next;
+                changed                    = true;
+            }
+        }
+    }
+}
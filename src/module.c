@@ -17,6 +17,7 @@
 // forward declarations
 static char       *generate_target_module_source(ModuleManager *manager);
 static void        module_manager_update_target_info(ModuleManager *manager);
+static void        module_manager_resolve_cpu(ModuleManager *manager, const char *cpu, const char *features);
 static char       *append_os_suffix(const char *path, const char *os_name);
 static const char *normalize_os_name(const char *os_part);
 static bool        path_has_platform_suffix(const char *path, const char *os_name);
@@ -268,12 +269,16 @@ void module_manager_init(ModuleManager *manager)
     manager->target_triple = NULL;
     manager->target_os     = NULL;
     manager->target_arch   = NULL;
+    manager->target_cpu    = NULL;
+    manager->target_feats  = NULL;
 
     manager->cached_constants       = NULL;
     manager->cached_constants_count = 0;
 
     module_error_list_init(&manager->errors);
-    manager->had_error = false;
+    manager->had_error         = false;
+    manager->verbose           = false;
+    manager->prune_unreachable = false;
 
     module_manager_update_target_info(manager);
 }
@@ -313,6 +318,8 @@ void module_manager_dnit(ModuleManager *manager)
     free(manager->target_triple);
     free(manager->target_os);
     free(manager->target_arch);
+    free(manager->target_cpu);
+    free(manager->target_feats);
 
     free(manager->cached_constants);
 
@@ -473,6 +480,8 @@ static void module_manager_update_target_info(ModuleManager *manager)
         return;
 
     const char *triple       = NULL;
+    const char *cpu          = NULL;
+    const char *features     = NULL;
     char       *owned_triple = NULL;
 
     if (manager->config)
@@ -481,6 +490,11 @@ static void module_manager_update_target_info(ModuleManager *manager)
         TargetConfig  *tc = config_get_default_target(pc);
         if (tc && tc->target_triple)
             triple = tc->target_triple;
+        if (tc)
+        {
+            cpu      = tc->cpu;
+            features = tc->features;
+        }
     }
 
     if (!triple)
@@ -525,15 +539,78 @@ static void module_manager_update_target_info(ModuleManager *manager)
     if (owned_triple)
         LLVMDisposeMessage(owned_triple);
 
+    // resolves cpu/features and rebuilds cached constants
+    module_manager_resolve_cpu(manager, cpu, features);
+}
+
+static bool module_manager_targets_host(ModuleManager *manager)
+{
+    char *host    = LLVMGetDefaultTargetTriple();
+    bool  is_host = !manager->target_triple || (host && strcmp(host, manager->target_triple) == 0);
+    LLVMDisposeMessage(host);
+    return is_host;
+}
+
+static void module_manager_resolve_cpu(ModuleManager *manager, const char *cpu, const char *features)
+{
+    free(manager->target_cpu);
+    free(manager->target_feats);
+    manager->target_cpu   = NULL;
+    manager->target_feats = NULL;
+
+    // host tuning only applies when no cpu is requested and we are not cross compiling
+    bool use_host = (cpu && (strcmp(cpu, "native") == 0 || strcmp(cpu, "host") == 0)) || (!cpu && module_manager_targets_host(manager));
+
+    char *host_features = NULL;
+    if (use_host)
+    {
+        char *host_cpu      = LLVMGetHostCPUName();
+        manager->target_cpu = strdup(host_cpu);
+        LLVMDisposeMessage(host_cpu);
+        host_features = LLVMGetHostCPUFeatures();
+    }
+    else
+    {
+        manager->target_cpu = strdup(cpu ? cpu : "generic");
+    }
+
+    // explicit features come last so they override host defaults
+    const char *base      = host_features ? host_features : "";
+    const char *extra     = features ? features : "";
+    size_t      len       = strlen(base) + 1 + strlen(extra) + 1;
+    manager->target_feats = malloc(len);
+    if (manager->target_feats)
+        snprintf(manager->target_feats, len, "%s%s%s", base, (base[0] && extra[0]) ? "," : "", extra);
+    if (host_features)
+        LLVMDisposeMessage(host_features);
+
     // rebuild cached constants
     free(manager->cached_constants);
-    manager->cached_constants       = malloc(32 * sizeof(PreprocessorConstant));
+    manager->cached_constants       = malloc(PREPROCESSOR_MAX_CONSTANTS * sizeof(PreprocessorConstant));
     manager->cached_constants_count = 0;
 
     if (manager->cached_constants)
     {
-        manager->cached_constants_count = module_manager_collect_constants(manager, manager->cached_constants, 32);
+        manager->cached_constants_count = module_manager_collect_constants(manager, manager->cached_constants, PREPROCESSOR_MAX_CONSTANTS);
+    }
+}
+
+void module_manager_set_target_cpu(ModuleManager *manager, const char *cpu, const char *features)
+{
+    if (!manager || (!cpu && !features))
+        return;
+
+    // command line values override the target config
+    if (manager->config)
+    {
+        TargetConfig *tc = config_get_default_target((ProjectConfig *)manager->config);
+        if (tc && !cpu)
+            cpu = tc->cpu;
+        if (tc && !features)
+            features = tc->features;
     }
+
+    module_manager_resolve_cpu(manager, cpu, features);
 }
 
 void module_manager_add_search_path(ModuleManager *manager, const char *path)
@@ -759,7 +836,7 @@ static Module *module_manager_load_module_internal(ModuleManager *manager, const
             free(platform_path);
         }
 
-        PreprocessorConstant constants[32];
+        PreprocessorConstant constants[PREPROCESSOR_MAX_CONSTANTS];
         size_t               constant_count = module_manager_collect_constants(manager, constants, sizeof(constants) / sizeof(constants[0]));
 
         PreprocessorOutput pp_output;
@@ -906,6 +983,46 @@ static unsigned int map_arch_id(const char *arch_part)
     return 255u; // unknown
 }
 
+// cpu features exposed to #! conditions as FEAT_* constants (1 when enabled)
+static const struct
+{
+    const char *feature;
+    const char *constant;
+} target_feature_constants[] = {
+    {"sse4.2", "FEAT_SSE4_2"},
+    {"avx", "FEAT_AVX"},
+    {"avx2", "FEAT_AVX2"},
+    {"avx512f", "FEAT_AVX512F"},
+    {"fma", "FEAT_FMA"},
+    {"bmi2", "FEAT_BMI2"},
+    {"popcnt", "FEAT_POPCNT"},
+    {"aes", "FEAT_AES"},
+    {"neon", "FEAT_NEON"},
+    {"sve", "FEAT_SVE"},
+    {"crc", "FEAT_CRC"},
+};
+
+// check a comma separated "+a,-b" feature list; later entries win
+static bool target_feature_enabled(const char *features, const char *name)
+{
+    if (!features)
+        return false;
+
+    bool   enabled  = false;
+    size_t name_len = strlen(name);
+    for (const char *p = features; *p;)
+    {
+        const char *end = strchr(p, ',');
+        size_t      len = end ? (size_t)(end - p) : strlen(p);
+        if (len == name_len + 1 && (p[0] == '+' || p[0] == '-') && strncmp(p + 1, name, name_len) == 0)
+            enabled = (p[0] == '+');
+        p += len;
+        if (*p == ',')
+            p++;
+    }
+    return enabled;
+}
+
 size_t module_manager_collect_constants(ModuleManager *manager, PreprocessorConstant *out, size_t max_count)
 {
     if (!out || max_count == 0)
@@ -981,6 +1098,12 @@ size_t module_manager_collect_constants(ModuleManager *manager, PreprocessorCons
     ADD_CONST("ENDIAN", endian);
     ADD_CONST("DEBUG", debug_flag);
 
+    for (size_t i = 0; i < sizeof(target_feature_constants) / sizeof(target_feature_constants[0]); i++)
+    {
+        if (manager && target_feature_enabled(manager->target_feats, target_feature_constants[i].feature))
+            ADD_CONST(target_feature_constants[i].constant, 1u);
+    }
+
 #undef ADD_CONST
 
     free(arch_part);
@@ -1199,7 +1322,7 @@ bool module_has_circular_dependency(ModuleManager *manager, Module *module, cons
 }
 
 // helper declarations
-static bool compile_module_to_object(ModuleManager *manager, Module *module, const char *output_dir, int opt_level, bool no_pie, bool debug_info, SpecializationCache *spec_cache);
+static bool compile_module_to_object(ModuleManager *manager, Module *module, const char *output_dir, int opt_level, const CodegenPipeline *pipeline, bool no_pie, bool debug_info, SpecializationCache *spec_cache);
 
 char *module_make_object_path(const char *output_dir, const char *module_name)
 {
@@ -1241,7 +1364,7 @@ char *module_make_object_path(const char *output_dir, const char *module_name)
     return path;
 }
 
-bool module_manager_compile_dependencies(ModuleManager *manager, const char *output_dir, int opt_level, bool no_pie, bool debug_info, SpecializationCache *spec_cache)
+bool module_manager_compile_dependencies(ModuleManager *manager, const char *output_dir, int opt_level, const CodegenPipeline *pipeline, bool no_pie, bool debug_info, SpecializationCache *spec_cache)
 {
     if (!manager)
         return false;
@@ -1279,7 +1402,7 @@ bool module_manager_compile_dependencies(ModuleManager *manager, const char *out
 
             // no info output
 
-            if (!compile_module_to_object(manager, module, output_dir, opt_level, no_pie, debug_info, spec_cache))
+            if (!compile_module_to_object(manager, module, output_dir, opt_level, pipeline, no_pie, debug_info, spec_cache))
             {
                 return false;
             }
@@ -1339,7 +1462,7 @@ bool module_manager_get_link_objects(ModuleManager *manager, char ***object_file
     return true;
 }
 
-static bool compile_module_to_object(ModuleManager *manager, Module *module, const char *output_dir, int opt_level, bool no_pie, bool debug_info, SpecializationCache *spec_cache)
+static bool compile_module_to_object(ModuleManager *manager, Module *module, const char *output_dir, int opt_level, const CodegenPipeline *pipeline, bool no_pie, bool debug_info, SpecializationCache *spec_cache)
 {
     if (!module || !module->ast)
         return false;
@@ -1360,12 +1483,16 @@ static bool compile_module_to_object(ModuleManager *manager, Module *module, con
     module->object_path = object_path;
 
     CodegenContext ctx;
-    codegen_context_init(&ctx, module->name, no_pie);
+    codegen_context_init(&ctx, module->name, manager->target_triple, manager->target_cpu, manager->target_feats, no_pie);
     ctx.opt_level    = opt_level;
-    ctx.debug_info   = debug_info;
-    ctx.source_file  = module->file_path;
-    ctx.source_lexer = NULL;
-    ctx.spec_cache   = spec_cache; // pass cache to codegen for generating specialized functions
+    if (pipeline)
+        ctx.pipeline = *pipeline;
+    ctx.verbose           = manager->verbose;
+    ctx.debug_info        = debug_info;
+    ctx.source_file       = module->file_path;
+    ctx.source_lexer      = NULL;
+    ctx.spec_cache        = spec_cache; // pass cache to codegen for generating specialized functions
+    ctx.prune_unreachable = manager->prune_unreachable;
 
     Lexer *debug_lexer_ptr = NULL;
     Lexer  debug_lexer;
@@ -1403,5 +1530,14 @@ static bool compile_module_to_object(ModuleManager *manager, Module *module, con
     // no need to free debug_source - using cached module source
 
     codegen_context_dnit(&ctx);
+
+    // the object is on disk: only the signatures other modules import are still needed
+    // (this shrinks what later modules' codegen runs beside, not the peak reached during analysis)
+    if (success)
+    {
+        ast_release_bodies(module->ast);
+        free(module->source);
+        module->source = NULL;
+    }
     return success;
 }
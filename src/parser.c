@@ -104,167 +104,386 @@ static char *parser_take_pending_mangle(Parser *parser)
     return value;
 }
 
-static void parser_handle_comment(Parser *parser, Token *token)
+static LoopHints parser_take_loop_hints(Parser *parser)
 {
-    if (!parser || !token)
+    LoopHints hints = parser->pending_loop_hints;
+    memset(&parser->pending_loop_hints, 0, sizeof(LoopHints));
+    parser->has_loop_hints = false;
+    return hints;
+}
+
+static FunHints parser_take_fun_hints(Parser *parser)
+{
+    FunHints hints = parser->pending_fun_hints;
+    memset(&parser->pending_fun_hints, 0, sizeof(FunHints));
+    parser->has_fun_hints = false;
+    return hints;
+}
+
+static void parser_drop_fun_hints(Parser *parser)
+{
+    FunHints hints = parser_take_fun_hints(parser);
+    free(hints.section);
+}
+
+// matches a directive name that is not the prefix of a longer identifier
+static bool parser_match_directive(const char **cursor, const char *name)
+{
+    size_t len = strlen(name);
+    if (strncmp(*cursor, name, len) != 0)
     {
-        return;
+        return false;
     }
 
-    char *raw = lexer_raw_value(parser->lexer, token);
-    if (!raw)
+    char next = (*cursor)[len];
+    if (isalnum((unsigned char)next) || next == '_')
     {
-        return;
+        return false;
     }
 
-    if (strncmp(raw, "#@", 2) != 0)
+    *cursor += len;
+    return true;
+}
+
+// checks that nothing but whitespace follows a directive
+static bool parser_directive_end(Parser *parser, Token *token, const char *cursor, const char *name)
+{
+    while (isspace((unsigned char)*cursor))
     {
-        free(raw);
-        return;
+        cursor++;
     }
 
-    const char *cursor = raw + 2;
+    if (*cursor != '\0')
+    {
+        char message[128];
+        snprintf(message, sizeof(message), "unexpected characters after '#@%s' directive", name);
+        parser_error(parser, token, message);
+        return false;
+    }
+    return true;
+}
+
+// parses '(n)' with a positive integer n and the end of the directive
+static bool parser_directive_int_arg(Parser *parser, Token *token, const char *cursor, const char *name, int *out)
+{
     while (isspace((unsigned char)*cursor))
     {
         cursor++;
     }
 
-    if (strncmp(cursor, "symbol", 6) == 0)
+    char *end   = NULL;
+    long  value = 0;
+    if (*cursor == '(')
     {
-        cursor += 6;
-        while (isspace((unsigned char)*cursor))
+        value = strtol(cursor + 1, &end, 10);
+        while (end && isspace((unsigned char)*end))
         {
-            cursor++;
+            end++;
         }
+    }
 
-        if (*cursor != '(')
-        {
-            parser_error(parser, token, "expected '(' after '#@symbol'");
-            parser_set_pending_mangle(parser, NULL);
-            free(raw);
-            return;
-        }
+    if (!end || end == cursor + 1 || *end != ')' || value <= 0 || value > 65536)
+    {
+        char message[128];
+        snprintf(message, sizeof(message), "'#@%s' expects a positive integer, e.g. '#@%s(4)'", name, name);
+        parser_error(parser, token, message);
+        return false;
+    }
+
+    if (!parser_directive_end(parser, token, end + 1, name))
+    {
+        return false;
+    }
+
+    *out = (int)value;
+    return true;
+}
+
+static bool parser_directive_string_error(Parser *parser, Token *token, const char *format, const char *name, char *buffer)
+{
+    char message[128];
+    snprintf(message, sizeof(message), format, name);
+    parser_error(parser, token, message);
+    free(buffer);
+    return false;
+}
+
+// parses '("text")' with the usual escapes and the end of the directive; *out is heap-allocated
+static bool parser_directive_string_arg(Parser *parser, Token *token, const char *cursor, const char *name, char **out)
+{
+    *out = NULL;
+    while (isspace((unsigned char)*cursor))
+    {
         cursor++;
+    }
 
-        while (isspace((unsigned char)*cursor))
-        {
-            cursor++;
-        }
+    if (*cursor != '(')
+    {
+        return parser_directive_string_error(parser, token, "expected '(' after '#@%s'", name, NULL);
+    }
+    cursor++;
 
-        if (*cursor != '"')
+    while (isspace((unsigned char)*cursor))
+    {
+        cursor++;
+    }
+
+    if (*cursor != '"')
+    {
+        return parser_directive_string_error(parser, token, "expected string literal in '#@%s'", name, NULL);
+    }
+    cursor++;
+
+    size_t buffer_cap = strlen(cursor) + 1;
+    char  *buffer     = malloc(buffer_cap);
+    if (!buffer)
+    {
+        return parser_directive_string_error(parser, token, "memory allocation failed for '#@%s'", name, NULL);
+    }
+
+    size_t buffer_len = 0;
+    while (*cursor && *cursor != '"')
+    {
+        char ch = *cursor++;
+        if (ch == '\\')
         {
-            parser_error(parser, token, "expected string literal in '#@symbol'");
-            parser_set_pending_mangle(parser, NULL);
-            free(raw);
-            return;
+            if (*cursor == '\0')
+            {
+                break;
+            }
+            char esc = *cursor++;
+            switch (esc)
+            {
+            case 'n':
+                ch = '\n';
+                break;
+            case 'r':
+                ch = '\r';
+                break;
+            case 't':
+                ch = '\t';
+                break;
+            default:
+                ch = esc;
+                break;
+            }
         }
+
+        // the literal never grows past the raw text, so buffer_cap always suffices
+        buffer[buffer_len++] = ch;
+    }
+
+    if (*cursor != '"')
+    {
+        return parser_directive_string_error(parser, token, "unterminated string in '#@%s'", name, buffer);
+    }
+
+    buffer[buffer_len] = '\0';
+    cursor++;
+
+    while (isspace((unsigned char)*cursor))
+    {
         cursor++;
+    }
+
+    if (*cursor != ')')
+    {
+        return parser_directive_string_error(parser, token, "expected ')' after '#@%s' string", name, buffer);
+    }
 
-        size_t buffer_cap = strlen(cursor) + 1;
-        char  *buffer     = malloc(buffer_cap);
-        if (!buffer)
+    if (!parser_directive_end(parser, token, cursor + 1, name))
+    {
+        free(buffer);
+        return false;
+    }
+
+    *out = buffer;
+    return true;
+}
+
+// #@cold, #@hot, #@inline, #@noinline, #@flatten, #@noreturn, #@align(n) and #@section("name")
+static bool parser_handle_fun_directive(Parser *parser, Token *token, const char *cursor)
+{
+    FunHints   *hints = &parser->pending_fun_hints;
+    bool       *flag  = NULL;
+    const char *name  = NULL;
+
+    if (parser_match_directive(&cursor, "cold"))
+    {
+        flag = &hints->is_cold;
+        name = "cold";
+    }
+    else if (parser_match_directive(&cursor, "hot"))
+    {
+        flag = &hints->is_hot;
+        name = "hot";
+    }
+    else if (parser_match_directive(&cursor, "inline"))
+    {
+        flag = &hints->is_inline;
+        name = "inline";
+    }
+    else if (parser_match_directive(&cursor, "noinline"))
+    {
+        flag = &hints->is_noinline;
+        name = "noinline";
+    }
+    else if (parser_match_directive(&cursor, "flatten"))
+    {
+        flag = &hints->is_flatten;
+        name = "flatten";
+    }
+    else if (parser_match_directive(&cursor, "noreturn"))
+    {
+        flag = &hints->is_noreturn;
+        name = "noreturn";
+    }
+
+    if (flag)
+    {
+        if (parser_directive_end(parser, token, cursor, name))
         {
-            parser_error(parser, token, "memory allocation failed for '#@symbol'");
-            parser_set_pending_mangle(parser, NULL);
-            free(raw);
-            return;
+            *flag                 = true;
+            parser->has_fun_hints = true;
         }
+        return true;
+    }
 
-        size_t buffer_len = 0;
-        bool   ok         = true;
-
-        while (*cursor && *cursor != '"')
+    if (parser_match_directive(&cursor, "align"))
+    {
+        int align = 0;
+        if (parser_directive_int_arg(parser, token, cursor, "align", &align))
         {
-            char ch = *cursor++;
-            if (ch == '\\')
+            if ((align & (align - 1)) != 0)
             {
-                if (*cursor == '\0')
-                {
-                    ok = false;
-                    break;
-                }
-                char esc = *cursor++;
-                switch (esc)
-                {
-                case 'n':
-                    ch = '\n';
-                    break;
-                case 'r':
-                    ch = '\r';
-                    break;
-                case 't':
-                    ch = '\t';
-                    break;
-                case '\\':
-                    ch = '\\';
-                    break;
-                case '"':
-                    ch = '"';
-                    break;
-                default:
-                    ch = esc;
-                    break;
-                }
+                parser_error(parser, token, "'#@align' expects a power of two");
             }
-
-            if (buffer_len + 1 >= buffer_cap)
+            else
             {
-                size_t new_cap = buffer_cap * 2;
-                char  *tmp     = realloc(buffer, new_cap);
-                if (!tmp)
-                {
-                    ok = false;
-                    break;
-                }
-                buffer     = tmp;
-                buffer_cap = new_cap;
+                hints->align          = align;
+                parser->has_fun_hints = true;
             }
-
-            buffer[buffer_len++] = ch;
         }
+        return true;
+    }
 
-        if (!ok || *cursor != '"')
+    if (parser_match_directive(&cursor, "section"))
+    {
+        char *section = NULL;
+        if (parser_directive_string_arg(parser, token, cursor, "section", &section))
         {
-            parser_error(parser, token, "unterminated string in '#@symbol'");
-            free(buffer);
-            parser_set_pending_mangle(parser, NULL);
-            free(raw);
-            return;
+            free(hints->section);
+            hints->section        = section;
+            parser->has_fun_hints = true;
         }
+        return true;
+    }
 
-        buffer[buffer_len] = '\0';
+    return false;
+}
+
+static void parser_handle_comment(Parser *parser, Token *token)
+{
+    if (!parser || !token)
+    {
+        return;
+    }
+
+    char *raw = lexer_raw_value(parser->lexer, token);
+    if (!raw)
+    {
+        return;
+    }
+
+    if (strncmp(raw, "#@", 2) != 0)
+    {
+        free(raw);
+        return;
+    }
+
+    const char *cursor = raw + 2;
+    while (isspace((unsigned char)*cursor))
+    {
         cursor++;
+    }
+
+    if (parser_match_directive(&cursor, "symbol"))
+    {
+        char *value = NULL;
+        parser_directive_string_arg(parser, token, cursor, "symbol", &value);
+        parser_set_pending_mangle(parser, value);
+        free(raw);
+        return;
+    }
 
-        while (isspace((unsigned char)*cursor))
+    // loop annotations apply to the next 'for' statement
+    if (parser_match_directive(&cursor, "vectorize"))
+    {
+        if (parser_directive_int_arg(parser, token, cursor, "vectorize", &parser->pending_loop_hints.vectorize_width))
         {
-            cursor++;
+            parser->has_loop_hints = true;
         }
+        free(raw);
+        return;
+    }
 
-        if (*cursor != ')')
+    if (parser_match_directive(&cursor, "unroll"))
+    {
+        if (parser_directive_int_arg(parser, token, cursor, "unroll", &parser->pending_loop_hints.unroll_count))
         {
-            parser_error(parser, token, "expected ')' after '#@symbol' string");
-            free(buffer);
-            parser_set_pending_mangle(parser, NULL);
-            free(raw);
-            return;
+            parser->has_loop_hints = true;
         }
-        cursor++;
+        free(raw);
+        return;
+    }
 
-        while (isspace((unsigned char)*cursor))
+    if (parser_match_directive(&cursor, "no_unroll"))
+    {
+        if (parser_directive_end(parser, token, cursor, "no_unroll"))
         {
-            cursor++;
+            parser->pending_loop_hints.no_unroll = true;
+            parser->has_loop_hints               = true;
         }
+        free(raw);
+        return;
+    }
 
-        if (*cursor != '\0')
+    // thread-local storage for the next top-level 'var'
+    if (parser_match_directive(&cursor, "thread_local"))
+    {
+        if (parser_directive_end(parser, token, cursor, "thread_local"))
         {
-            parser_error(parser, token, "unexpected characters after '#@symbol' directive");
-            free(buffer);
-            parser_set_pending_mangle(parser, NULL);
-            free(raw);
-            return;
+            parser->pending_thread_local = true;
         }
+        free(raw);
+        return;
+    }
 
-        parser_set_pending_mangle(parser, buffer);
+    // compile-time evaluation of the next 'val' or 'var' initializer
+    if (parser_match_directive(&cursor, "comptime"))
+    {
+        if (parser_directive_end(parser, token, cursor, "comptime"))
+        {
+            parser->pending_comptime = true;
+        }
+        free(raw);
+        return;
+    }
+
+    // keep the next top-level declaration even when nothing references it
+    if (parser_match_directive(&cursor, "keep"))
+    {
+        if (parser_directive_end(parser, token, cursor, "keep"))
+        {
+            parser->pending_keep = true;
+        }
+        free(raw);
+        return;
+    }
+
+    // function annotations apply to the next 'fun' declaration
+    if (parser_handle_fun_directive(parser, token, cursor))
+    {
         free(raw);
         return;
     }
@@ -425,6 +644,13 @@ void parser_init(Parser *parser, Lexer *lexer)
     parser->panic_mode     = false;
     parser->had_error      = false;
     parser->pending_mangle = NULL;
+    parser->has_loop_hints = false;
+    memset(&parser->pending_loop_hints, 0, sizeof(LoopHints));
+    parser->pending_thread_local = false;
+    parser->pending_comptime     = false;
+    parser->pending_keep         = false;
+    parser->has_fun_hints        = false;
+    memset(&parser->pending_fun_hints, 0, sizeof(FunHints));
     parser_error_list_init(&parser->errors);
 
     // prime the parser
@@ -445,6 +671,7 @@ void parser_dnit(Parser *parser)
     }
     free(parser->pending_mangle);
     parser->pending_mangle = NULL;
+    parser_drop_fun_hints(parser);
     parser_error_list_dnit(&parser->errors);
 }
 
@@ -709,6 +936,77 @@ static bool parser_should_parse_type_args(Parser *parser)
     return source[index] == '(';
 }
 
+// true when the current token starts a vec[N]T type; in expressions the closing ']'
+// must be followed by an element type and '{' so 'vec[i]' stays an index
+static bool parser_is_vector_type(Parser *parser, bool literal)
+{
+    if (!parser || !parser->current || parser->current->kind != TOKEN_IDENTIFIER || parser->current->len != 3)
+    {
+        return false;
+    }
+
+    char *source = parser->lexer->source;
+    int   index  = parser->current->pos;
+    if (strncmp(source + index, "vec", 3) != 0)
+    {
+        return false;
+    }
+
+    index += 3;
+    while (isspace((unsigned char)source[index]))
+    {
+        index++;
+    }
+
+    if (source[index] != '[')
+    {
+        return false;
+    }
+
+    if (!literal)
+    {
+        return true;
+    }
+
+    while (source[index] != '\0' && source[index] != ']')
+    {
+        if (source[index] == '\n' || source[index] == ';')
+        {
+            return false;
+        }
+        index++;
+    }
+
+    if (source[index] != ']')
+    {
+        return false;
+    }
+
+    index++;
+    while (isspace((unsigned char)source[index]))
+    {
+        index++;
+    }
+
+    int start = index;
+    while (isalnum((unsigned char)source[index]) || source[index] == '_')
+    {
+        index++;
+    }
+
+    if (index == start)
+    {
+        return false;
+    }
+
+    while (isspace((unsigned char)source[index]))
+    {
+        index++;
+    }
+
+    return source[index] == '{';
+}
+
 static AstList *parser_parse_type_arguments(Parser *parser)
 {
     if (!parser_consume(parser, TOKEN_LESS, "expected '<' to start type arguments"))
@@ -1053,6 +1351,36 @@ AstNode *parser_parse_stmt_top(Parser *parser)
         }
     }
 
+    if (parser->has_loop_hints)
+    {
+        parser_error_at_current(parser, "loop annotations must precede 'for'");
+        parser_take_loop_hints(parser);
+    }
+
+    if (parser->pending_thread_local && parser->current->kind != TOKEN_KW_VAR)
+    {
+        parser_error_at_current(parser, "'#@thread_local' must precede a top-level 'var'");
+        parser->pending_thread_local = false;
+    }
+
+    if (parser->pending_comptime && parser->current->kind != TOKEN_KW_VAL && parser->current->kind != TOKEN_KW_VAR)
+    {
+        parser_error_at_current(parser, "'#@comptime' must precede 'val' or 'var'");
+        parser->pending_comptime = false;
+    }
+
+    if (parser->pending_keep && parser->current->kind != TOKEN_KW_FUN && parser->current->kind != TOKEN_KW_VAL && parser->current->kind != TOKEN_KW_VAR)
+    {
+        parser_error_at_current(parser, "'#@keep' must precede a top-level 'fun', 'val' or 'var'");
+        parser->pending_keep = false;
+    }
+
+    if (parser->has_fun_hints && parser->current->kind != TOKEN_KW_FUN)
+    {
+        parser_error_at_current(parser, "function annotations must precede 'fun'");
+        parser_drop_fun_hints(parser);
+    }
+
     switch (parser->current->kind)
     {
     case TOKEN_KW_NIL:
@@ -1138,6 +1466,36 @@ AstNode *parser_parse_stmt(Parser *parser)
         }
     }
 
+    if (parser->has_loop_hints && parser->current->kind != TOKEN_KW_FOR)
+    {
+        parser_error_at_current(parser, "loop annotations must precede 'for'");
+        parser_take_loop_hints(parser);
+    }
+
+    if (parser->pending_thread_local)
+    {
+        parser_error_at_current(parser, "'#@thread_local' must precede a top-level 'var'");
+        parser->pending_thread_local = false;
+    }
+
+    if (parser->pending_comptime && parser->current->kind != TOKEN_KW_VAL && parser->current->kind != TOKEN_KW_VAR)
+    {
+        parser_error_at_current(parser, "'#@comptime' must precede 'val' or 'var'");
+        parser->pending_comptime = false;
+    }
+
+    if (parser->pending_keep)
+    {
+        parser_error_at_current(parser, "'#@keep' must precede a top-level 'fun', 'val' or 'var'");
+        parser->pending_keep = false;
+    }
+
+    if (parser->has_fun_hints)
+    {
+        parser_error_at_current(parser, "function annotations must precede a top-level 'fun'");
+        parser_drop_fun_hints(parser);
+    }
+
     switch (parser->current->kind)
     {
     case TOKEN_KW_VAL:
@@ -1402,7 +1760,13 @@ static AstNode *parser_parse_var_decl(Parser *parser, bool is_val, bool is_publi
         return NULL;
     }
 
-    node->var_stmt.mangle_name = parser_take_pending_mangle(parser);
+    node->var_stmt.mangle_name     = parser_take_pending_mangle(parser);
+    node->var_stmt.is_thread_local = parser->pending_thread_local;
+    node->var_stmt.is_comptime     = parser->pending_comptime;
+    node->var_stmt.is_keep         = parser->pending_keep;
+    parser->pending_thread_local   = false;
+    parser->pending_comptime       = false;
+    parser->pending_keep           = false;
 
     node->var_stmt.is_val    = is_val;
     node->var_stmt.is_public = is_public;
@@ -1495,6 +1859,17 @@ AstNode *parser_parse_stmt_fun(Parser *parser, bool is_public)
     }
 
     node->fun_stmt.mangle_name = parser_take_pending_mangle(parser);
+    node->fun_stmt.hints       = parser_take_fun_hints(parser);
+    node->fun_stmt.is_keep     = parser->pending_keep;
+    parser->pending_keep       = false;
+    if (node->fun_stmt.hints.is_cold && node->fun_stmt.hints.is_hot)
+    {
+        parser_error(parser, parser->previous, "'#@cold' and '#@hot' cannot be combined");
+    }
+    if (node->fun_stmt.hints.is_inline && node->fun_stmt.hints.is_noinline)
+    {
+        parser_error(parser, parser->previous, "'#@inline' and '#@noinline' cannot be combined");
+    }
 
     bool is_method = parser_is_method_decl(parser);
     if (is_method)
@@ -1899,6 +2274,11 @@ AstNode *parser_parse_stmt_for(Parser *parser)
     {
         return NULL;
     }
+    node->for_stmt.hints = parser_take_loop_hints(parser);
+    if (node->for_stmt.hints.no_unroll && node->for_stmt.hints.unroll_count)
+    {
+        parser_error_at_previous(parser, "'#@unroll' conflicts with '#@no_unroll'");
+    }
 
     // optional condition
     if (parser_match(parser, TOKEN_L_PAREN))
@@ -2592,6 +2972,16 @@ AstNode *parser_parse_expr_atom(Parser *parser)
 
     case TOKEN_IDENTIFIER:
     {
+        if (parser_is_vector_type(parser, true))
+        {
+            AstNode *type = parser_parse_type(parser);
+            if (!type)
+            {
+                return NULL;
+            }
+            return parser_parse_typed_literal(parser, type);
+        }
+
         AstNode *ident = parser_alloc_node(parser, AST_EXPR_IDENT, parser->current);
         if (!ident)
         {
@@ -2824,6 +3214,12 @@ AstNode *parser_parse_type(Parser *parser)
         return parser_parse_type_array(parser);
 
     case TOKEN_IDENTIFIER:
+        if (parser_is_vector_type(parser, false))
+        {
+            parser_advance(parser);
+            parser_advance(parser);
+            return parser_parse_type_vector(parser);
+        }
         return parser_parse_type_name(parser);
 
     default:
@@ -2924,6 +3320,26 @@ AstNode *parser_parse_type_array(Parser *parser)
     return array;
 }
 
+AstNode *parser_parse_type_vector(Parser *parser)
+{
+    AstNode *vector = parser_parse_type_array(parser);
+    if (!vector)
+    {
+        return NULL;
+    }
+
+    vector->type_array.is_vector = true;
+    if (!vector->type_array.size)
+    {
+        parser_error(parser, vector->token, "vector type requires a lane count");
+        ast_node_dnit(vector);
+        free(vector);
+        return NULL;
+    }
+
+    return vector;
+}
+
 AstNode *parser_parse_type_fun(Parser *parser)
 {
     AstNode *fun = parser_alloc_node(parser, AST_TYPE_FUN, parser->previous);
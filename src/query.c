@@ -0,0 +1,227 @@
+#include "query.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define QUERY_INITIAL_BUCKETS 256
+
+static bool query_key_is_string(QueryKind kind)
+{
+    return kind == QUERY_LLVM_NAMED_TYPE;
+}
+
+static size_t query_hash(QueryKind kind, const void *key)
+{
+    size_t hash = 5381 + (size_t)kind;
+    if (query_key_is_string(kind))
+    {
+        for (const unsigned char *c = key; *c; c++)
+            hash = ((hash << 5) + hash) + *c;
+        return hash;
+    }
+
+    // pointers are aligned; fold the low bits away before mixing
+    uintptr_t bits = (uintptr_t)key >> 3;
+    hash ^= bits * 0x9e3779b97f4a7c15ULL;
+    return hash ^ (hash >> 29);
+}
+
+static bool query_key_equal(QueryKind kind, const void *a, const void *b)
+{
+    if (query_key_is_string(kind))
+        return strcmp(a, b) == 0;
+    return a == b;
+}
+
+static QueryEntry *query_find(QueryTable *table, QueryKind kind, const void *key)
+{
+    size_t bucket = query_hash(kind, key) % table->bucket_count;
+    for (QueryEntry *entry = table->buckets[bucket]; entry; entry = entry->next)
+    {
+        if (entry->kind == kind && query_key_equal(kind, entry->key, key))
+            return entry;
+    }
+    return NULL;
+}
+
+static void query_resize(QueryTable *table)
+{
+    size_t       old_count   = table->bucket_count;
+    QueryEntry **old_buckets = table->buckets;
+
+    table->bucket_count = old_count * 2;
+    table->buckets      = calloc(table->bucket_count, sizeof(QueryEntry *));
+
+    for (size_t i = 0; i < old_count; i++)
+    {
+        QueryEntry *entry = old_buckets[i];
+        while (entry)
+        {
+            QueryEntry *next       = entry->next;
+            size_t      bucket     = query_hash(entry->kind, entry->key) % table->bucket_count;
+            entry->next            = table->buckets[bucket];
+            table->buckets[bucket] = entry;
+            entry                  = next;
+        }
+    }
+
+    free(old_buckets);
+}
+
+// entries and copied string keys live in the table's arena until query_table_dnit
+static QueryEntry *query_insert(QueryTable *table, QueryKind kind, const void *key)
+{
+    if (table->entry_count * 4 >= table->bucket_count * 3)
+        query_resize(table);
+
+    QueryEntry *entry = arena_alloc(&table->arena, sizeof(QueryEntry));
+    entry->kind       = kind;
+    entry->key        = query_key_is_string(kind) ? arena_strdup(&table->arena, key) : key;
+
+    size_t bucket          = query_hash(kind, key) % table->bucket_count;
+    entry->next            = table->buckets[bucket];
+    table->buckets[bucket] = entry;
+    table->entry_count++;
+    return entry;
+}
+
+static QueryEntry *query_get_or_insert(QueryTable *table, QueryKind kind, const void *key)
+{
+    QueryEntry *entry = query_find(table, kind, key);
+    return entry ? entry : query_insert(table, kind, key);
+}
+
+// the innermost active query read 'entry'; links live in the arena and are dropped on invalidation
+static void query_add_dependent(QueryTable *table, QueryEntry *entry)
+{
+    if (table->active_count == 0)
+        return;
+
+    QueryEntry *dependent = table->active[table->active_count - 1];
+    if (dependent == entry || (entry->dependents && entry->dependents->entry == dependent))
+        return;
+
+    QueryLink *link   = arena_alloc(&table->arena, sizeof(QueryLink));
+    link->entry       = dependent;
+    link->next        = entry->dependents;
+    entry->dependents = link;
+}
+
+void query_table_init(QueryTable *table)
+{
+    table->buckets         = calloc(QUERY_INITIAL_BUCKETS, sizeof(QueryEntry *));
+    table->bucket_count    = QUERY_INITIAL_BUCKETS;
+    table->entry_count     = 0;
+    table->active          = NULL;
+    table->active_count    = 0;
+    table->active_capacity = 0;
+    table->hits            = 0;
+    table->misses          = 0;
+    arena_init(&table->arena, 0);
+}
+
+void query_table_dnit(QueryTable *table)
+{
+    arena_dnit(&table->arena);
+    free(table->buckets);
+    free(table->active);
+    table->buckets      = NULL;
+    table->bucket_count = 0;
+    table->entry_count  = 0;
+    table->active       = NULL;
+    table->active_count = 0;
+}
+
+bool query_lookup(QueryTable *table, QueryKind kind, const void *key, void **out_value)
+{
+    QueryEntry *entry = query_find(table, kind, key);
+    if (!entry || !entry->is_valid)
+    {
+        table->misses++;
+        return false;
+    }
+
+    query_add_dependent(table, entry);
+
+    table->hits++;
+    *out_value = entry->value;
+    return true;
+}
+
+void query_store(QueryTable *table, QueryKind kind, const void *key, void *value)
+{
+    QueryEntry *entry = query_get_or_insert(table, kind, key);
+    entry->value      = value;
+    entry->is_valid   = true;
+}
+
+void query_begin(QueryTable *table, QueryKind kind, const void *key)
+{
+    QueryEntry *entry = query_get_or_insert(table, kind, key);
+
+    if (table->active_count == table->active_capacity)
+    {
+        table->active_capacity = table->active_capacity ? table->active_capacity * 2 : 16;
+        table->active          = realloc(table->active, table->active_capacity * sizeof(QueryEntry *));
+    }
+    table->active[table->active_count++] = entry;
+}
+
+void query_end(QueryTable *table, void *value)
+{
+    if (table->active_count == 0)
+        return;
+
+    QueryEntry *entry = table->active[--table->active_count];
+    entry->value      = value;
+    entry->is_valid   = value != NULL; // failed computations are retried on the next lookup
+
+    // the enclosing computation read this answer as well
+    if (entry->is_valid)
+        query_add_dependent(table, entry);
+}
+
+bool query_is_active(QueryTable *table, QueryKind kind, const void *key)
+{
+    for (size_t i = 0; i < table->active_count; i++)
+    {
+        QueryEntry *entry = table->active[i];
+        if (entry->kind == kind && query_key_equal(kind, entry->key, key))
+            return true;
+    }
+    return false;
+}
+
+void query_invalidate(QueryTable *table, QueryKind kind, const void *key)
+{
+    QueryEntry *root = query_find(table, kind, key);
+    if (!root || !root->is_valid)
+        return;
+
+    // walk the dependents depth-first; an entry that is already invalid has had its own dependents dropped
+    QueryEntry **stack    = malloc(16 * sizeof(QueryEntry *));
+    size_t       count    = 0;
+    size_t       capacity = 16;
+
+    root->is_valid = false;
+    stack[count++] = root;
+    while (count > 0)
+    {
+        QueryEntry *entry = stack[--count];
+        for (QueryLink *link = entry->dependents; link; link = link->next)
+        {
+            if (!link->entry->is_valid)
+                continue;
+
+            if (count == capacity)
+            {
+                capacity *= 2;
+                stack     = realloc(stack, capacity * sizeof(QueryEntry *));
+            }
+            link->entry->is_valid = false;
+            stack[count++]        = link->entry;
+        }
+        entry->dependents = NULL; // a recomputation records its readers afresh
+    }
+
+    free(stack);
+}
@@ -1,4 +1,6 @@
 #include "semantic.h"
+#include "comptime.h"
+#include "effects.h"
 #include "ioutil.h"
 #include "lexer.h"
 #include "symbol.h"
@@ -312,6 +314,9 @@ static bool type_equals_strict(Type *a, Type *b)
     case TYPE_ARRAY:
         return type_equals_strict(a->array.elem_type, b->array.elem_type);
 
+    case TYPE_VECTOR:
+        return a->vector.count == b->vector.count && type_equals_strict(a->vector.elem_type, b->vector.elem_type);
+
     case TYPE_FUNCTION:
         if (a->function.param_count != b->function.param_count)
             return false;
@@ -484,82 +489,167 @@ InstantiationRequest *instantiation_queue_pop(InstantiationQueue *queue)
     return req;
 }
 
-static char *sanitize_type_name(const char *name)
+// growable output for symbol names; every piece is appended once, so building is linear in the result
+typedef struct MangleBuffer
+{
+    char  *data;
+    size_t length;
+    size_t capacity;
+} MangleBuffer;
+
+static void mangle_buffer_init(MangleBuffer *buf, size_t capacity)
+{
+    buf->capacity = capacity ? capacity : 32;
+    buf->data     = malloc(buf->capacity);
+    buf->length   = 0;
+    buf->data[0]  = '\0';
+}
+
+static void mangle_buffer_reserve(MangleBuffer *buf, size_t extra)
+{
+    if (buf->length + extra + 1 <= buf->capacity)
+        return;
+    while (buf->length + extra + 1 > buf->capacity)
+        buf->capacity *= 2;
+    buf->data = realloc(buf->data, buf->capacity);
+}
+
+static void mangle_append_n(MangleBuffer *buf, const char *text, size_t len)
+{
+    mangle_buffer_reserve(buf, len);
+    memcpy(buf->data + buf->length, text, len);
+    buf->length += len;
+    buf->data[buf->length] = '\0';
+}
+
+static void mangle_append(MangleBuffer *buf, const char *text)
+{
+    mangle_append_n(buf, text, strlen(text));
+}
+
+static bool mangle_is_ident_char(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// keeps identifier characters only; a missing name becomes "anon"
+static void mangle_append_sanitized(MangleBuffer *buf, const char *name)
 {
     if (!name)
-        return strdup("anon");
+    {
+        mangle_append(buf, "anon");
+        return;
+    }
 
-    size_t len    = strlen(name);
-    char  *result = malloc(len + 1);
-    char  *dst    = result;
+    size_t len = strlen(name);
+    mangle_buffer_reserve(buf, len);
+    for (size_t i = 0; i < len; i++)
+    {
+        if (mangle_is_ident_char(name[i]))
+            buf->data[buf->length++] = name[i];
+    }
+    buf->data[buf->length] = '\0';
+}
 
+// module path with '.' and '/' replaced by '_'
+static void mangle_append_module(MangleBuffer *buf, const char *module_name)
+{
+    size_t len = strlen(module_name);
+    mangle_buffer_reserve(buf, len);
     for (size_t i = 0; i < len; i++)
     {
-        char c = name[i];
-        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_')
-        {
-            *dst++ = c;
-        }
+        char ch                  = module_name[i];
+        buf->data[buf->length++] = (ch == '.' || ch == '/') ? '_' : ch;
     }
-    *dst = '\0';
+    buf->data[buf->length] = '\0';
+}
 
+// hands the buffer's storage to the caller
+static char *mangle_buffer_finish(MangleBuffer *buf)
+{
+    char *result = buf->data;
+    buf->data    = NULL;
     return result;
 }
 
-static char *type_to_mangled_string(Type *type)
+// moves a heap-built name into the symbol arena
+static char *symbol_take_name(char *name)
 {
-    if (!type)
-        return strdup("unknown");
-
-    // for aliases with names, use the alias name directly for better readability
-    if (type->kind == TYPE_ALIAS && type->name && strlen(type->name) > 0)
-        return sanitize_type_name(type->name);
+    char *owned = symbol_system_strdup(name);
+    free(name);
+    return owned;
+}
 
-    // for named types (structs, unions), use the name
-    if ((type->kind == TYPE_STRUCT || type->kind == TYPE_UNION) && type->name && strlen(type->name) > 0)
-        return sanitize_type_name(type->name);
+// fragment naming a type inside a symbol; computed once per type and kept in type->mangled.
+// compound types reuse their element's cached fragment, so deep nesting is not re-walked.
+static const char *type_mangled_fragment(Type *type)
+{
+    if (!type)
+        return "unknown";
+    if (type->mangled)
+        return type->mangled;
 
-    switch (type->kind)
-    {
-    case TYPE_U8:
-    case TYPE_U16:
-    case TYPE_U32:
-    case TYPE_U64:
-    case TYPE_I8:
-    case TYPE_I16:
-    case TYPE_I32:
-    case TYPE_I64:
-    case TYPE_F16:
-    case TYPE_F32:
-    case TYPE_F64:
-    case TYPE_PTR:
-        return strdup(type->name ? type->name : "type");
+    MangleBuffer buf;
+    mangle_buffer_init(&buf, 32);
 
-    case TYPE_POINTER:
+    // named aliases and composites use their name for readability
+    bool named = (type->kind == TYPE_ALIAS || type->kind == TYPE_STRUCT || type->kind == TYPE_UNION) && type->name && type->name[0];
+    if (named)
     {
-        char *base_str = type_to_mangled_string(type->pointer.base);
-        char *result   = malloc(strlen("ptr_") + strlen(base_str) + 1);
-        sprintf(result, "ptr_%s", base_str);
-        free(base_str);
-        return result;
+        mangle_append_sanitized(&buf, type->name);
     }
-
-    case TYPE_ARRAY:
+    else
     {
-        char *elem_str = type_to_mangled_string(type->array.elem_type);
-        char *result   = malloc(strlen("arr_") + strlen(elem_str) + 1);
-        sprintf(result, "arr_%s", elem_str);
-        free(elem_str);
-        return result;
-    }
+        switch (type->kind)
+        {
+        case TYPE_U8:
+        case TYPE_U16:
+        case TYPE_U32:
+        case TYPE_U64:
+        case TYPE_I8:
+        case TYPE_I16:
+        case TYPE_I32:
+        case TYPE_I64:
+        case TYPE_F16:
+        case TYPE_F32:
+        case TYPE_F64:
+        case TYPE_PTR:
+            mangle_append(&buf, type->name ? type->name : "type");
+            break;
 
-    case TYPE_STRUCT:
-    case TYPE_UNION:
-        return sanitize_type_name(type->name);
+        case TYPE_POINTER:
+            mangle_append(&buf, "ptr_");
+            mangle_append(&buf, type_mangled_fragment(type->pointer.base));
+            break;
 
-    default:
-        return strdup("unknown");
+        case TYPE_ARRAY:
+            mangle_append(&buf, "arr_");
+            mangle_append(&buf, type_mangled_fragment(type->array.elem_type));
+            break;
+
+        case TYPE_VECTOR:
+        {
+            char count[32];
+            int  count_len = snprintf(count, sizeof(count), "vec%zu_", type->vector.count);
+            mangle_append_n(&buf, count, (size_t)count_len);
+            mangle_append(&buf, type_mangled_fragment(type->vector.elem_type));
+            break;
+        }
+
+        case TYPE_STRUCT:
+        case TYPE_UNION:
+            mangle_append_sanitized(&buf, type->name);
+            break;
+
+        default:
+            mangle_append(&buf, "unknown");
+            break;
+        }
     }
+
+    type->mangled = type_system_strndup(buf.data, buf.length);
+    free(buf.data);
+    return type->mangled;
 }
 
 char *mangle_generic_type(const char *module_name, const char *base_name, Type **type_args, size_t type_arg_count)
@@ -567,68 +657,35 @@ char *mangle_generic_type(const char *module_name, const char *base_name, Type *
     if (!base_name)
         base_name = "type";
 
-    char *sanitized_base = sanitize_type_name(base_name);
+    MangleBuffer buf;
+    mangle_buffer_init(&buf, 64);
 
-    // calculate total length with module prefix
-    size_t total_len     = 0;
-    char  *module_prefix = NULL;
-    if (module_name && strlen(module_name) > 0)
+    // module prefix: std.types.result → std_types_result__
+    if (module_name && module_name[0])
     {
-        // sanitize module path: std.types.result → std__types__result
         size_t mod_len = strlen(module_name);
-        module_prefix  = malloc(mod_len + 1);
-        char *dst      = module_prefix;
+        mangle_buffer_reserve(&buf, mod_len);
         for (size_t i = 0; i < mod_len; i++)
         {
             char c = module_name[i];
             if (c == '.')
-                *dst++ = '_';
-            else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_')
-                *dst++ = c;
+                buf.data[buf.length++] = '_';
+            else if (mangle_is_ident_char(c))
+                buf.data[buf.length++] = c;
         }
-        *dst      = '\0';
-        total_len = strlen(module_prefix) + 2; // module + "__"
-    }
-
-    total_len += strlen(sanitized_base);
-
-    char **arg_strs = malloc(type_arg_count * sizeof(char *));
-    for (size_t i = 0; i < type_arg_count; i++)
-    {
-        arg_strs[i] = type_to_mangled_string(type_args[i]);
-        total_len += 1 + strlen(arg_strs[i]); // '$' + arg
-    }
-
-    char  *result = malloc(total_len + 1);
-    size_t offset = 0;
-
-    // add module prefix
-    if (module_prefix)
-    {
-        strcpy(result, module_prefix);
-        offset           = strlen(module_prefix);
-        result[offset++] = '_';
-        result[offset++] = '_';
-        free(module_prefix);
+        buf.data[buf.length] = '\0';
+        mangle_append(&buf, "__");
     }
 
-    // add base name
-    strcpy(result + offset, sanitized_base);
-    offset += strlen(sanitized_base);
+    mangle_append_sanitized(&buf, base_name);
 
-    // add type arguments
     for (size_t i = 0; i < type_arg_count; i++)
     {
-        result[offset++] = '$';
-        strcpy(result + offset, arg_strs[i]);
-        offset += strlen(arg_strs[i]);
-        free(arg_strs[i]);
+        mangle_append(&buf, "$");
+        mangle_append(&buf, type_mangled_fragment(type_args[i]));
     }
-    result[offset] = '\0';
 
-    free(arg_strs);
-    free(sanitized_base);
-    return result;
+    return mangle_buffer_finish(&buf);
 }
 
 char *mangle_generic_function(const char *module_name, const char *base_name, Type **type_args, size_t type_arg_count)
@@ -639,27 +696,20 @@ char *mangle_generic_function(const char *module_name, const char *base_name, Ty
 
 char *mangle_method(const char *module_name, const char *owner_name, const char *method_name, bool receiver_is_pointer)
 {
-    const char *mod        = module_name ? module_name : "mod";
-    const char *own        = owner_name ? owner_name : "owner";
-    const char *mth        = method_name ? method_name : "method";
-    const char *ptr_suffix = receiver_is_pointer ? "_ptr" : "";
-
-    // normalize module name: replace dots and slashes with underscores
-    size_t mod_len        = strlen(mod);
-    char  *normalized_mod = malloc(mod_len + 1);
-    for (size_t i = 0; i < mod_len; i++)
-    {
-        char ch           = mod[i];
-        normalized_mod[i] = (ch == '.' || ch == '/') ? '_' : ch;
-    }
-    normalized_mod[mod_len] = '\0';
-
-    size_t len    = strlen(normalized_mod) + 2 + strlen(own) + 2 + strlen(mth) + strlen(ptr_suffix) + 1;
-    char  *result = malloc(len);
-    snprintf(result, len, "%s__%s__%s%s", normalized_mod, own, mth, ptr_suffix);
-
-    free(normalized_mod);
-    return result;
+    const char *mod = module_name ? module_name : "mod";
+    const char *own = owner_name ? owner_name : "owner";
+    const char *mth = method_name ? method_name : "method";
+
+    MangleBuffer buf;
+    mangle_buffer_init(&buf, strlen(mod) + strlen(own) + strlen(mth) + 9);
+    mangle_append_module(&buf, mod);
+    mangle_append(&buf, "__");
+    mangle_append(&buf, own);
+    mangle_append(&buf, "__");
+    mangle_append(&buf, mth);
+    if (receiver_is_pointer)
+        mangle_append(&buf, "_ptr");
+    return mangle_buffer_finish(&buf);
 }
 
 char *mangle_global_symbol(const char *module_name, const char *symbol_name)
@@ -667,22 +717,12 @@ char *mangle_global_symbol(const char *module_name, const char *symbol_name)
     const char *mod = module_name ? module_name : "mod";
     const char *sym = symbol_name ? symbol_name : "symbol";
 
-    // normalize module name: replace dots and slashes with underscores
-    size_t mod_len        = strlen(mod);
-    char  *normalized_mod = malloc(mod_len + 1);
-    for (size_t i = 0; i < mod_len; i++)
-    {
-        char ch           = mod[i];
-        normalized_mod[i] = (ch == '.' || ch == '/') ? '_' : ch;
-    }
-    normalized_mod[mod_len] = '\0';
-
-    size_t len    = strlen(normalized_mod) + 2 + strlen(sym) + 1;
-    char  *result = malloc(len);
-    snprintf(result, len, "%s__%s", normalized_mod, sym);
-
-    free(normalized_mod);
-    return result;
+    MangleBuffer buf;
+    mangle_buffer_init(&buf, strlen(mod) + strlen(sym) + 3);
+    mangle_append_module(&buf, mod);
+    mangle_append(&buf, "__");
+    mangle_append(&buf, sym);
+    return mangle_buffer_finish(&buf);
 }
 
 AnalysisContext analysis_context_create(Scope *global_scope, Scope *module_scope, const char *module_name, const char *module_path)
@@ -726,8 +766,12 @@ SemanticDriver *semantic_driver_create(void)
     specialization_cache_init(&driver->spec_cache);
     instantiation_queue_init(&driver->inst_queue);
     diagnostic_sink_init(&driver->diagnostics);
+    query_table_init(&driver->queries);
+    driver->comptime_head     = NULL;
+    driver->comptime_tail     = NULL;
     driver->program_root      = NULL;
     driver->entry_module_name = NULL;
+    driver->bounds_checks     = BOUNDS_CHECKS_LOOPS;
     return driver;
 }
 
@@ -738,7 +782,18 @@ void semantic_driver_destroy(SemanticDriver *driver)
     specialization_cache_dnit(&driver->spec_cache);
     instantiation_queue_dnit(&driver->inst_queue);
     diagnostic_sink_dnit(&driver->diagnostics);
+    query_table_dnit(&driver->queries);
+    while (driver->comptime_head)
+    {
+        ComptimeRequest *next = driver->comptime_head->next;
+        free(driver->comptime_head);
+        driver->comptime_head = next;
+    }
     free(driver);
+
+    // types, symbols and scopes were created during analysis and are released together
+    symbol_system_dnit();
+    type_system_dnit();
 }
 
 static bool    analyze_pass_a_declarations(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *root);
@@ -889,7 +944,27 @@ static Type *resolve_type_in_context(SemanticDriver *driver, const AnalysisConte
             return NULL;
 
         Type *arr = NULL;
-        if (type_node->type_array.size)
+        if (type_node->type_array.is_vector)
+        {
+            if (!type_is_numeric(elem))
+            {
+                diagnostic_emit(&driver->diagnostics, DIAG_ERROR, type_node, ctx->file_path, "vector element type must be an integer or float");
+                return NULL;
+            }
+            if (type_node->type_array.size->kind != AST_EXPR_LIT || type_node->type_array.size->lit_expr.kind != TOKEN_LIT_INT)
+            {
+                diagnostic_emit(&driver->diagnostics, DIAG_ERROR, type_node, ctx->file_path, "vector lane count must be an integer literal");
+                return NULL;
+            }
+            int64_t count = type_node->type_array.size->lit_expr.int_val;
+            if (count < 2 || count > 64 || (count & (count - 1)) != 0)
+            {
+                diagnostic_emit(&driver->diagnostics, DIAG_ERROR, type_node, ctx->file_path, "vector lane count must be a power of two between 2 and 64");
+                return NULL;
+            }
+            arr = type_vector_create(elem, (size_t)count);
+        }
+        else if (type_node->type_array.size)
         {
             // fixed-size array [N]T - evaluate size
             // for now, only support integer literals
@@ -978,18 +1053,7 @@ static Type *resolve_type_in_context(SemanticDriver *driver, const AnalysisConte
                 AstNode *field_node = type_node->type_str.fields->items[i];
                 Type    *field_type = resolve_type_in_context(driver, ctx, field_node->field_stmt.type);
                 if (!field_type)
-                {
-                    // cleanup
-                    Symbol *curr = head;
-                    while (curr)
-                    {
-                        Symbol *next = curr->next;
-                        symbol_destroy(curr);
-                        curr = next;
-                    }
-                    free(struct_type);
-                    return NULL;
-                }
+                    return NULL; // fields already created stay in the symbol arena
 
                 // resolve alias to get actual type with proper size
                 Type *resolved_type = type_resolve_alias(field_type);
@@ -1062,18 +1126,7 @@ static Type *resolve_type_in_context(SemanticDriver *driver, const AnalysisConte
                 AstNode *field_node = type_node->type_uni.fields->items[i];
                 Type    *field_type = resolve_type_in_context(driver, ctx, field_node->field_stmt.type);
                 if (!field_type)
-                {
-                    // cleanup
-                    Symbol *curr = head;
-                    while (curr)
-                    {
-                        Symbol *next = curr->next;
-                        symbol_destroy(curr);
-                        curr = next;
-                    }
-                    free(union_type);
-                    return NULL;
-                }
+                    return NULL; // fields already created stay in the symbol arena
 
                 // resolve alias to get actual type with proper size
                 Type *resolved_type = type_resolve_alias(field_type);
@@ -1226,90 +1279,51 @@ static Symbol *clone_imported_symbol(Symbol *source, const char *module_name)
     clone->import_module = module_name;
     clone->import_origin = source->import_origin ? source->import_origin : source;
 
-    free(clone->module_name);
-    if (source->module_name)
-        clone->module_name = strdup(source->module_name);
-    else if (module_name)
-        clone->module_name = strdup(module_name);
-    else
-        clone->module_name = NULL;
+    // the source lives in the same symbol arena for the whole analysis, so its strings are shared
+    clone->module_name = source->module_name ? source->module_name : symbol_system_strdup(module_name);
 
     switch (source->kind)
     {
     case SYMBOL_VAR:
     case SYMBOL_VAL:
-        clone->var.is_global = source->var.is_global;
-        clone->var.is_const  = source->var.is_const;
-        free(clone->var.mangled_name);
-        clone->var.mangled_name = source->var.mangled_name ? strdup(source->var.mangled_name) : NULL;
+        clone->var.is_global       = source->var.is_global;
+        clone->var.is_const        = source->var.is_const;
+        clone->var.is_thread_local = source->var.is_thread_local;
+        clone->var.mangled_name    = source->var.mangled_name;
         break;
     case SYMBOL_FUNC:
         clone->func.is_external                    = source->func.is_external;
         clone->func.is_defined                     = source->func.is_defined;
         clone->func.uses_mach_varargs              = source->func.uses_mach_varargs;
-        clone->func.extern_name                    = source->func.extern_name ? strdup(source->func.extern_name) : NULL;
-        clone->func.convention                     = source->func.convention ? strdup(source->func.convention) : NULL;
-        clone->func.mangled_name                   = source->func.mangled_name ? strdup(source->func.mangled_name) : NULL;
+        clone->func.extern_name                    = source->func.extern_name;
+        clone->func.convention                     = source->func.convention;
+        clone->func.mangled_name                   = source->func.mangled_name;
         clone->func.is_generic                     = source->func.is_generic;
         clone->func.generic_param_count            = source->func.generic_param_count;
+        clone->func.generic_param_names            = source->func.generic_param_names;
         clone->func.generic_specializations        = NULL;
         clone->func.is_specialized_instance        = source->func.is_specialized_instance;
         clone->func.is_method                      = source->func.is_method;
         clone->func.method_owner                   = source->func.method_owner;
         clone->func.method_forwarded_generic_count = source->func.method_forwarded_generic_count;
         clone->func.method_receiver_is_pointer     = source->func.method_receiver_is_pointer;
-        clone->func.method_receiver_name           = source->func.method_receiver_name ? strdup(source->func.method_receiver_name) : NULL;
-        if (source->func.generic_param_count > 0 && source->func.generic_param_names)
-        {
-            clone->func.generic_param_names = malloc(sizeof(char *) * source->func.generic_param_count);
-            if (!clone->func.generic_param_names)
-            {
-                symbol_destroy(clone);
-                return NULL;
-            }
-            for (size_t i = 0; i < source->func.generic_param_count; i++)
-            {
-                clone->func.generic_param_names[i] = source->func.generic_param_names[i] ? strdup(source->func.generic_param_names[i]) : NULL;
-            }
-        }
-        else
-        {
-            clone->func.generic_param_names = NULL;
-        }
+        clone->func.method_receiver_name           = source->func.method_receiver_name;
+        clone->func.hints                          = source->func.hints;
         break;
     case SYMBOL_TYPE:
         clone->type_def.is_alias                = source->type_def.is_alias;
         clone->type_def.is_generic              = source->type_def.is_generic;
         clone->type_def.generic_param_count     = source->type_def.generic_param_count;
+        clone->type_def.generic_param_names     = source->type_def.generic_param_names;
         clone->type_def.generic_specializations = NULL;
         clone->type_def.is_specialized_instance = source->type_def.is_specialized_instance;
         clone->type_def.methods                 = NULL;
-        if (source->type_def.generic_param_count > 0 && source->type_def.generic_param_names)
-        {
-            clone->type_def.generic_param_names = malloc(sizeof(char *) * source->type_def.generic_param_count);
-            if (!clone->type_def.generic_param_names)
-            {
-                symbol_destroy(clone);
-                return NULL;
-            }
-            for (size_t i = 0; i < source->type_def.generic_param_count; i++)
-            {
-                clone->type_def.generic_param_names[i] = source->type_def.generic_param_names[i] ? strdup(source->type_def.generic_param_names[i]) : NULL;
-            }
-        }
-        else
-        {
-            clone->type_def.generic_param_names = NULL;
-        }
 
         for (Symbol *method = source->type_def.methods; method; method = method->method_next)
         {
             Symbol *method_clone = clone_imported_symbol(method, module_name);
             if (!method_clone)
-            {
-                symbol_destroy(clone);
                 return NULL;
-            }
             method_clone->func.method_owner = clone;
             method_clone->method_next       = NULL;
             type_add_method(clone, method_clone);
@@ -1323,10 +1337,8 @@ static Symbol *clone_imported_symbol(Symbol *source, const char *module_name)
         break;
     case SYMBOL_MODULE:
         // modules should not be cloned in this path; but handle gracefully
-        if (source->module.path)
-            clone->module.path = strdup(source->module.path);
-        if (source->module.scope)
-            clone->module.scope = source->module.scope;
+        clone->module.path  = source->module.path;
+        clone->module.scope = source->module.scope;
         break;
     }
 
@@ -1413,7 +1425,7 @@ static bool declare_def_stmt(SemanticDriver *driver, const AnalysisContext *ctx,
     symbol->type_def.is_alias   = true;
     symbol->type_def.is_generic = false;
     symbol->is_public           = stmt->def_stmt.is_public;
-    symbol->module_name         = ctx->module_name ? strdup(ctx->module_name) : NULL;
+    symbol->module_name         = symbol_system_strdup(ctx->module_name);
     symbol->home_scope          = ctx->current_scope;
 
     symbol_add(ctx->current_scope, symbol);
@@ -1439,7 +1451,7 @@ static bool declare_str_stmt(SemanticDriver *driver, const AnalysisContext *ctx,
     Symbol *symbol            = symbol_create(SYMBOL_TYPE, name, struct_type, stmt);
     symbol->type_def.is_alias = false;
     symbol->is_public         = stmt->str_stmt.is_public;
-    symbol->module_name       = ctx->module_name ? strdup(ctx->module_name) : NULL;
+    symbol->module_name       = symbol_system_strdup(ctx->module_name);
     symbol->home_scope        = ctx->current_scope;
 
     // check if generic
@@ -1451,14 +1463,14 @@ static bool declare_str_stmt(SemanticDriver *driver, const AnalysisContext *ctx,
 
         // store generic parameter names for later instantiation
         size_t param_count                   = (size_t)stmt->str_stmt.generics->count;
-        symbol->type_def.generic_param_names = malloc(sizeof(char *) * param_count);
+        symbol->type_def.generic_param_names = symbol_system_alloc(sizeof(char *) * param_count);
         if (symbol->type_def.generic_param_names)
         {
             for (size_t i = 0; i < param_count; i++)
             {
                 AstNode    *type_param                  = stmt->str_stmt.generics->items[i];
                 const char *param_name                  = type_param->type_param.name;
-                symbol->type_def.generic_param_names[i] = param_name ? strdup(param_name) : NULL;
+                symbol->type_def.generic_param_names[i] = symbol_system_strdup(param_name);
             }
         }
 
@@ -1492,7 +1504,7 @@ static bool declare_uni_stmt(SemanticDriver *driver, const AnalysisContext *ctx,
     Symbol *symbol            = symbol_create(SYMBOL_TYPE, name, union_type, stmt);
     symbol->type_def.is_alias = false;
     symbol->is_public         = stmt->uni_stmt.is_public;
-    symbol->module_name       = ctx->module_name ? strdup(ctx->module_name) : NULL;
+    symbol->module_name       = symbol_system_strdup(ctx->module_name);
     symbol->home_scope        = ctx->current_scope;
 
     // check if generic
@@ -1503,14 +1515,14 @@ static bool declare_uni_stmt(SemanticDriver *driver, const AnalysisContext *ctx,
 
         // store generic parameter names for later instantiation
         size_t param_count                   = (size_t)stmt->uni_stmt.generics->count;
-        symbol->type_def.generic_param_names = malloc(sizeof(char *) * param_count);
+        symbol->type_def.generic_param_names = symbol_system_alloc(sizeof(char *) * param_count);
         if (symbol->type_def.generic_param_names)
         {
             for (size_t i = 0; i < param_count; i++)
             {
                 AstNode    *type_param                  = stmt->uni_stmt.generics->items[i];
                 const char *param_name                  = type_param->type_param.name;
-                symbol->type_def.generic_param_names[i] = param_name ? strdup(param_name) : NULL;
+                symbol->type_def.generic_param_names[i] = symbol_system_strdup(param_name);
             }
         }
 
@@ -1570,7 +1582,7 @@ static bool declare_method_stmt(SemanticDriver *driver, const AnalysisContext *c
     snprintf(mangled, sizeof(mangled), "%s__%s", owner_name, method_name);
 
     Type   *placeholder                         = type_function_create(NULL, NULL, 0, stmt->fun_stmt.is_variadic);
-    Symbol *symbol                              = symbol_create(SYMBOL_FUNC, strdup(mangled), placeholder, stmt);
+    Symbol *symbol                              = symbol_create(SYMBOL_FUNC, mangled, placeholder, stmt);
     symbol->func.is_external                    = false;
     symbol->func.is_method                      = true;
     symbol->func.is_defined                     = (stmt->fun_stmt.body != NULL);
@@ -1578,12 +1590,14 @@ static bool declare_method_stmt(SemanticDriver *driver, const AnalysisContext *c
     symbol->func.uses_mach_varargs              = stmt->fun_stmt.is_variadic; // mark variadic methods
     symbol->func.method_owner                   = owner_sym;
     symbol->func.method_forwarded_generic_count = owner_generic_count;
+    symbol->func.hints                          = stmt->fun_stmt.hints;
+    symbol->func.hints.section                  = NULL; // read from the definition
 
     // store all generic parameter names (owner params first, then method params)
     if (is_generic && total_generic_count > 0)
     {
         symbol->func.generic_param_count = total_generic_count;
-        symbol->func.generic_param_names = malloc(sizeof(char *) * total_generic_count);
+        symbol->func.generic_param_names = symbol_system_alloc(sizeof(char *) * total_generic_count);
         if (symbol->func.generic_param_names)
         {
             size_t idx = 0;
@@ -1593,7 +1607,7 @@ static bool declare_method_stmt(SemanticDriver *driver, const AnalysisContext *c
             {
                 for (size_t i = 0; i < owner_generic_count; i++)
                 {
-                    symbol->func.generic_param_names[idx++] = owner_sym->type_def.generic_param_names[i] ? strdup(owner_sym->type_def.generic_param_names[i]) : NULL;
+                    symbol->func.generic_param_names[idx++] = owner_sym->type_def.generic_param_names[i];
                 }
             }
 
@@ -1604,25 +1618,25 @@ static bool declare_method_stmt(SemanticDriver *driver, const AnalysisContext *c
                 {
                     AstNode    *type_param                  = stmt->fun_stmt.generics->items[i];
                     const char *param_name                  = type_param->type_param.name;
-                    symbol->func.generic_param_names[idx++] = param_name ? strdup(param_name) : NULL;
+                    symbol->func.generic_param_names[idx++] = symbol_system_strdup(param_name);
                 }
             }
         }
     }
     symbol->is_public   = stmt->fun_stmt.is_public;
-    symbol->module_name = ctx->module_name ? strdup(ctx->module_name) : NULL;
+    symbol->module_name = symbol_system_strdup(ctx->module_name);
     symbol->home_scope  = ctx->current_scope;
 
     // set mangled name for methods: check for #@symbol directive, otherwise use module__Type__method
     if (stmt->fun_stmt.mangle_name && stmt->fun_stmt.mangle_name[0])
     {
         // explicit symbol name from #@symbol directive
-        symbol->func.extern_name = strdup(stmt->fun_stmt.mangle_name);
+        symbol->func.extern_name = symbol_system_strdup(stmt->fun_stmt.mangle_name);
     }
     else if (!is_generic && ctx->module_name && ctx->module_name[0])
     {
         // non-generic methods get mangled with module name and owner type
-        symbol->func.mangled_name = mangle_method(ctx->module_name, owner_name, method_name, false);
+        symbol->func.mangled_name = symbol_take_name(mangle_method(ctx->module_name, owner_name, method_name, false));
     }
 
     // add to current scope with mangled name
@@ -1664,35 +1678,37 @@ static bool declare_fun_stmt(SemanticDriver *driver, const AnalysisContext *ctx,
     symbol->func.is_defined        = (stmt->fun_stmt.body != NULL);
     symbol->func.is_generic        = is_generic;
     symbol->func.uses_mach_varargs = stmt->fun_stmt.is_variadic; // mark variadic functions
+    symbol->func.hints             = stmt->fun_stmt.hints;
+    symbol->func.hints.section     = NULL; // read from the definition
     if (is_generic)
     {
         size_t generic_count             = (size_t)stmt->fun_stmt.generics->count;
         symbol->func.generic_param_count = generic_count;
-        symbol->func.generic_param_names = malloc(sizeof(char *) * generic_count);
+        symbol->func.generic_param_names = symbol_system_alloc(sizeof(char *) * generic_count);
         if (symbol->func.generic_param_names)
         {
             for (size_t i = 0; i < generic_count; i++)
             {
                 AstNode    *type_param              = stmt->fun_stmt.generics->items[i];
                 const char *param_name              = type_param->type_param.name;
-                symbol->func.generic_param_names[i] = param_name ? strdup(param_name) : NULL;
+                symbol->func.generic_param_names[i] = symbol_system_strdup(param_name);
             }
         }
     }
     symbol->is_public   = stmt->fun_stmt.is_public;
-    symbol->module_name = ctx->module_name ? strdup(ctx->module_name) : NULL;
+    symbol->module_name = symbol_system_strdup(ctx->module_name);
     symbol->home_scope  = ctx->current_scope;
 
     // set mangled name: use #@symbol directive if present, otherwise mangle with module name
     if (stmt->fun_stmt.mangle_name && stmt->fun_stmt.mangle_name[0])
     {
         // explicit symbol name from #@symbol directive
-        symbol->func.extern_name = strdup(stmt->fun_stmt.mangle_name);
+        symbol->func.extern_name = symbol_system_strdup(stmt->fun_stmt.mangle_name);
     }
     else if (!is_generic && ctx->module_name && ctx->module_name[0])
     {
         // non-generic functions get mangled with module name
-        symbol->func.mangled_name = mangle_global_symbol(ctx->module_name, name);
+        symbol->func.mangled_name = symbol_take_name(mangle_global_symbol(ctx->module_name, name));
     }
 
     symbol_add(ctx->current_scope, symbol);
@@ -1720,13 +1736,13 @@ static bool declare_ext_stmt(SemanticDriver *driver, const AnalysisContext *ctx,
     symbol->func.is_defined  = false; // external functions have no body
     symbol->func.is_generic  = false;
     symbol->is_public        = stmt->ext_stmt.is_public;
-    symbol->module_name      = ctx->module_name ? strdup(ctx->module_name) : NULL;
+    symbol->module_name      = symbol_system_strdup(ctx->module_name);
     symbol->home_scope       = ctx->current_scope;
 
     // external functions use the explicit symbol name if provided
     if (stmt->ext_stmt.symbol && stmt->ext_stmt.symbol[0])
     {
-        symbol->func.extern_name = strdup(stmt->ext_stmt.symbol);
+        symbol->func.extern_name = symbol_system_strdup(stmt->ext_stmt.symbol);
     }
 
     symbol_add(ctx->current_scope, symbol);
@@ -1748,17 +1764,18 @@ static bool declare_var_stmt(SemanticDriver *driver, const AnalysisContext *ctx,
     }
 
     // create variable symbol - type resolved in pass B
-    Symbol *symbol        = symbol_create(stmt->var_stmt.is_val ? SYMBOL_VAL : SYMBOL_VAR, name, NULL, stmt);
-    symbol->var.is_global = true;
-    symbol->var.is_const  = stmt->var_stmt.is_val;
-    symbol->is_public     = stmt->var_stmt.is_public;
-    symbol->module_name   = ctx->module_name ? strdup(ctx->module_name) : NULL;
-    symbol->home_scope    = ctx->current_scope;
+    Symbol *symbol              = symbol_create(stmt->var_stmt.is_val ? SYMBOL_VAL : SYMBOL_VAR, name, NULL, stmt);
+    symbol->var.is_global       = true;
+    symbol->var.is_const        = stmt->var_stmt.is_val;
+    symbol->var.is_thread_local = stmt->var_stmt.is_thread_local;
+    symbol->is_public           = stmt->var_stmt.is_public;
+    symbol->module_name         = symbol_system_strdup(ctx->module_name);
+    symbol->home_scope          = ctx->current_scope;
 
     // mangle global variable/constant names with module prefix to avoid collisions
     if (ctx->module_name && ctx->module_name[0])
     {
-        symbol->var.mangled_name = mangle_global_symbol(ctx->module_name, name);
+        symbol->var.mangled_name = symbol_take_name(mangle_global_symbol(ctx->module_name, name));
     }
 
     symbol_add(ctx->current_scope, symbol);
@@ -1823,6 +1840,8 @@ static bool analyze_pass_a_declarations(SemanticDriver *driver, const AnalysisCo
     return success;
 }
 
+static bool demand_composite_layout(SemanticDriver *driver, const AnalysisContext *ctx, Type *type);
+
 // resolve struct fields
 static bool resolve_str_fields(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *stmt)
 {
@@ -1854,6 +1873,8 @@ static bool resolve_str_fields(SemanticDriver *driver, const AnalysisContext *ct
             diagnostic_emit(&driver->diagnostics, DIAG_ERROR, field_node, ctx->file_path, "cannot resolve type for field '%s'", field_name);
             return false;
         }
+        if (!demand_composite_layout(driver, ctx, field_type))
+            return false;
 
         // create field symbol
         Symbol *field_sym = symbol_create(SYMBOL_FIELD, field_name, field_type, field_node);
@@ -1935,6 +1956,8 @@ static bool resolve_uni_fields(SemanticDriver *driver, const AnalysisContext *ct
             diagnostic_emit(&driver->diagnostics, DIAG_ERROR, field_node, ctx->file_path, "cannot resolve type for field '%s'", field_name);
             return false;
         }
+        if (!demand_composite_layout(driver, ctx, field_type))
+            return false;
 
         // create field symbol (all at offset 0 in union)
         Symbol *field_sym       = symbol_create(SYMBOL_FIELD, field_name, field_type, field_node);
@@ -2103,6 +2126,72 @@ static bool resolve_var_type(SemanticDriver *driver, const AnalysisContext *ctx,
     return true;
 }
 
+// layout of a struct or union declaration, resolved the first time anything needs it;
+// by-value fields demand their own layouts first, so declaration order does not matter
+static bool demand_decl_layout(SemanticDriver *driver, const AnalysisContext *ctx, Symbol *symbol)
+{
+    // imported and specialized composites were laid out where they were declared or instantiated
+    if (!symbol || symbol->kind != SYMBOL_TYPE || symbol->is_imported || symbol->type_def.is_generic || !symbol->decl)
+        return true;
+
+    Type *type = symbol->type;
+    if (!type || (type->kind != TYPE_STRUCT && type->kind != TYPE_UNION) || type->generic_origin)
+        return true;
+
+    void *cached = NULL;
+    if (query_lookup(&driver->queries, QUERY_LAYOUT, type, &cached))
+        return true;
+
+    if (query_is_active(&driver->queries, QUERY_LAYOUT, type))
+    {
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, symbol->decl, ctx->file_path, "'%s' contains itself by value", type->name);
+        return false;
+    }
+
+    query_begin(&driver->queries, QUERY_LAYOUT, type);
+    bool ok = symbol->decl->kind == AST_STMT_STR ? resolve_str_fields(driver, ctx, symbol->decl) : resolve_uni_fields(driver, ctx, symbol->decl);
+    query_end(&driver->queries, ok ? type : NULL);
+    return ok;
+}
+
+// layout of a field, parameter or result type; only composites declared in this module need work
+static bool demand_composite_layout(SemanticDriver *driver, const AnalysisContext *ctx, Type *type)
+{
+    type = type_resolve_alias(type);
+    if (!type || (type->kind != TYPE_STRUCT && type->kind != TYPE_UNION) || !type->name)
+        return true;
+
+    // the entry module declares straight into the global scope and has no module scope
+    Scope  *scope  = ctx->module_scope ? ctx->module_scope : ctx->global_scope;
+    Symbol *symbol = symbol_lookup_scope(scope, type->name);
+    if (!symbol || symbol->type != type)
+        return true;
+
+    return demand_decl_layout(driver, ctx, symbol);
+}
+
+// function type of a declaration, with the layouts of by-value parameters and results complete
+static bool demand_fun_signature(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *stmt)
+{
+    void *cached = NULL;
+    if (query_lookup(&driver->queries, QUERY_SIGNATURE, stmt->symbol, &cached))
+        return true;
+
+    query_begin(&driver->queries, QUERY_SIGNATURE, stmt->symbol);
+    bool ok = stmt->kind == AST_STMT_FUN ? resolve_fun_signature(driver, ctx, stmt) : resolve_ext_signature(driver, ctx, stmt);
+
+    Type *func_type = ok ? stmt->symbol->type : NULL;
+    if (func_type && func_type->kind == TYPE_FUNCTION)
+    {
+        ok = demand_composite_layout(driver, ctx, func_type->function.return_type);
+        for (size_t i = 0; ok && i < func_type->function.param_count; i++)
+            ok = demand_composite_layout(driver, ctx, func_type->function.param_types[i]);
+    }
+
+    query_end(&driver->queries, ok ? func_type : NULL);
+    return ok;
+}
+
 static bool analyze_pass_b_signatures(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *root)
 {
     if (!root || root->kind != AST_PROGRAM)
@@ -2137,7 +2226,7 @@ static bool analyze_pass_b_signatures(SemanticDriver *driver, const AnalysisCont
 
         if (stmt->kind == AST_STMT_STR && stmt->symbol && !stmt->symbol->type_def.is_generic)
         {
-            if (!resolve_str_fields(driver, ctx, stmt))
+            if (!demand_decl_layout(driver, ctx, stmt->symbol))
                 success = false;
         }
     }
@@ -2149,7 +2238,7 @@ static bool analyze_pass_b_signatures(SemanticDriver *driver, const AnalysisCont
 
         if (stmt->kind == AST_STMT_UNI && stmt->symbol && !stmt->symbol->type_def.is_generic)
         {
-            if (!resolve_uni_fields(driver, ctx, stmt))
+            if (!demand_decl_layout(driver, ctx, stmt->symbol))
                 success = false;
         }
     }
@@ -2162,14 +2251,14 @@ static bool analyze_pass_b_signatures(SemanticDriver *driver, const AnalysisCont
         if (stmt->kind == AST_STMT_FUN && stmt->symbol && !stmt->symbol->func.is_generic)
         {
             // handle both regular functions and methods
-            if (!resolve_fun_signature(driver, ctx, stmt))
+            if (!demand_fun_signature(driver, ctx, stmt))
                 success = false;
         }
 
         // also handle external functions
         if (stmt->kind == AST_STMT_EXT && stmt->symbol)
         {
-            if (!resolve_ext_signature(driver, ctx, stmt))
+            if (!demand_fun_signature(driver, ctx, stmt))
                 success = false;
         }
     }
@@ -2215,7 +2304,7 @@ static Symbol *instantiate_generic_struct(SemanticDriver *driver, const Analysis
     specialized_sym->type_def.is_alias   = false;
     specialized_sym->type_def.is_generic = false;
     specialized_sym->is_public           = generic_sym->is_public;
-    specialized_sym->module_name         = module_name ? strdup(module_name) : NULL;
+    specialized_sym->module_name         = symbol_system_strdup(module_name);
     specialized_sym->home_scope          = generic_sym->home_scope;
 
     // store type arguments in the specialized type
@@ -2388,7 +2477,7 @@ static Symbol *instantiate_generic_union(SemanticDriver *driver, const AnalysisC
     specialized_sym->type_def.is_alias   = false;
     specialized_sym->type_def.is_generic = false;
     specialized_sym->is_public           = generic_sym->is_public;
-    specialized_sym->module_name         = module_name ? strdup(module_name) : NULL;
+    specialized_sym->module_name         = symbol_system_strdup(module_name);
     specialized_sym->home_scope          = generic_sym->home_scope;
 
     // store type arguments in the specialized type
@@ -2644,10 +2733,11 @@ found_func_module:;
     specialized_sym->func.uses_mach_varargs       = generic_sym->func.uses_mach_varargs;
     specialized_sym->func.is_method               = generic_sym->func.is_method;
     specialized_sym->func.method_owner            = generic_sym->func.method_owner;
+    specialized_sym->func.hints                   = generic_sym->func.hints;
     specialized_sym->is_public                    = generic_sym->is_public;
-    specialized_sym->module_name                  = module_name ? strdup(module_name) : NULL;
+    specialized_sym->module_name                  = symbol_system_strdup(module_name);
     specialized_sym->home_scope                   = generic_sym->home_scope;
-    specialized_sym->func.mangled_name            = strdup(specialized_name);
+    specialized_sym->func.mangled_name            = specialized_sym->name;
 
     // add specialized symbol to the generic's home scope (where it's defined)
     if (generic_sym->home_scope)
@@ -3018,6 +3108,72 @@ static bool is_lvalue_expr(const AstNode *expr)
     }
 }
 
+// comparisons between vectors produce a lane mask of unsigned integers of the element width
+static Type *vector_mask_type(Type *vector)
+{
+    Type *elem = vector->vector.elem_type;
+    Type *lane = NULL;
+    switch (type_sizeof(elem))
+    {
+    case 1:
+        lane = type_u8();
+        break;
+    case 2:
+        lane = type_u16();
+        break;
+    case 4:
+        lane = type_u32();
+        break;
+    default:
+        lane = type_u64();
+        break;
+    }
+    return type_vector_create(lane, vector->vector.count);
+}
+
+static Type *analyze_vector_binary_expr(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *expr, Type *left, Type *right)
+{
+    TokenKind op = expr->binary_expr.op;
+
+    if (!type_equals(left, right))
+    {
+        char *lhs = type_to_string(left);
+        char *rhs = type_to_string(right);
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "vector operands must have the same type (%s, %s)", lhs, rhs);
+        free(lhs);
+        free(rhs);
+        return NULL;
+    }
+
+    bool is_integer = type_is_integer(left->vector.elem_type);
+
+    if (op == TOKEN_PLUS || op == TOKEN_MINUS || op == TOKEN_STAR || op == TOKEN_SLASH || op == TOKEN_PERCENT)
+    {
+        expr->type = left;
+        return expr->type;
+    }
+
+    if (op == TOKEN_PIPE || op == TOKEN_AMPERSAND || op == TOKEN_CARET || op == TOKEN_LESS_LESS || op == TOKEN_GREATER_GREATER)
+    {
+        if (!is_integer)
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "bitwise vector operators require integer elements");
+            return NULL;
+        }
+        expr->type = left;
+        return expr->type;
+    }
+
+    if (op == TOKEN_EQUAL_EQUAL || op == TOKEN_BANG_EQUAL || op == TOKEN_LESS || op == TOKEN_LESS_EQUAL || op == TOKEN_GREATER || op == TOKEN_GREATER_EQUAL)
+    {
+        expr->type = vector_mask_type(left);
+        return expr->type;
+    }
+
+    diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "unsupported vector operator");
+    return NULL;
+}
+
 static Type *analyze_binary_expr(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *expr)
 {
     Type *left  = analyze_expr(driver, ctx, expr->binary_expr.left);
@@ -3033,6 +3189,9 @@ static Type *analyze_binary_expr(SemanticDriver *driver, const AnalysisContext *
     bool      left_ptr  = type_is_pointer_like(left);
     bool      right_ptr = type_is_pointer_like(right);
 
+    if (op != TOKEN_EQUAL && (left->kind == TYPE_VECTOR || right->kind == TYPE_VECTOR))
+        return analyze_vector_binary_expr(driver, ctx, expr, left, right);
+
     if ((op == TOKEN_PLUS || op == TOKEN_MINUS) && (left_ptr || right_ptr))
     {
         if (left_ptr && right_ptr)
@@ -3177,7 +3336,7 @@ static Type *analyze_unary_expr(SemanticDriver *driver, const AnalysisContext *c
 
     if (op == TOKEN_MINUS || op == TOKEN_PLUS)
     {
-        if (!type_is_numeric(operand))
+        if (!type_is_numeric(operand) && operand->kind != TYPE_VECTOR)
         {
             diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "unary arithmetic requires numeric operand");
             return NULL;
@@ -3225,44 +3384,569 @@ static Type *analyze_unary_expr(SemanticDriver *driver, const AnalysisContext *c
     return NULL;
 }
 
-static Type *analyze_call_expr(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *expr)
+static Type *vector_intrinsic_type_arg(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *expr, const char *name)
 {
-    // Handle potential method calls FIRST: obj.method(args) -> method(obj, args)
-    // This must happen before analyzing the func to avoid rejecting valid method calls
-    if (expr->call_expr.func && expr->call_expr.func->kind == AST_EXPR_FIELD)
+    if (!expr->call_expr.type_args || expr->call_expr.type_args->count != 1)
     {
-        AstNode *field_expr = expr->call_expr.func;
-        AstNode *receiver   = field_expr->field_expr.object;
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "%s expects one vector type argument (%s<vec[N]T>)", name, name);
+        return NULL;
+    }
 
-        // Special case: check if this is module.function() where object is an identifier for a module
-        if (receiver->kind == AST_EXPR_IDENT)
-        {
-            const char *obj_name = receiver->ident_expr.name;
-            Symbol     *obj_sym  = lookup_in_scope_chain(ctx->current_scope, ctx->module_scope, ctx->global_scope, obj_name);
+    Type *type = resolve_type_in_context(driver, ctx, expr->call_expr.type_args->items[0]);
+    if (!type)
+        return NULL;
 
-            if (obj_sym && obj_sym->kind == SYMBOL_MODULE)
-            {
-                // This is module.function() - fall through to normal call analysis
-                // The field expression will look up the function in the module scope
-                goto normal_call_analysis;
-            }
-        }
+    if (!type_is_vector(type))
+    {
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "%s type argument must be a vector type", name);
+        return NULL;
+    }
 
-        // Potential method call: analyze receiver and try method lookup
-        // analyze receiver to get its type
-        Type *receiver_type = analyze_expr(driver, ctx, receiver);
-        if (!receiver_type)
-            return NULL;
+    return type;
+}
 
-        // look up method in the receiver's type
-        const char *method_name = field_expr->field_expr.field;
+static Type *vector_intrinsic_operand(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *arg, const char *name)
+{
+    Type *type = analyze_expr(driver, ctx, arg);
+    if (!type)
+        return NULL;
 
-        Symbol *method_sym        = NULL;
-        char    mangled_name[512] = {0};
+    if (!type_is_vector(type))
+    {
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, arg, ctx->file_path, "%s expects a vector operand", name);
+        return NULL;
+    }
 
-        // dereference pointer types for method lookup (methods can be called on pointer receivers)
-        Type *lookup_type = receiver_type;
-        if (lookup_type->kind == TYPE_POINTER)
+    return type_resolve_alias(type);
+}
+
+static bool intrinsic_pointer_operand(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *arg, const char *name)
+{
+    Type *type = analyze_expr(driver, ctx, arg);
+    if (!type)
+        return false;
+
+    type = type_resolve_alias(type);
+    if (type->kind != TYPE_PTR && type->kind != TYPE_POINTER)
+    {
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, arg, ctx->file_path, "%s expects a pointer operand", name);
+        return false;
+    }
+
+    return true;
+}
+
+// mem_copy(dst, src, n), mem_move(dst, src, n) and mem_set(dst, byte, n) produce no value
+static void analyze_memory_intrinsic(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *expr, const char *name)
+{
+    size_t arg_count = expr->call_expr.args ? expr->call_expr.args->count : 0;
+    bool   is_set    = strcmp(name, "mem_set") == 0;
+
+    if (arg_count != 3)
+    {
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, is_set ? "%s expects a destination, a byte value and a length" : "%s expects a destination, a source and a length", name);
+        return;
+    }
+
+    if (!intrinsic_pointer_operand(driver, ctx, expr->call_expr.args->items[0], name))
+        return;
+
+    AstNode *middle = expr->call_expr.args->items[1];
+    if (is_set)
+    {
+        Type *value = analyze_expr_with_hint(driver, ctx, middle, type_u8());
+        if (!value)
+            return;
+        if (!type_is_integer(value))
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, middle, ctx->file_path, "mem_set value must be an integer");
+            return;
+        }
+    }
+    else if (!intrinsic_pointer_operand(driver, ctx, middle, name))
+    {
+        return;
+    }
+
+    AstNode *length = expr->call_expr.args->items[2];
+    Type    *len    = analyze_expr_with_hint(driver, ctx, length, type_u64());
+    if (!len)
+        return;
+    if (!type_is_integer(len))
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, length, ctx->file_path, "%s length must be an integer", name);
+}
+
+typedef enum
+{
+    ATOMIC_ORDER_INVALID,
+    ATOMIC_ORDER_RELAXED,
+    ATOMIC_ORDER_ACQUIRE,
+    ATOMIC_ORDER_RELEASE,
+    ATOMIC_ORDER_ACQ_REL,
+    ATOMIC_ORDER_SEQ_CST,
+} AtomicOrder;
+
+// orderings are written as bare identifiers, the same way offset_of names a field
+static AtomicOrder atomic_intrinsic_order(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *arg, const char *name)
+{
+    static const struct
+    {
+        const char *name;
+        AtomicOrder order;
+    } orders[] = {
+        {"relaxed", ATOMIC_ORDER_RELAXED},
+        {"acquire", ATOMIC_ORDER_ACQUIRE},
+        {"release", ATOMIC_ORDER_RELEASE},
+        {"acq_rel", ATOMIC_ORDER_ACQ_REL},
+        {"seq_cst", ATOMIC_ORDER_SEQ_CST},
+    };
+
+    if (arg->kind == AST_EXPR_IDENT)
+    {
+        for (size_t i = 0; i < sizeof(orders) / sizeof(orders[0]); i++)
+        {
+            if (strcmp(arg->ident_expr.name, orders[i].name) == 0)
+                return orders[i].order;
+        }
+    }
+
+    diagnostic_emit(&driver->diagnostics, DIAG_ERROR, arg, ctx->file_path, "%s ordering must be one of relaxed, acquire, release, acq_rel or seq_cst", name);
+    return ATOMIC_ORDER_INVALID;
+}
+
+// the pointee of a typed pointer operand, restricted to 1, 2, 4 or 8 byte integers, floats and pointers
+static Type *atomic_intrinsic_target(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *arg, const char *name)
+{
+    Type *type = analyze_expr(driver, ctx, arg);
+    if (!type)
+        return NULL;
+
+    type = type_resolve_alias(type);
+    if (type->kind != TYPE_POINTER)
+    {
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, arg, ctx->file_path, "%s expects a typed pointer (*T)", name);
+        return NULL;
+    }
+
+    Type  *target = type->pointer.base;
+    Type  *base   = type_resolve_alias(target);
+    size_t size   = type_sizeof(base);
+    bool   scalar = type_is_numeric(base) || base->kind == TYPE_PTR || base->kind == TYPE_POINTER;
+    if (!scalar || (size != 1 && size != 2 && size != 4 && size != 8))
+    {
+        char *str = type_to_string(target);
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, arg, ctx->file_path, "%s cannot operate on '%s'", name, str);
+        free(str);
+        return NULL;
+    }
+
+    return target;
+}
+
+static bool atomic_intrinsic_value(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *arg, Type *target, const char *what)
+{
+    Type *type = analyze_expr_with_hint(driver, ctx, arg, target);
+    return type && ensure_assignable(driver, ctx, target, type, arg, what);
+}
+
+// true when name is an atomic_* intrinsic or fence; the result type (NULL on error or for void forms) goes to *out
+static bool analyze_atomic_intrinsic(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *expr, const char *name, Type **out)
+{
+    size_t    arg_count = expr->call_expr.args ? expr->call_expr.args->count : 0;
+    AstNode **args      = expr->call_expr.args ? expr->call_expr.args->items : NULL;
+    *out                = NULL;
+
+    if (strcmp(name, "fence") == 0)
+    {
+        if (arg_count != 1)
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "fence expects an ordering");
+            return true;
+        }
+
+        AtomicOrder order = atomic_intrinsic_order(driver, ctx, args[0], name);
+        if (order == ATOMIC_ORDER_RELAXED)
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, args[0], ctx->file_path, "fence cannot be relaxed");
+        return true;
+    }
+
+    if (strcmp(name, "atomic_load") == 0)
+    {
+        if (arg_count != 2)
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "atomic_load expects a pointer and an ordering");
+            return true;
+        }
+
+        Type       *target = atomic_intrinsic_target(driver, ctx, args[0], name);
+        AtomicOrder order  = atomic_intrinsic_order(driver, ctx, args[1], name);
+        if (!target || order == ATOMIC_ORDER_INVALID)
+            return true;
+
+        if (order == ATOMIC_ORDER_RELEASE || order == ATOMIC_ORDER_ACQ_REL)
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, args[1], ctx->file_path, "atomic_load cannot use release ordering");
+            return true;
+        }
+
+        expr->type = target;
+        *out       = target;
+        return true;
+    }
+
+    if (strcmp(name, "atomic_store") == 0)
+    {
+        if (arg_count != 3)
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "atomic_store expects a pointer, a value and an ordering");
+            return true;
+        }
+
+        Type       *target = atomic_intrinsic_target(driver, ctx, args[0], name);
+        AtomicOrder order  = atomic_intrinsic_order(driver, ctx, args[2], name);
+        if (!target || order == ATOMIC_ORDER_INVALID)
+            return true;
+
+        if (order == ATOMIC_ORDER_ACQUIRE || order == ATOMIC_ORDER_ACQ_REL)
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, args[2], ctx->file_path, "atomic_store cannot use acquire ordering");
+            return true;
+        }
+
+        atomic_intrinsic_value(driver, ctx, args[1], target, "atomic_store value");
+        return true;
+    }
+
+    if (strcmp(name, "atomic_cas") == 0)
+    {
+        // the failure ordering defaults to the success ordering without its release half
+        if (arg_count != 4 && arg_count != 5)
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "atomic_cas expects a pointer, expected and desired values, and one or two orderings");
+            return true;
+        }
+
+        Type *target = atomic_intrinsic_target(driver, ctx, args[0], name);
+        if (!target)
+            return true;
+
+        if (type_is_float(target))
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, args[0], ctx->file_path, "atomic_cas requires an integer or pointer target");
+            return true;
+        }
+
+        if (!atomic_intrinsic_value(driver, ctx, args[1], target, "atomic_cas expected value") || !atomic_intrinsic_value(driver, ctx, args[2], target, "atomic_cas desired value"))
+            return true;
+
+        AtomicOrder success = atomic_intrinsic_order(driver, ctx, args[3], name);
+        if (success == ATOMIC_ORDER_INVALID)
+            return true;
+
+        if (arg_count == 5)
+        {
+            AtomicOrder failure = atomic_intrinsic_order(driver, ctx, args[4], name);
+            if (failure == ATOMIC_ORDER_INVALID)
+                return true;
+            if (failure == ATOMIC_ORDER_RELEASE || failure == ATOMIC_ORDER_ACQ_REL)
+            {
+                diagnostic_emit(&driver->diagnostics, DIAG_ERROR, args[4], ctx->file_path, "atomic_cas failure ordering cannot be release or acq_rel");
+                return true;
+            }
+        }
+
+        expr->type = target;
+        *out       = target;
+        return true;
+    }
+
+    bool is_xchg  = strcmp(name, "atomic_xchg") == 0;
+    bool is_fetch = strcmp(name, "atomic_fetch_add") == 0 || strcmp(name, "atomic_fetch_sub") == 0 || strcmp(name, "atomic_fetch_and") == 0 || strcmp(name, "atomic_fetch_or") == 0 || strcmp(name, "atomic_fetch_xor") == 0;
+    if (!is_xchg && !is_fetch)
+        return false;
+
+    if (arg_count != 3)
+    {
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "%s expects a pointer, a value and an ordering", name);
+        return true;
+    }
+
+    Type *target = atomic_intrinsic_target(driver, ctx, args[0], name);
+    if (!target)
+        return true;
+
+    if (is_fetch && !type_is_integer(target))
+    {
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, args[0], ctx->file_path, "%s requires an integer target", name);
+        return true;
+    }
+
+    if (!atomic_intrinsic_value(driver, ctx, args[1], target, "atomic operand") || atomic_intrinsic_order(driver, ctx, args[2], name) == ATOMIC_ORDER_INVALID)
+        return true;
+
+    expr->type = target;
+    *out       = target;
+    return true;
+}
+
+// prefetch flags are integer literals so they can be passed to llvm.prefetch as immediates
+static bool prefetch_intrinsic_flag(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *arg, const char *what, unsigned long long max)
+{
+    if (arg->kind != AST_EXPR_LIT || arg->lit_expr.kind != TOKEN_LIT_INT || arg->lit_expr.int_val > max)
+    {
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, arg, ctx->file_path, "prefetch %s must be an integer literal from 0 to %llu", what, max);
+        return false;
+    }
+
+    analyze_expr_with_hint(driver, ctx, arg, type_u32());
+    return true;
+}
+
+// true when name is a bit-manipulation intrinsic or prefetch; the result type (NULL on error or for prefetch) goes to *out
+static bool analyze_bit_intrinsic(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *expr, const char *name, Type **out)
+{
+    size_t    arg_count = expr->call_expr.args ? expr->call_expr.args->count : 0;
+    AstNode **args      = expr->call_expr.args ? expr->call_expr.args->items : NULL;
+    *out                = NULL;
+
+    if (strcmp(name, "prefetch") == 0)
+    {
+        if (arg_count != 3)
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "prefetch expects a pointer, a read/write flag and a locality");
+            return true;
+        }
+
+        if (intrinsic_pointer_operand(driver, ctx, args[0], name) && prefetch_intrinsic_flag(driver, ctx, args[1], "read/write flag", 1))
+            prefetch_intrinsic_flag(driver, ctx, args[2], "locality", 3);
+        return true;
+    }
+
+    bool is_rotate = strcmp(name, "rotl") == 0 || strcmp(name, "rotr") == 0;
+    bool is_bswap  = strcmp(name, "bswap") == 0;
+    if (!is_rotate && !is_bswap && strcmp(name, "popcount") != 0 && strcmp(name, "clz") != 0 && strcmp(name, "ctz") != 0)
+        return false;
+
+    if (arg_count != (is_rotate ? 2u : 1u))
+    {
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, is_rotate ? "%s expects an integer and a rotation count" : "%s expects exactly one argument", name);
+        return true;
+    }
+
+    Type *value = analyze_expr(driver, ctx, args[0]);
+    if (!value)
+        return true;
+
+    Type *resolved = type_resolve_alias(value);
+    if (!type_is_integer(resolved))
+    {
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, args[0], ctx->file_path, "%s expects an integer operand", name);
+        return true;
+    }
+
+    if (is_bswap && resolved->size < 2)
+    {
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, args[0], ctx->file_path, "bswap expects an integer of at least 16 bits");
+        return true;
+    }
+
+    if (is_rotate)
+    {
+        Type *count = analyze_expr(driver, ctx, args[1]);
+        if (!count)
+            return true;
+        if (!type_is_integer(type_resolve_alias(count)))
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, args[1], ctx->file_path, "%s rotation count must be an integer", name);
+            return true;
+        }
+    }
+
+    expr->type = value;
+    *out       = value;
+    return true;
+}
+
+// true when name is a vec_* intrinsic; the result type (NULL on error or for vec_store) goes to *out
+static bool analyze_vector_intrinsic(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *expr, const char *name, Type **out)
+{
+    size_t arg_count = expr->call_expr.args ? expr->call_expr.args->count : 0;
+    *out             = NULL;
+
+    if (strcmp(name, "vec_splat") == 0)
+    {
+        Type *vector = vector_intrinsic_type_arg(driver, ctx, expr, name);
+        if (!vector)
+            return true;
+
+        if (arg_count != 1)
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "vec_splat expects exactly one argument");
+            return true;
+        }
+
+        AstNode *arg       = expr->call_expr.args->items[0];
+        Type    *elem_type = type_resolve_alias(vector)->vector.elem_type;
+        Type    *value     = analyze_expr_with_hint(driver, ctx, arg, elem_type);
+        if (!value || !ensure_assignable(driver, ctx, elem_type, value, arg, "vec_splat value"))
+            return true;
+
+        expr->type = vector;
+        *out       = vector;
+        return true;
+    }
+
+    if (strcmp(name, "vec_load") == 0)
+    {
+        Type *vector = vector_intrinsic_type_arg(driver, ctx, expr, name);
+        if (!vector)
+            return true;
+
+        if (arg_count != 1)
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "vec_load expects exactly one argument");
+            return true;
+        }
+
+        if (!intrinsic_pointer_operand(driver, ctx, expr->call_expr.args->items[0], name))
+            return true;
+
+        expr->type = vector;
+        *out       = vector;
+        return true;
+    }
+
+    if (strcmp(name, "vec_store") == 0)
+    {
+        if (arg_count != 2)
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "vec_store expects a pointer and a vector");
+            return true;
+        }
+
+        if (!intrinsic_pointer_operand(driver, ctx, expr->call_expr.args->items[0], name))
+            return true;
+
+        vector_intrinsic_operand(driver, ctx, expr->call_expr.args->items[1], name);
+        return true;
+    }
+
+    if (strcmp(name, "vec_shuffle") == 0)
+    {
+        if (arg_count < 4)
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "vec_shuffle expects two vectors and at least two lane indices");
+            return true;
+        }
+
+        Type *a = vector_intrinsic_operand(driver, ctx, expr->call_expr.args->items[0], name);
+        Type *b = vector_intrinsic_operand(driver, ctx, expr->call_expr.args->items[1], name);
+        if (!a || !b)
+            return true;
+
+        if (!type_equals(a, b))
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "vec_shuffle operands must have the same vector type");
+            return true;
+        }
+
+        size_t lanes = arg_count - 2;
+        if (lanes > 64 || (lanes & (lanes - 1)) != 0)
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "vec_shuffle lane count must be a power of two between 2 and 64");
+            return true;
+        }
+
+        for (size_t i = 2; i < arg_count; i++)
+        {
+            AstNode *index = expr->call_expr.args->items[i];
+            if (index->kind != AST_EXPR_LIT || index->lit_expr.kind != TOKEN_LIT_INT)
+            {
+                diagnostic_emit(&driver->diagnostics, DIAG_ERROR, index, ctx->file_path, "vec_shuffle lane index must be an integer literal");
+                return true;
+            }
+            if (index->lit_expr.int_val >= 2 * a->vector.count)
+            {
+                diagnostic_emit(&driver->diagnostics, DIAG_ERROR, index, ctx->file_path, "vec_shuffle lane index %llu out of range (operands have %zu lanes)", (unsigned long long)index->lit_expr.int_val, 2 * a->vector.count);
+                return true;
+            }
+            analyze_expr_with_hint(driver, ctx, index, type_u32());
+        }
+
+        expr->type = type_vector_create(a->vector.elem_type, lanes);
+        *out       = expr->type;
+        return true;
+    }
+
+    if (strncmp(name, "vec_reduce_", 11) == 0)
+    {
+        const char *op         = name + 11;
+        bool        is_bitwise = strcmp(op, "and") == 0 || strcmp(op, "or") == 0 || strcmp(op, "xor") == 0;
+        if (!is_bitwise && strcmp(op, "add") != 0 && strcmp(op, "mul") != 0 && strcmp(op, "min") != 0 && strcmp(op, "max") != 0)
+            return false;
+
+        if (arg_count != 1)
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "%s expects exactly one argument", name);
+            return true;
+        }
+
+        Type *vector = vector_intrinsic_operand(driver, ctx, expr->call_expr.args->items[0], name);
+        if (!vector)
+            return true;
+
+        if (is_bitwise && !type_is_integer(vector->vector.elem_type))
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "%s requires integer elements", name);
+            return true;
+        }
+
+        expr->type = vector->vector.elem_type;
+        *out       = expr->type;
+        return true;
+    }
+
+    return false;
+}
+
+static Type *analyze_call_expr(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *expr)
+{
+    // Handle potential method calls FIRST: obj.method(args) -> method(obj, args)
+    // This must happen before analyzing the func to avoid rejecting valid method calls
+    if (expr->call_expr.func && expr->call_expr.func->kind == AST_EXPR_FIELD)
+    {
+        AstNode *field_expr = expr->call_expr.func;
+        AstNode *receiver   = field_expr->field_expr.object;
+
+        // Special case: check if this is module.function() where object is an identifier for a module
+        if (receiver->kind == AST_EXPR_IDENT)
+        {
+            const char *obj_name = receiver->ident_expr.name;
+            Symbol     *obj_sym  = lookup_in_scope_chain(ctx->current_scope, ctx->module_scope, ctx->global_scope, obj_name);
+
+            if (obj_sym && obj_sym->kind == SYMBOL_MODULE)
+            {
+                // This is module.function() - fall through to normal call analysis
+                // The field expression will look up the function in the module scope
+                goto normal_call_analysis;
+            }
+        }
+
+        // Potential method call: analyze receiver and try method lookup
+        // analyze receiver to get its type
+        Type *receiver_type = analyze_expr(driver, ctx, receiver);
+        if (!receiver_type)
+            return NULL;
+
+        // look up method in the receiver's type
+        const char *method_name = field_expr->field_expr.field;
+
+        Symbol *method_sym        = NULL;
+        char    mangled_name[512] = {0};
+
+        // dereference pointer types for method lookup (methods can be called on pointer receivers)
+        Type *lookup_type = receiver_type;
+        if (lookup_type->kind == TYPE_POINTER)
             lookup_type = lookup_type->pointer.base;
 
         // try to find method on alias type before resolving (for types like string = []char)
@@ -3552,17 +4236,17 @@ normal_call_analysis:
             return expr->type;
         }
 
-        if (strcmp(intr_name, "va_arg") == 0)
+        if (strcmp(intr_name, "va_arg") == 0 || strcmp(intr_name, "va_type") == 0)
         {
             if (!ctx->current_function || !ctx->current_function->type || !ctx->current_function->type->function.is_variadic)
             {
-                diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "va_arg used outside variadic function");
+                diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "%s used outside variadic function", intr_name);
                 return NULL;
             }
 
             if (arg_count != 1)
             {
-                diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "va_arg expects exactly one argument");
+                diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "%s expects exactly one argument", intr_name);
                 return NULL;
             }
 
@@ -3574,13 +4258,53 @@ normal_call_analysis:
             index_type = type_resolve_alias(index_type);
             if (!type_is_integer(index_type))
             {
-                diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "va_arg index must be integer");
+                diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "%s index must be integer", intr_name);
+                return NULL;
+            }
+
+            // va_type yields the same tag as type_of() on the argument's type
+            expr->type = strcmp(intr_name, "va_type") == 0 ? type_u64() : type_pointer_create(type_u8());
+            return expr->type;
+        }
+
+        // likely(cond)/unlikely(cond) pass the truth value through as u8
+        if (strcmp(intr_name, "likely") == 0 || strcmp(intr_name, "unlikely") == 0)
+        {
+            if (arg_count != 1)
+            {
+                diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "%s expects exactly one condition", intr_name);
+                return NULL;
+            }
+
+            AstNode *cond      = expr->call_expr.args->items[0];
+            Type    *cond_type = analyze_expr(driver, ctx, cond);
+            if (!cond_type)
+                return NULL;
+
+            cond_type = type_resolve_alias(cond_type);
+            if (!type_is_numeric(cond_type) && !type_is_pointer_like(cond_type))
+            {
+                diagnostic_emit(&driver->diagnostics, DIAG_ERROR, cond, ctx->file_path, "%s expects a numeric or pointer condition", intr_name);
                 return NULL;
             }
 
-            expr->type = type_pointer_create(type_u8());
+            expr->type = type_u8();
             return expr->type;
         }
+
+        if (strcmp(intr_name, "mem_copy") == 0 || strcmp(intr_name, "mem_move") == 0 || strcmp(intr_name, "mem_set") == 0)
+        {
+            analyze_memory_intrinsic(driver, ctx, expr, intr_name);
+            return NULL;
+        }
+
+        Type *intrinsic_type = NULL;
+        if (strncmp(intr_name, "vec_", 4) == 0 && analyze_vector_intrinsic(driver, ctx, expr, intr_name, &intrinsic_type))
+            return intrinsic_type;
+        if ((strncmp(intr_name, "atomic_", 7) == 0 || strcmp(intr_name, "fence") == 0) && analyze_atomic_intrinsic(driver, ctx, expr, intr_name, &intrinsic_type))
+            return intrinsic_type;
+        if (analyze_bit_intrinsic(driver, ctx, expr, intr_name, &intrinsic_type))
+            return intrinsic_type;
     }
 
     Type *func_type = analyze_expr(driver, ctx, expr->call_expr.func);
@@ -3781,14 +4505,12 @@ static Type *analyze_field_expr(SemanticDriver *driver, const AnalysisContext *c
         return NULL;
     }
 
-    for (Symbol *field = object_type->composite.fields; field; field = field->next)
+    Symbol *field = type_find_field(object_type, expr->field_expr.field);
+    if (field)
     {
-        if (field->name && strcmp(field->name, expr->field_expr.field) == 0)
-        {
-            expr->symbol = field;
-            expr->type   = field->type;
-            return field->type;
-        }
+        expr->symbol = field;
+        expr->type   = field->type;
+        return field->type;
     }
 
     diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "no member named '%s'", expr->field_expr.field);
@@ -3812,6 +4534,25 @@ static Type *analyze_index_expr(SemanticDriver *driver, const AnalysisContext *c
 
     array_type = type_resolve_alias(array_type);
 
+    if (array_type->kind == TYPE_VECTOR)
+    {
+        if (!type_is_integer(index_type))
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr->index_expr.index, ctx->file_path, "vector lane index must be integer");
+            return NULL;
+        }
+
+        // a constant lane past the vector width would read or write poison
+        AstNode *lane = expr->index_expr.index;
+        if (lane->kind == AST_EXPR_LIT && lane->lit_expr.kind == TOKEN_LIT_INT && lane->lit_expr.int_val >= array_type->vector.count)
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, lane, ctx->file_path, "vector lane index %llu out of range (vector has %zu lanes)", (unsigned long long)lane->lit_expr.int_val, array_type->vector.count);
+            return NULL;
+        }
+        expr->type = array_type->vector.elem_type;
+        return expr->type;
+    }
+
     if (array_type->kind != TYPE_ARRAY)
     {
         diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "cannot index non-array type");
@@ -3845,10 +4586,19 @@ static Type *analyze_cast_expr(SemanticDriver *driver, const AnalysisContext *ct
         return NULL;
 
     // validate cast is legal
-    bool valid = false;
+    bool  valid        = false;
+    Type *source_value = type_resolve_alias(source);
+    Type *target_value = type_resolve_alias(target);
+
+    // vectors reinterpret their bits only as another vector, an integer or a float of the same size
+    if (type_is_vector(source_value) || type_is_vector(target_value))
+    {
+        Type *other = type_is_vector(source_value) ? target_value : source_value;
+        valid       = source_value->size == target_value->size && (type_is_vector(other) || type_is_numeric(other));
+    }
 
     // same size types can always be cast (reinterpret bits)
-    if (source->size == target->size)
+    else if (source->size == target->size)
         valid = true;
 
     // numeric to numeric (different sizes - truncate or extend)
@@ -3865,7 +4615,11 @@ static Type *analyze_cast_expr(SemanticDriver *driver, const AnalysisContext *ct
 
     if (!valid)
     {
-        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "invalid cast from '%s' to '%s'", source->name, target->name);
+        char *from = type_to_string(source);
+        char *to   = type_to_string(target);
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "invalid cast from '%s' to '%s'", from, to);
+        free(from);
+        free(to);
         return NULL;
     }
 
@@ -3923,17 +4677,8 @@ static Type *analyze_struct_expr(SemanticDriver *driver, const AnalysisContext *
                 AstNode    *value_expr = field_init->field_expr.object;
 
                 // find field in struct type
-                Symbol *field_sym  = resolved_type->composite.fields;
-                Type   *field_type = NULL;
-                while (field_sym)
-                {
-                    if (strcmp(field_sym->name, field_name) == 0)
-                    {
-                        field_type = field_sym->type;
-                        break;
-                    }
-                    field_sym = field_sym->next;
-                }
+                Symbol *field_sym  = type_find_field(resolved_type, field_name);
+                Type   *field_type = field_sym ? field_sym->type : NULL;
 
                 // if value is also a struct literal without type, inject the field's type
                 Type *value_type = analyze_expr_with_hint(driver, ctx, value_expr, field_type);
@@ -4108,6 +4853,32 @@ static Type *analyze_array_expr(SemanticDriver *driver, const AnalysisContext *c
         return specified_type;
     }
 
+    if (resolved_type->kind == TYPE_VECTOR)
+    {
+        // a single element is splatted across every lane
+        size_t elem_count = expr->array_expr.elems ? (size_t)expr->array_expr.elems->count : 0;
+        if (elem_count != 1 && elem_count != resolved_type->vector.count)
+        {
+            diagnostic_emit(&driver->diagnostics, DIAG_ERROR, expr, ctx->file_path, "vector literal expects 1 or %zu elements, got %zu", resolved_type->vector.count, elem_count);
+            return NULL;
+        }
+
+        Type *elem_type = resolved_type->vector.elem_type;
+        for (size_t i = 0; i < elem_count; i++)
+        {
+            AstNode *elem       = expr->array_expr.elems->items[i];
+            Type    *value_type = analyze_expr_with_hint(driver, ctx, elem, elem_type);
+            if (!value_type)
+                return NULL;
+
+            if (!ensure_assignable(driver, ctx, elem_type, value_type, elem, "vector element"))
+                return NULL;
+        }
+
+        expr->type = specified_type;
+        return specified_type;
+    }
+
     if (resolved_type->kind == TYPE_STRUCT || resolved_type->kind == TYPE_UNION)
         return analyze_array_as_struct(driver, ctx, expr, specified_type, resolved_type);
 
@@ -4220,6 +4991,18 @@ static bool analyze_block_stmt(SemanticDriver *driver, const AnalysisContext *ct
     return success;
 }
 
+// intrinsics that produce no value and are only valid as statements
+static bool intrinsic_is_void(const char *name)
+{
+    static const char *names[] = {"vec_store", "mem_copy", "mem_move", "mem_set", "atomic_store", "fence", "prefetch"};
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        if (strcmp(name, names[i]) == 0)
+            return true;
+    }
+    return false;
+}
+
 static bool analyze_expr_stmt(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *stmt)
 {
     Type *type = analyze_expr(driver, ctx, stmt->expr_stmt.expr);
@@ -4242,6 +5025,13 @@ static bool analyze_expr_stmt(SemanticDriver *driver, const AnalysisContext *ctx
                 // void call used as expression is valid
                 return true;
             }
+
+            AstNode *callee = stmt->expr_stmt.expr->call_expr.func;
+            if (callee && callee->kind == AST_EXPR_IDENT && intrinsic_is_void(callee->ident_expr.name))
+            {
+                // void intrinsics report their own errors
+                return !driver->diagnostics.has_errors;
+            }
         }
 
         return false;
@@ -4249,6 +5039,44 @@ static bool analyze_expr_stmt(SemanticDriver *driver, const AnalysisContext *ctx
     return true;
 }
 
+static bool comptime_find_mach_call(AstNode *node, void *user_data)
+{
+    bool *found = user_data;
+    if (node->kind == AST_EXPR_CALL && node->call_expr.func && node->call_expr.func->symbol && node->call_expr.func->symbol->kind == SYMBOL_FUNC)
+        *found = true;
+    return !*found;
+}
+
+// queue an initializer for the interpreter; globals that call mach functions have no other way to run
+static bool comptime_request_push(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *stmt, bool is_global)
+{
+    bool wanted = stmt->var_stmt.is_comptime;
+    if (!wanted && is_global && stmt->var_stmt.init)
+        ast_visit(stmt->var_stmt.init, comptime_find_mach_call, &wanted);
+    if (!wanted)
+        return true;
+
+    if (!stmt->var_stmt.init)
+    {
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, stmt, ctx->file_path, "'#@comptime' variable '%s' needs an initializer", stmt->var_stmt.name);
+        return false;
+    }
+
+    ComptimeRequest *request = malloc(sizeof(ComptimeRequest));
+    if (!request)
+        return false;
+    request->stmt      = stmt;
+    request->file_path = ctx->file_path;
+    request->next      = NULL;
+
+    if (driver->comptime_tail)
+        driver->comptime_tail->next = request;
+    else
+        driver->comptime_head = request;
+    driver->comptime_tail = request;
+    return true;
+}
+
 static bool analyze_var_stmt_body(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *stmt)
 {
     const char *name   = stmt->var_stmt.name;
@@ -4274,7 +5102,7 @@ static bool analyze_var_stmt_body(SemanticDriver *driver, const AnalysisContext
                 return false;
             }
         }
-        return true;
+        return comptime_request_push(driver, ctx, stmt, true);
     }
 
     // local variable - create symbol and analyze
@@ -4353,7 +5181,7 @@ static bool analyze_var_stmt_body(SemanticDriver *driver, const AnalysisContext
     symbol->type = var_type;
     stmt->type   = var_type;
 
-    return true;
+    return comptime_request_push(driver, ctx, stmt, false);
 }
 
 static bool analyze_ret_stmt(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *stmt)
@@ -4376,87 +5204,368 @@ static bool analyze_ret_stmt(SemanticDriver *driver, const AnalysisContext *ctx,
         return true;
     }
 
-    Type *ret_type = analyze_expr(driver, ctx, stmt->ret_stmt.expr);
-    if (!ret_type)
-        return false;
+    Type *ret_type = analyze_expr(driver, ctx, stmt->ret_stmt.expr);
+    if (!ret_type)
+        return false;
+
+    if (!func_ret)
+    {
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, stmt, ctx->file_path, "void function cannot return a value");
+        return false;
+    }
+
+    if (!type_equals(ret_type, func_ret) && !type_can_assign_to(ret_type, func_ret))
+    {
+        char *ret_type_str = type_to_string(ret_type);
+        char *func_ret_str = type_to_string(func_ret);
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, stmt, ctx->file_path, "incompatible return type (expected '%s', got '%s')", func_ret_str ? func_ret_str : "<unknown>", ret_type_str ? ret_type_str : "<unknown>");
+        free(ret_type_str);
+        free(func_ret_str);
+        return false;
+    }
+
+    return true;
+}
+
+static bool analyze_if_stmt(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *stmt)
+{
+    Type *cond_type = NULL;
+    if (stmt->cond_stmt.cond)
+    {
+        cond_type = analyze_expr(driver, ctx, stmt->cond_stmt.cond);
+        if (!cond_type)
+        {
+            return false;
+        }
+    }
+
+    bool success = analyze_stmt(driver, ctx, stmt->cond_stmt.body);
+
+    if (stmt->cond_stmt.stmt_or)
+        success = analyze_stmt(driver, ctx, stmt->cond_stmt.stmt_or) && success;
+
+    return success;
+}
+
+static bool analyze_for_stmt(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *stmt)
+{
+    if (stmt->for_stmt.cond)
+    {
+        Type *cond_type = analyze_expr(driver, ctx, stmt->for_stmt.cond);
+        if (!cond_type)
+        {
+            return false;
+        }
+    }
+
+    return analyze_stmt(driver, ctx, stmt->for_stmt.body);
+}
+
+static bool analyze_stmt(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *stmt)
+{
+    if (!stmt)
+        return true;
+
+    switch (stmt->kind)
+    {
+    case AST_STMT_BLOCK:
+        return analyze_block_stmt(driver, ctx, stmt);
+    case AST_STMT_EXPR:
+        return analyze_expr_stmt(driver, ctx, stmt);
+    case AST_STMT_VAR:
+    case AST_STMT_VAL:
+        return analyze_var_stmt_body(driver, ctx, stmt);
+    case AST_STMT_RET:
+        return analyze_ret_stmt(driver, ctx, stmt);
+    case AST_STMT_IF:
+    case AST_STMT_OR:
+        return analyze_if_stmt(driver, ctx, stmt);
+    case AST_STMT_FOR:
+        return analyze_for_stmt(driver, ctx, stmt);
+    default:
+        return true;
+    }
+}
+
+// bounds check elimination
+//
+// runs on analysed function bodies. a slice access `s[i]` needs no check when
+// it sits in the body of `for i < s.len` (possibly one conjunct of `&&`), i is
+// an unsigned local that has not been reassigned on the way to the access,
+// and neither i nor s can be changed behind the analyser's back. accesses with
+// a loop-invariant index that run unconditionally at the top of the body are
+// hoisted: they are checked once before the first iteration instead.
+
+typedef struct BoundsQuery
+{
+    Symbol *symbol;
+    bool    written;       // assigned (directly or through a field)
+    bool    address_taken; // address escapes via ?expr
+} BoundsQuery;
+
+typedef struct BoundsLoop
+{
+    Symbol *index; // loop index proven below slice.len
+    Symbol *slice;
+    bool    dirty; // index was possibly reassigned
+} BoundsLoop;
+
+typedef struct BoundsHoist
+{
+    AstNode *body; // function body
+    AstNode *loop;
+    bool     impure; // statement calls or short-circuits
+} BoundsHoist;
+
+static Symbol *bounds_local_symbol(AstNode *expr)
+{
+    if (!expr || expr->kind != AST_EXPR_IDENT || !expr->symbol)
+        return NULL;
+
+    Symbol *sym = expr->symbol;
+    if (sym->kind == SYMBOL_PARAM)
+        return sym;
+    if ((sym->kind == SYMBOL_VAR || sym->kind == SYMBOL_VAL) && !sym->var.is_global)
+        return sym;
+    return NULL;
+}
+
+static Symbol *bounds_root_symbol(AstNode *expr)
+{
+    while (expr && expr->kind == AST_EXPR_FIELD)
+        expr = expr->field_expr.object;
+    return expr && expr->kind == AST_EXPR_IDENT ? expr->symbol : NULL;
+}
+
+static bool bounds_is_slice(Symbol *sym)
+{
+    Type *type = sym ? type_resolve_alias(sym->type) : NULL;
+    return type && type->kind == TYPE_ARRAY && type->array.is_slice;
+}
+
+static bool bounds_is_unsigned(Symbol *sym)
+{
+    Type *type = sym ? type_resolve_alias(sym->type) : NULL;
+    return type && type_is_integer(type) && !type_is_signed(type);
+}
+
+static bool bounds_query_visit(AstNode *node, void *user_data)
+{
+    BoundsQuery *query = user_data;
+
+    if (node->kind == AST_EXPR_BINARY && node->binary_expr.op == TOKEN_EQUAL && bounds_root_symbol(node->binary_expr.left) == query->symbol)
+        query->written = true;
+    else if (node->kind == AST_EXPR_UNARY && node->unary_expr.op == TOKEN_QUESTION && bounds_root_symbol(node->unary_expr.expr) == query->symbol)
+        query->address_taken = true;
+
+    return true;
+}
+
+static BoundsQuery bounds_query(AstNode *tree, Symbol *symbol)
+{
+    BoundsQuery query = {symbol, false, false};
+    ast_visit(tree, bounds_query_visit, &query);
+    return query;
+}
+
+// true when sym can only change through assignments visible in the function
+static bool bounds_is_tracked(AstNode *body, Symbol *sym)
+{
+    return sym && !bounds_query(body, sym).address_taken;
+}
+
+// matches `i < s.len` or `s.len > i` (searching through `&&`)
+static bool bounds_match_guard(AstNode *cond, Symbol **index, Symbol **slice)
+{
+    if (!cond || cond->kind != AST_EXPR_BINARY)
+        return false;
+
+    if (cond->binary_expr.op == TOKEN_AMPERSAND_AMPERSAND)
+        return bounds_match_guard(cond->binary_expr.left, index, slice) || bounds_match_guard(cond->binary_expr.right, index, slice);
+
+    AstNode *lhs, *len;
+    if (cond->binary_expr.op == TOKEN_LESS)
+    {
+        lhs = cond->binary_expr.left;
+        len = cond->binary_expr.right;
+    }
+    else if (cond->binary_expr.op == TOKEN_GREATER)
+    {
+        lhs = cond->binary_expr.right;
+        len = cond->binary_expr.left;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (len->kind != AST_EXPR_FIELD || !len->field_expr.field || strcmp(len->field_expr.field, "len") != 0)
+        return false;
+
+    Symbol *i = bounds_local_symbol(lhs);
+    Symbol *s = bounds_local_symbol(len->field_expr.object);
+    if (!bounds_is_unsigned(i) || !bounds_is_slice(s))
+        return false;
+
+    *index = i;
+    *slice = s;
+    return true;
+}
+
+static bool bounds_loop_visit(AstNode *node, void *user_data)
+{
+    BoundsLoop *loop = user_data;
+    if (loop->dirty)
+        return false;
+
+    // conservatively stop at the first expression or nested loop that may reassign the index
+    if ((node->kind >= AST_EXPR_BINARY && node->kind <= AST_EXPR_STRUCT) || node->kind == AST_STMT_FOR)
+    {
+        if (bounds_query(node, loop->index).written)
+        {
+            loop->dirty = true;
+            return false;
+        }
+    }
+
+    if (node->kind == AST_EXPR_INDEX && bounds_local_symbol(node->index_expr.array) == loop->slice && bounds_local_symbol(node->index_expr.index) == loop->index)
+        node->index_expr.bounds_safe = true;
+
+    return true;
+}
+
+static bool bounds_hoist_impure_visit(AstNode *node, void *user_data)
+{
+    BoundsHoist *hoist = user_data;
+
+    // body statements may assign but must not branch; the condition may branch but not assign
+    if (node->kind == AST_EXPR_CALL || node->kind == AST_EXPR_VARARGS)
+        hoist->impure = true;
+    else if (node->kind == AST_EXPR_BINARY && (node->binary_expr.op == TOKEN_AMPERSAND_AMPERSAND || node->binary_expr.op == TOKEN_PIPE_PIPE))
+        hoist->impure = hoist->loop != NULL;
+    else if (node->kind == AST_EXPR_BINARY && node->binary_expr.op == TOKEN_EQUAL)
+        hoist->impure = hoist->loop == NULL;
+
+    return !hoist->impure;
+}
+
+static bool bounds_is_invariant(BoundsHoist *hoist, AstNode *expr)
+{
+    Symbol *sym = bounds_local_symbol(expr);
+    return sym && bounds_is_tracked(hoist->body, sym) && !bounds_query(hoist->loop, sym).written;
+}
+
+static bool bounds_hoist_visit(AstNode *node, void *user_data)
+{
+    BoundsHoist *hoist = user_data;
+
+    if (node->kind != AST_EXPR_INDEX || node->index_expr.bounds_safe)
+        return true;
+
+    AstNode *array = node->index_expr.array;
+    AstNode *index = node->index_expr.index;
+    if (!bounds_is_slice(bounds_local_symbol(array)) || !bounds_is_invariant(hoist, array))
+        return true;
+
+    bool constant_index = index->kind == AST_EXPR_LIT && index->lit_expr.kind == TOKEN_LIT_INT;
+    if (!constant_index && !bounds_is_invariant(hoist, index))
+        return true;
+
+    node->index_expr.bounds_safe = true;
+    ast_list_append(hoist->loop->for_stmt.bounds_hoisted, node);
+    return true;
+}
+
+static void bounds_hoist_loop(AstNode *body, AstNode *loop)
+{
+    // the condition is re-evaluated ahead of the loop, so it must be side-effect free
+    BoundsHoist cond_check = {body, NULL, false};
+    ast_visit(loop->for_stmt.cond, bounds_hoist_impure_visit, &cond_check);
+    if (cond_check.impure)
+        return;
 
-    if (!func_ret)
+    AstNode  *loop_body = loop->for_stmt.body;
+    AstNode **stmts     = &loop->for_stmt.body;
+    int       count     = 1;
+    if (loop_body && loop_body->kind == AST_STMT_BLOCK)
     {
-        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, stmt, ctx->file_path, "void function cannot return a value");
-        return false;
+        stmts = loop_body->block_stmt.stmts ? loop_body->block_stmt.stmts->items : NULL;
+        count = loop_body->block_stmt.stmts ? loop_body->block_stmt.stmts->count : 0;
     }
 
-    if (!type_equals(ret_type, func_ret) && !type_can_assign_to(ret_type, func_ret))
+    // only accesses that run unconditionally before any observable effect
+    for (int i = 0; i < count; i++)
     {
-        char *ret_type_str = type_to_string(ret_type);
-        char *func_ret_str = type_to_string(func_ret);
-        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, stmt, ctx->file_path, "incompatible return type (expected '%s', got '%s')", func_ret_str ? func_ret_str : "<unknown>", ret_type_str ? ret_type_str : "<unknown>");
-        free(ret_type_str);
-        free(func_ret_str);
-        return false;
-    }
+        AstNode *stmt = stmts[i];
+        AstNode *expr = NULL;
+        if (stmt && stmt->kind == AST_STMT_EXPR)
+            expr = stmt->expr_stmt.expr;
+        else if (stmt && (stmt->kind == AST_STMT_VAR || stmt->kind == AST_STMT_VAL))
+            expr = stmt->var_stmt.init;
+        else
+            break;
 
-    return true;
+        BoundsHoist hoist = {body, loop, false};
+        ast_visit(expr, bounds_hoist_impure_visit, &hoist);
+        if (hoist.impure)
+            break;
+
+        ast_visit(expr, bounds_hoist_visit, &hoist);
+    }
 }
 
-static bool analyze_if_stmt(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *stmt)
+static bool bounds_function_visit(AstNode *node, void *user_data)
 {
-    Type *cond_type = NULL;
-    if (stmt->cond_stmt.cond)
+    AstNode *body = user_data;
+    if (node->kind != AST_STMT_FOR)
+        return true;
+
+    if (!node->for_stmt.bounds_hoisted)
     {
-        cond_type = analyze_expr(driver, ctx, stmt->cond_stmt.cond);
-        if (!cond_type)
-        {
-            return false;
-        }
+        node->for_stmt.bounds_hoisted = malloc(sizeof(AstList));
+        ast_list_init(node->for_stmt.bounds_hoisted);
     }
 
-    bool success = analyze_stmt(driver, ctx, stmt->cond_stmt.body);
-
-    if (stmt->cond_stmt.stmt_or)
-        success = analyze_stmt(driver, ctx, stmt->cond_stmt.stmt_or) && success;
+    Symbol *index = NULL;
+    Symbol *slice = NULL;
+    if (bounds_match_guard(node->for_stmt.cond, &index, &slice) && bounds_is_tracked(body, index) && bounds_is_tracked(body, slice) && !bounds_query(node, slice).written)
+    {
+        BoundsLoop loop = {index, slice, false};
+        ast_visit(node->for_stmt.body, bounds_loop_visit, &loop);
+    }
 
-    return success;
+    bounds_hoist_loop(body, node);
+    return true;
 }
 
-static bool analyze_for_stmt(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *stmt)
+static bool bounds_disable_visit(AstNode *node, void *user_data)
 {
-    if (stmt->for_stmt.cond)
-    {
-        Type *cond_type = analyze_expr(driver, ctx, stmt->for_stmt.cond);
-        if (!cond_type)
-        {
-            return false;
-        }
-    }
+    (void)user_data;
+    if (node->kind == AST_EXPR_INDEX)
+        node->index_expr.bounds_safe = true;
+    return true;
+}
 
-    return analyze_stmt(driver, ctx, stmt->for_stmt.body);
+// analysis may run more than once over the same tree: a hoisted list left from an earlier run
+// would be dropped while its accesses stayed marked safe, so forget every earlier fact first
+static bool bounds_reset_visit(AstNode *node, void *user_data)
+{
+    (void)user_data;
+    if (node->kind == AST_EXPR_INDEX)
+        node->index_expr.bounds_safe = false;
+    else if (node->kind == AST_STMT_FOR && node->for_stmt.bounds_hoisted)
+        node->for_stmt.bounds_hoisted->count = 0;
+    return true;
 }
 
-static bool analyze_stmt(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *stmt)
+static void bounds_analyze_function(SemanticDriver *driver, AstNode *body)
 {
-    if (!stmt)
-        return true;
+    ast_visit(body, bounds_reset_visit, NULL);
 
-    switch (stmt->kind)
-    {
-    case AST_STMT_BLOCK:
-        return analyze_block_stmt(driver, ctx, stmt);
-    case AST_STMT_EXPR:
-        return analyze_expr_stmt(driver, ctx, stmt);
-    case AST_STMT_VAR:
-    case AST_STMT_VAL:
-        return analyze_var_stmt_body(driver, ctx, stmt);
-    case AST_STMT_RET:
-        return analyze_ret_stmt(driver, ctx, stmt);
-    case AST_STMT_IF:
-    case AST_STMT_OR:
-        return analyze_if_stmt(driver, ctx, stmt);
-    case AST_STMT_FOR:
-        return analyze_for_stmt(driver, ctx, stmt);
-    default:
-        return true;
-    }
+    if (driver->bounds_checks == BOUNDS_CHECKS_OFF)
+        ast_visit(body, bounds_disable_visit, NULL);
+    else if (driver->bounds_checks == BOUNDS_CHECKS_LOOPS)
+        ast_visit(body, bounds_function_visit, body);
 }
 
 static bool analyze_function_body(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *stmt)
@@ -4464,6 +5573,9 @@ static bool analyze_function_body(SemanticDriver *driver, const AnalysisContext
     if (!stmt->fun_stmt.body)
         return true; // external function
 
+    if (stmt->symbol && stmt->symbol->kind == SYMBOL_FUNC)
+        stmt->symbol->func.is_analyzed = true;
+
     // create a dedicated scope for function-local symbols
     const char *scope_name = stmt->fun_stmt.name ? stmt->fun_stmt.name : "<lambda>";
     Scope      *func_scope = scope_create(ctx->current_scope, scope_name);
@@ -4536,12 +5648,14 @@ static bool analyze_function_body(SemanticDriver *driver, const AnalysisContext
     }
 
     bool success = analyze_stmt(driver, &func_ctx, stmt->fun_stmt.body);
+    if (success)
+        bounds_analyze_function(driver, stmt->fun_stmt.body);
 
     // function scope currently leaks; TODO: manage scope lifetime if needed
     return success;
 }
 
-static bool analyze_pass_c_bodies(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *root)
+static bool analyze_pass_c_globals(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *root)
 {
     if (!root || root->kind != AST_PROGRAM)
         return false;
@@ -4563,6 +5677,16 @@ static bool analyze_pass_c_bodies(SemanticDriver *driver, const AnalysisContext
         }
     }
 
+    return success;
+}
+
+static bool analyze_pass_c_bodies(SemanticDriver *driver, const AnalysisContext *ctx, AstNode *root)
+{
+    if (!root || root->kind != AST_PROGRAM)
+        return false;
+
+    bool success = analyze_pass_c_globals(driver, ctx, root);
+
     // analyze function bodies (including methods)
     for (int i = 0; i < root->program.stmts->count; i++)
     {
@@ -4581,6 +5705,306 @@ static bool analyze_pass_c_bodies(SemanticDriver *driver, const AnalysisContext
     return success;
 }
 
+// file holding a function the interpreter failed in; entry module functions have no module entry
+static const char *comptime_function_file(SemanticDriver *driver, Symbol *function, const char *fallback)
+{
+    if (!function)
+        return fallback;
+
+    FOR_EACH_MODULE(&driver->module_manager, module)
+    {
+        if (function->module_name && module->name && strcmp(function->module_name, module->name) == 0)
+            return module->file_path;
+    }
+    return driver->entry_module_name ? driver->entry_module_name : fallback;
+}
+
+// run queued initializers through the interpreter; codegen emits the results as constants
+static bool evaluate_comptime_requests(SemanticDriver *driver)
+{
+    bool           success = true;
+    ComptimeLimits limits  = comptime_default_limits();
+
+    for (ComptimeRequest *request = driver->comptime_head; request; request = request->next)
+    {
+        AstNode *stmt = request->stmt;
+        if (stmt->var_stmt.comptime_value)
+            continue;
+
+        ComptimeError error;
+        Type         *type = stmt->type ? stmt->type : (stmt->symbol ? stmt->symbol->type : NULL);
+
+        stmt->var_stmt.comptime_value = comptime_eval(stmt->var_stmt.init, type, limits, &error);
+        if (stmt->var_stmt.comptime_value)
+            continue;
+
+        const char *file_path = comptime_function_file(driver, error.function, request->file_path);
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, error.node ? error.node : stmt, file_path, "%s", error.message);
+        diagnostic_emit(&driver->diagnostics, DIAG_NOTE, stmt, request->file_path, "while evaluating '%s' at compile time", stmt->var_stmt.name);
+        success = false;
+    }
+
+    return success;
+}
+
+// growable symbol array for whole-program passes
+typedef struct SymbolList
+{
+    Symbol **items;
+    size_t   count;
+    size_t   capacity;
+} SymbolList;
+
+static bool symbol_list_push(SymbolList *list, Symbol *symbol)
+{
+    if (list->count == list->capacity)
+    {
+        size_t   capacity = list->capacity ? list->capacity * 2 : 64;
+        Symbol **items    = realloc(list->items, capacity * sizeof(Symbol *));
+        if (!items)
+            return false;
+        list->items    = items;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = symbol;
+    return true;
+}
+
+// functions with analysed bodies; left out functions are simply treated as unknown callees
+static void effects_set_add(Symbol *symbol, void *user_data)
+{
+    if (!symbol || symbol->kind != SYMBOL_FUNC || symbol->func.is_external || !symbol->func.is_analyzed || (symbol->func.is_generic && !symbol->func.is_specialized_instance))
+        return;
+    if (!symbol->decl || symbol->decl->kind != AST_STMT_FUN || !symbol->decl->fun_stmt.body)
+        return;
+    symbol_list_push(user_data, symbol);
+}
+
+static void effects_set_add_program(SymbolList *set, AstNode *root)
+{
+    for (int i = 0; root && root->kind == AST_PROGRAM && i < root->program.stmts->count; i++)
+    {
+        AstNode *stmt = root->program.stmts->items[i];
+        if (stmt->kind == AST_STMT_FUN)
+            effects_set_add(stmt->symbol, set);
+    }
+}
+
+// infer attributes over the whole call graph; imported clones read them through import_origin
+static void infer_function_effects(SemanticDriver *driver)
+{
+    SymbolList set = {0};
+    effects_set_add_program(&set, driver->program_root);
+    FOR_EACH_MODULE(&driver->module_manager, module)
+    {
+        effects_set_add_program(&set, module->ast);
+    }
+    specialization_cache_foreach(&driver->spec_cache, effects_set_add, &set);
+
+    effects_infer(set.items, set.count);
+    free(set.items);
+}
+
+// functions and globals are the only declarations that become code or data
+static bool reachability_is_tracked(Symbol *symbol)
+{
+    if (!symbol)
+        return false;
+    if (symbol->kind == SYMBOL_FUNC)
+        return !symbol->func.is_generic || symbol->func.is_specialized_instance;
+    return (symbol->kind == SYMBOL_VAR || symbol->kind == SYMBOL_VAL) && symbol->var.is_global;
+}
+
+static void reachability_mark(SymbolList *worklist, Symbol *symbol)
+{
+    while (symbol && symbol->import_origin && symbol->import_origin != symbol)
+        symbol = symbol->import_origin;
+    if (!reachability_is_tracked(symbol) || symbol->is_reachable)
+        return;
+    symbol->is_reachable = true;
+    symbol_list_push(worklist, symbol);
+}
+
+static bool reachability_visit(AstNode *node, void *user_data)
+{
+    reachability_mark(user_data, node->symbol);
+    return true;
+}
+
+// roots are the declarations that keep an external symbol (see ast_stmt_is_link_root)
+static void reachability_add_roots(SymbolList *worklist, AstNode *root, bool is_entry)
+{
+    if (!root || root->kind != AST_PROGRAM)
+        return;
+
+    bool has_asm = ast_program_has_asm(root);
+    for (int i = 0; i < root->program.stmts->count; i++)
+    {
+        AstNode *stmt = root->program.stmts->items[i];
+        if (ast_stmt_is_link_root(stmt, has_asm, is_entry))
+            reachability_mark(worklist, stmt->symbol);
+    }
+}
+
+static bool reachability_has_main(AstNode *root)
+{
+    for (int i = 0; root && root->kind == AST_PROGRAM && i < root->program.stmts->count; i++)
+    {
+        AstNode *stmt = root->program.stmts->items[i];
+        if (stmt->kind == AST_STMT_FUN && !stmt->fun_stmt.is_method && stmt->fun_stmt.body && strcmp(stmt->fun_stmt.name, "main") == 0)
+            return true;
+    }
+    return false;
+}
+
+static bool reachability_module_used(AstNode *root)
+{
+    for (int i = 0; root && root->kind == AST_PROGRAM && i < root->program.stmts->count; i++)
+    {
+        AstNode *stmt = root->program.stmts->items[i];
+        if ((stmt->kind == AST_STMT_FUN || stmt->kind == AST_STMT_VAL || stmt->kind == AST_STMT_VAR) && stmt->symbol && stmt->symbol->is_reachable)
+            return true;
+    }
+    return false;
+}
+
+static void demand_push(SymbolList *worklist, Symbol *symbol)
+{
+    while (symbol && symbol->import_origin && symbol->import_origin != symbol)
+        symbol = symbol->import_origin;
+    if (!symbol || symbol->kind != SYMBOL_FUNC || symbol->func.is_demanded)
+        return;
+    if (symbol->func.is_generic && !symbol->func.is_specialized_instance)
+        return;
+    symbol->func.is_demanded = true;
+    symbol_list_push(worklist, symbol);
+}
+
+static bool demand_visit(AstNode *node, void *user_data)
+{
+    demand_push(user_data, node->symbol);
+    return true;
+}
+
+static void demand_add_roots(SymbolList *worklist, AstNode *root, bool is_entry)
+{
+    if (!root || root->kind != AST_PROGRAM)
+        return;
+
+    bool has_asm = ast_program_has_asm(root);
+    for (int i = 0; i < root->program.stmts->count; i++)
+    {
+        AstNode *stmt = root->program.stmts->items[i];
+        if (stmt->kind == AST_STMT_FUN && (is_entry || ast_stmt_is_link_root(stmt, has_asm, false)))
+            demand_push(worklist, stmt->symbol);
+        else if (stmt->kind == AST_STMT_VAL || stmt->kind == AST_STMT_VAR)
+            ast_visit(stmt->var_stmt.init, demand_visit, worklist);
+    }
+}
+
+static Module *demand_find_module(SemanticDriver *driver, Symbol *symbol)
+{
+    FOR_EACH_MODULE(&driver->module_manager, module)
+    {
+        if (symbol->module_name && module->name && strcmp(symbol->module_name, module->name) == 0)
+            return module;
+    }
+    return NULL;
+}
+
+// analyse imported function bodies the first time the program can reach them; every global is a root,
+// since initializers were analysed eagerly and may call anything at compile time
+static bool analyze_demanded_bodies(SemanticDriver *driver)
+{
+    SymbolList worklist = {0};
+    demand_add_roots(&worklist, driver->program_root, true);
+    FOR_EACH_MODULE(&driver->module_manager, module)
+    {
+        demand_add_roots(&worklist, module->ast, false);
+    }
+
+    bool success = true;
+    while (worklist.count > 0)
+    {
+        Symbol  *symbol = worklist.items[--worklist.count];
+        AstNode *decl   = symbol->decl;
+        if (!decl || decl->kind != AST_STMT_FUN || !decl->fun_stmt.body)
+            continue;
+
+        if (!symbol->func.is_analyzed)
+        {
+            Module *module = demand_find_module(driver, symbol);
+            if (!module || !module->symbols)
+            {
+                diagnostic_emit(&driver->diagnostics, DIAG_ERROR, decl, driver->entry_module_name, "no module owns function '%s'", symbol->name);
+                success = false;
+                continue;
+            }
+
+            Scope          *module_scope = module->symbols->global_scope;
+            AnalysisContext module_ctx   = analysis_context_create(module_scope, module_scope, module->name, module->file_path);
+            if (!analyze_function_body(driver, &module_ctx, decl))
+            {
+                fprintf(stderr, "error: failed to analyze function '%s'\n", decl->fun_stmt.name ? decl->fun_stmt.name : "<anon>");
+                success = false;
+                continue;
+            }
+        }
+
+        ast_visit(decl->fun_stmt.body, demand_visit, &worklist);
+    }
+    free(worklist.items);
+    return success;
+}
+
+// mark every function and global reachable from the program roots so codegen can drop the rest;
+// programs without 'main' (libraries, objects linked by hand) keep everything
+static void eliminate_dead_declarations(SemanticDriver *driver)
+{
+    if (!reachability_has_main(driver->program_root))
+        return;
+
+    SymbolList worklist = {0};
+    reachability_add_roots(&worklist, driver->program_root, true);
+    FOR_EACH_MODULE(&driver->module_manager, module)
+    {
+        reachability_add_roots(&worklist, module->ast, false);
+    }
+
+    while (worklist.count > 0)
+    {
+        Symbol  *symbol = worklist.items[--worklist.count];
+        AstNode *decl   = symbol->decl;
+        if (!decl)
+            continue;
+
+        if (decl->kind == AST_STMT_FUN)
+        {
+            ast_visit(decl->fun_stmt.body, reachability_visit, &worklist);
+        }
+        else if ((decl->kind == AST_STMT_VAL || decl->kind == AST_STMT_VAR) && decl->var_stmt.comptime_value)
+        {
+            // folded initializers only keep the functions they take the address of
+            ComptimeValue *value = decl->var_stmt.comptime_value;
+            for (size_t i = 0; i < value->function_count; i++)
+                reachability_mark(&worklist, value->functions[i]);
+        }
+        else if (decl->kind == AST_STMT_VAL || decl->kind == AST_STMT_VAR)
+        {
+            ast_visit(decl->var_stmt.init, reachability_visit, &worklist);
+        }
+    }
+    free(worklist.items);
+
+    // imported modules with nothing left to emit are not compiled or linked
+    FOR_EACH_MODULE(&driver->module_manager, module)
+    {
+        if (module->needs_linking && !reachability_module_used(module->ast))
+            module->needs_linking = false;
+    }
+    driver->module_manager.prune_unreachable = true;
+}
+
 bool semantic_driver_analyze(SemanticDriver *driver, AstNode *root, const char *module_name, const char *module_path)
 {
     driver->program_root      = root;
@@ -4730,7 +6154,8 @@ bool semantic_driver_analyze(SemanticDriver *driver, AstNode *root, const char *
         success = false;
     }
 
-    // Analyze bodies in all loaded modules
+    // Analyze bodies in all loaded modules; programs with 'main' only analyse imported bodies they reach
+    bool on_demand = reachability_has_main(root);
     FOR_EACH_MODULE(&driver->module_manager, module)
     {
         if (success && module->ast && module->ast->kind == AST_PROGRAM)
@@ -4738,7 +6163,8 @@ bool semantic_driver_analyze(SemanticDriver *driver, AstNode *root, const char *
             Scope          *module_scope = module->symbols->global_scope;
             AnalysisContext module_ctx   = analysis_context_create(module_scope, module_scope, module->name, module->file_path);
 
-            if (!analyze_pass_c_bodies(driver, &module_ctx, module->ast))
+            bool analyzed = on_demand ? analyze_pass_c_globals(driver, &module_ctx, module->ast) : analyze_pass_c_bodies(driver, &module_ctx, module->ast);
+            if (!analyzed)
             {
                 fprintf(stderr, "error: body analysis failed in module '%s'\n", module->name ? module->name : "<unknown>");
                 diagnostic_emit(&driver->diagnostics, DIAG_ERROR, NULL, module->name, "body analysis pass failed for module '%s'", module->name);
@@ -4747,6 +6173,12 @@ bool semantic_driver_analyze(SemanticDriver *driver, AstNode *root, const char *
         }
     }
 
+    if (success && on_demand && !analyze_demanded_bodies(driver))
+    {
+        diagnostic_emit(&driver->diagnostics, DIAG_ERROR, NULL, module_path, "body analysis pass failed for imported functions");
+        success = false;
+    }
+
     if (!success)
     {
         if (driver->diagnostics.count > 0)
@@ -4771,6 +6203,18 @@ bool semantic_driver_analyze(SemanticDriver *driver, AstNode *root, const char *
         success = false;
     }
 
+    // compile-time initializers run once every function they may call is analysed
+    if (success && !driver->diagnostics.has_errors && !evaluate_comptime_requests(driver))
+        success = false;
+
+    // attribute inference needs every body, including specializations, to be final
+    if (success && !driver->diagnostics.has_errors)
+        infer_function_effects(driver);
+
+    // reachability runs last so it sees specializations and folded initializers
+    if (success && !driver->diagnostics.has_errors)
+        eliminate_dead_declarations(driver);
+
     // print diagnostics
     if (driver->diagnostics.count > 0)
     {
@@ -1,10 +1,45 @@
 #include "symbol.h"
+#include "arena.h"
 #include "ast.h"
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+// symbols, scopes, their names and indexes live as long as semantic analysis, so they share one arena
+static Arena g_symbol_arena;
+static bool  g_symbol_arena_ready = false;
+
+// the arena starts with the first symbol table, which may come before the driver analyses anything
+static Arena *symbol_arena(void)
+{
+    if (!g_symbol_arena_ready)
+    {
+        arena_init(&g_symbol_arena, 0);
+        g_symbol_arena_ready = true;
+    }
+    return &g_symbol_arena;
+}
+
+void *symbol_system_alloc(size_t size)
+{
+    return arena_alloc(symbol_arena(), size);
+}
+
+char *symbol_system_strdup(const char *text)
+{
+    return text ? arena_strdup(symbol_arena(), text) : NULL;
+}
+
+void symbol_system_dnit(void)
+{
+    if (g_symbol_arena_ready)
+    {
+        arena_dnit(&g_symbol_arena);
+        g_symbol_arena_ready = false;
+    }
+}
+
 void symbol_table_init(SymbolTable *table)
 {
     table->global_scope  = scope_create(NULL, "global");
@@ -12,9 +47,9 @@ void symbol_table_init(SymbolTable *table)
     table->module_scope  = NULL;
 }
 
+// the scopes and symbols stay in the symbol arena until symbol_system_dnit
 void symbol_table_dnit(SymbolTable *table)
 {
-    scope_destroy(table->global_scope);
     table->global_scope  = NULL;
     table->current_scope = NULL;
     table->module_scope  = NULL;
@@ -22,32 +57,17 @@ void symbol_table_dnit(SymbolTable *table)
 
 Scope *scope_create(Scope *parent, const char *name)
 {
-    Scope *scope     = malloc(sizeof(Scope));
-    scope->parent    = parent;
-    scope->symbols   = NULL;
-    scope->is_module = false;
-    scope->name      = name ? strdup(name) : NULL;
+    Scope *scope        = symbol_system_alloc(sizeof(Scope));
+    scope->parent       = parent;
+    scope->symbols      = NULL;
+    scope->is_module    = false;
+    scope->name         = symbol_system_strdup(name);
+    scope->symbol_count = 0;
+    scope->index        = NULL;
+    scope->index_size   = 0;
     return scope;
 }
 
-void scope_destroy(Scope *scope)
-{
-    if (!scope)
-        return;
-
-    // destroy all symbols
-    Symbol *symbol = scope->symbols;
-    while (symbol)
-    {
-        Symbol *next = symbol->next;
-        symbol_destroy(symbol);
-        symbol = next;
-    }
-
-    free(scope->name);
-    free(scope);
-}
-
 void scope_enter(SymbolTable *table, Scope *scope)
 {
     table->current_scope = scope;
@@ -71,28 +91,23 @@ Scope *scope_push(SymbolTable *table, const char *name)
 void scope_pop(SymbolTable *table)
 {
     if (table->current_scope && table->current_scope->parent)
-    {
-        Scope *old_scope     = table->current_scope;
-        table->current_scope = old_scope->parent;
-        scope_destroy(old_scope);
-    }
+        table->current_scope = table->current_scope->parent;
 }
 
 Symbol *symbol_create(SymbolKind kind, const char *name, Type *type, AstNode *decl)
 {
-    Symbol *symbol = malloc(sizeof(Symbol));
+    Symbol *symbol = symbol_system_alloc(sizeof(Symbol));
     if (!symbol)
         return NULL;
 
-    memset(symbol, 0, sizeof(Symbol));
-
     symbol->kind          = kind;
-    symbol->name          = name ? strdup(name) : NULL;
+    symbol->name          = symbol_system_strdup(name);
     symbol->type          = type;
     symbol->decl          = decl;
     symbol->home_scope    = NULL;
     symbol->next          = NULL;
     symbol->method_next   = NULL;
+    symbol->index_next    = NULL;
     symbol->is_imported   = false;
     symbol->is_public     = false;
     symbol->has_const_i64 = false;
@@ -100,15 +115,17 @@ Symbol *symbol_create(SymbolKind kind, const char *name, Type *type, AstNode *de
     symbol->import_module = NULL;
     symbol->module_name   = NULL;
     symbol->import_origin = NULL;
+    symbol->is_reachable  = false;
 
     // initialize kind-specific data
     switch (kind)
     {
     case SYMBOL_VAR:
     case SYMBOL_VAL:
-        symbol->var.is_global    = false;
-        symbol->var.is_const     = (kind == SYMBOL_VAL);
-        symbol->var.mangled_name = NULL;
+        symbol->var.is_global       = false;
+        symbol->var.is_const        = (kind == SYMBOL_VAL);
+        symbol->var.is_thread_local = false;
+        symbol->var.mangled_name    = NULL;
         break;
 
     case SYMBOL_FUNC:
@@ -128,11 +145,17 @@ Symbol *symbol_create(SymbolKind kind, const char *name, Type *type, AstNode *de
         symbol->func.method_forwarded_generic_count = 0;
         symbol->func.method_receiver_is_pointer     = false;
         symbol->func.method_receiver_name           = NULL;
+        symbol->func.is_analyzed                    = false;
+        symbol->func.is_demanded                    = false;
+        memset(&symbol->func.hints, 0, sizeof(FunHints));
+        memset(&symbol->func.effects, 0, sizeof(FunEffects));
         break;
 
     case SYMBOL_TYPE:
-        symbol->type_def.is_alias = false;
-        symbol->type_def.methods  = NULL;
+        symbol->type_def.is_alias          = false;
+        symbol->type_def.methods           = NULL;
+        symbol->type_def.method_slots      = NULL;
+        symbol->type_def.method_slot_count = 0;
         break;
 
     case SYMBOL_FIELD:
@@ -152,90 +175,50 @@ Symbol *symbol_create(SymbolKind kind, const char *name, Type *type, AstNode *de
     return symbol;
 }
 
-void symbol_destroy(Symbol *symbol)
-{
-    if (!symbol)
-        return;
+// scopes below this size are scanned; module and global scopes grow well past it
+#define SCOPE_INDEX_THRESHOLD 16
 
-    free(symbol->name);
-    free(symbol->module_name);
-    symbol->module_name = NULL;
+static size_t scope_hash_name(const char *name)
+{
+    size_t hash = 5381;
+    for (const unsigned char *c = (const unsigned char *)name; *c; c++)
+        hash = ((hash << 5) + hash) + *c;
+    return hash;
+}
 
-    if (symbol->kind == SYMBOL_MODULE)
-    {
-        if (symbol->module.scope && symbol->is_imported)
-        {
-            scope_destroy(symbol->module.scope);
-            symbol->module.scope = NULL;
-        }
-        free(symbol->module.path);
-        symbol->module.path = NULL;
-        // non-imported module scopes are managed separately
-    }
-    else if (symbol->kind == SYMBOL_FUNC)
-    {
-        free(symbol->func.extern_name);
-        free(symbol->func.convention);
-        free(symbol->func.mangled_name);
-        symbol->func.extern_name  = NULL;
-        symbol->func.convention   = NULL;
-        symbol->func.mangled_name = NULL;
-        free(symbol->func.method_receiver_name);
-        symbol->func.method_receiver_name = NULL;
-
-        if (symbol->func.generic_param_names)
-        {
-            for (size_t i = 0; i < symbol->func.generic_param_count; i++)
-            {
-                free(symbol->func.generic_param_names[i]);
-            }
-            free(symbol->func.generic_param_names);
-            symbol->func.generic_param_names = NULL;
-        }
-        GenericSpecialization *spec = symbol->func.generic_specializations;
-        if (!symbol->import_origin || symbol->import_origin == symbol)
-        {
-            while (spec)
-            {
-                GenericSpecialization *next = spec->next;
-                free(spec->type_args);
-                free(spec);
-                spec = next;
-            }
-        }
-        symbol->func.generic_specializations = NULL;
-    }
-    else if (symbol->kind == SYMBOL_VAR || symbol->kind == SYMBOL_VAL)
+// rebuild the bucket array; walking the list oldest first keeps the newest symbol at each chain head,
+// so indexed lookups return the same symbol the list scan would
+static void scope_rebuild_index(Scope *scope, size_t size)
+{
+    Symbol **index   = symbol_system_alloc(size * sizeof(Symbol *));
+    Symbol **ordered = malloc(scope->symbol_count * sizeof(Symbol *));
+    if (!index || !ordered)
     {
-        free(symbol->var.mangled_name);
-        symbol->var.mangled_name = NULL;
+        // fall back to scanning the list rather than keep an incomplete index
+        free(ordered);
+        scope->index      = NULL;
+        scope->index_size = 0;
+        return;
     }
-    else if (symbol->kind == SYMBOL_TYPE)
+
+    size_t count = 0;
+    for (Symbol *symbol = scope->symbols; symbol && count < scope->symbol_count; symbol = symbol->next)
+        ordered[count++] = symbol;
+
+    for (size_t i = count; i-- > 0;)
     {
-        if (symbol->type_def.generic_param_names)
-        {
-            for (size_t i = 0; i < symbol->type_def.generic_param_count; i++)
-            {
-                free(symbol->type_def.generic_param_names[i]);
-            }
-            free(symbol->type_def.generic_param_names);
-            symbol->type_def.generic_param_names = NULL;
-        }
-        if (!symbol->is_imported && symbol->type_def.methods)
-        {
-            Symbol *method = symbol->type_def.methods;
-            while (method)
-            {
-                Symbol *next_method = method->method_next;
-                method->method_next = NULL;
-                symbol_destroy(method);
-                method = next_method;
-            }
-        }
-        symbol->type_def.methods = NULL;
+        Symbol *symbol = ordered[i];
+        if (!symbol->name)
+            continue;
+        size_t bucket      = scope_hash_name(symbol->name) & (size - 1);
+        symbol->index_next = index[bucket];
+        index[bucket]      = symbol;
     }
+    free(ordered);
 
-    free(symbol);
+    // the outgrown bucket array stays in the arena; doubling bounds the waste to the final size
+    scope->index      = index;
+    scope->index_size = size;
 }
 
 void symbol_add(Scope *scope, Symbol *symbol)
@@ -249,6 +232,21 @@ void symbol_add(Scope *scope, Symbol *symbol)
     // add to front of list
     symbol->next   = scope->symbols;
     scope->symbols = symbol;
+    scope->symbol_count++;
+
+    if (scope->index && scope->symbol_count <= scope->index_size)
+    {
+        if (symbol->name)
+        {
+            size_t bucket        = scope_hash_name(symbol->name) & (scope->index_size - 1);
+            symbol->index_next   = scope->index[bucket];
+            scope->index[bucket] = symbol;
+        }
+    }
+    else if (scope->index || scope->symbol_count >= SCOPE_INDEX_THRESHOLD)
+    {
+        scope_rebuild_index(scope, scope->index_size ? scope->index_size * 2 : SCOPE_INDEX_THRESHOLD * 2);
+    }
 }
 
 Symbol *symbol_lookup(SymbolTable *table, const char *name)
@@ -272,6 +270,16 @@ Symbol *symbol_lookup_scope(Scope *scope, const char *name)
     if (!scope || !name)
         return NULL;
 
+    if (scope->index)
+    {
+        for (Symbol *symbol = scope->index[scope_hash_name(name) & (scope->index_size - 1)]; symbol; symbol = symbol->index_next)
+        {
+            if (strcmp(symbol->name, name) == 0)
+                return symbol;
+        }
+        return NULL;
+    }
+
     for (Symbol *symbol = scope->symbols; symbol; symbol = symbol->next)
     {
         if (symbol->name && strcmp(symbol->name, name) == 0)
@@ -343,15 +351,7 @@ Symbol *symbol_find_field(Symbol *composite_symbol, const char *field_name)
         return NULL;
     }
 
-    for (Symbol *field = composite_symbol->type->composite.fields; field; field = field->next)
-    {
-        if (field->name && strcmp(field->name, field_name) == 0)
-        {
-            return field;
-        }
-    }
-
-    return NULL;
+    return type_find_field(composite_symbol->type, field_name);
 }
 
 void type_add_method(Symbol *type_symbol, Symbol *method_symbol)
@@ -366,24 +366,62 @@ void type_add_method(Symbol *type_symbol, Symbol *method_symbol)
     method_symbol->func.is_method    = true;
     method_symbol->func.method_owner = type_symbol;
 
+    // the name index is rebuilt on the next lookup; the old one stays in type-system storage
+    type_symbol->type_def.method_slots      = NULL;
+    type_symbol->type_def.method_slot_count = 0;
+
     if (!method_symbol->home_scope && type_symbol->home_scope)
     {
         method_symbol->home_scope = type_symbol->home_scope;
     }
 }
 
-Symbol *type_find_method(Symbol *type_symbol, const char *method_name, bool receiver_is_pointer)
+// index methods by name; list order (newest first) is kept along each probe sequence
+static bool type_index_methods(Symbol *type_symbol)
 {
-    if (!type_symbol || type_symbol->kind != SYMBOL_TYPE || !method_name)
-        return NULL;
+    size_t count = 0;
+    for (Symbol *method = type_symbol->type_def.methods; method; method = method->method_next)
+        count++;
+
+    size_t slot_count = 8;
+    while (slot_count < count * 2)
+        slot_count *= 2;
+
+    Symbol **slots = type_system_alloc(slot_count * sizeof(Symbol *));
+    if (!slots)
+        return false;
 
     for (Symbol *method = type_symbol->type_def.methods; method; method = method->method_next)
     {
-        if (!method->name || strcmp(method->name, method_name) != 0)
-            continue;
-        if (method->func.method_receiver_is_pointer != receiver_is_pointer)
+        if (!method->name)
             continue;
-        return method;
+        size_t slot = scope_hash_name(method->name) & (slot_count - 1);
+        while (slots[slot])
+            slot = (slot + 1) & (slot_count - 1);
+        slots[slot] = method;
+    }
+
+    type_symbol->type_def.method_slots      = slots;
+    type_symbol->type_def.method_slot_count = slot_count;
+    return true;
+}
+
+Symbol *type_find_method(Symbol *type_symbol, const char *method_name, bool receiver_is_pointer)
+{
+    if (!type_symbol || type_symbol->kind != SYMBOL_TYPE || !method_name || !type_symbol->type_def.methods)
+        return NULL;
+
+    if (!type_symbol->type_def.method_slots && !type_index_methods(type_symbol))
+        return NULL;
+
+    // value and pointer receivers share a name, so keep probing past a receiver mismatch
+    size_t   mask  = type_symbol->type_def.method_slot_count - 1;
+    Symbol **slots = type_symbol->type_def.method_slots;
+    for (size_t slot = scope_hash_name(method_name) & mask; slots[slot]; slot = (slot + 1) & mask)
+    {
+        Symbol *method = slots[slot];
+        if (strcmp(method->name, method_name) == 0 && method->func.method_receiver_is_pointer == receiver_is_pointer)
+            return method;
     }
 
     return NULL;
@@ -462,7 +500,7 @@ size_t symbol_calculate_union_layout(Symbol *union_symbol)
 Symbol *symbol_create_module(const char *name, const char *path)
 {
     Symbol *module_symbol                  = symbol_create(SYMBOL_MODULE, name, NULL, NULL);
-    module_symbol->module.path             = path ? strdup(path) : NULL;
+    module_symbol->module.path             = symbol_system_strdup(path);
     module_symbol->module.scope            = scope_create(NULL, name);
     module_symbol->module.scope->is_module = true;
     return module_symbol;
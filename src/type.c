@@ -1,4 +1,5 @@
 #include "type.h"
+#include "arena.h"
 #include "ast.h"
 #include "symbol.h"
 #include <assert.h>
@@ -19,6 +20,15 @@ typedef struct PointerCacheEntry
 
 static PointerCacheEntry *g_pointer_cache = NULL;
 
+// types, their names and parameter lists live as long as the type system, so they share one arena
+static Arena g_type_arena;
+static bool  g_type_arena_ready = false;
+
+static Type *type_alloc(void)
+{
+    return arena_alloc(&g_type_arena, sizeof(Type));
+}
+
 static size_t type_align_to(size_t value, size_t alignment)
 {
     if (alignment <= 1)
@@ -30,17 +40,6 @@ static size_t type_align_to(size_t value, size_t alignment)
     return (value + mask) & ~mask;
 }
 
-static void type_free_field_list(Symbol *fields)
-{
-    while (fields)
-    {
-        Symbol *next = fields->next;
-        fields->next = NULL;
-        symbol_destroy(fields);
-        fields = next;
-    }
-}
-
 // type info table for builtin types
 static struct
 {
@@ -65,15 +64,22 @@ static struct
 
 void type_system_init(void)
 {
+    if (!g_type_arena_ready)
+    {
+        arena_init(&g_type_arena, 0);
+        g_type_arena_ready = true;
+    }
+
     // create builtin types
     for (size_t i = 0; i < sizeof(type_info_table) / sizeof(type_info_table[0]); i++)
     {
-        Type *type           = malloc(sizeof(Type));
+        Type *type           = type_alloc();
         type->kind           = type_info_table[i].kind;
         type->size           = type_info_table[i].size;
         type->alignment      = type_info_table[i].alignment;
-        type->name           = strdup(type_info_table[i].name);
+        type->name           = arena_strdup(&g_type_arena, type_info_table[i].name);
         type->generic_origin = NULL;
+        type->mangled        = NULL;
         type->type_args      = NULL;
         type->type_arg_count = 0;
 
@@ -82,12 +88,13 @@ void type_system_init(void)
 
     if (!g_error_type)
     {
-        g_error_type                 = malloc(sizeof(Type));
+        g_error_type                 = type_alloc();
         g_error_type->kind           = TYPE_ERROR;
         g_error_type->size           = 0;
         g_error_type->alignment      = 1;
-        g_error_type->name           = strdup("<error>");
+        g_error_type->name           = arena_strdup(&g_type_arena, "<error>");
         g_error_type->generic_origin = NULL;
+        g_error_type->mangled        = NULL;
         g_error_type->type_args      = NULL;
         g_error_type->type_arg_count = 0;
     }
@@ -96,30 +103,14 @@ void type_system_init(void)
 void type_system_dnit(void)
 {
     for (size_t i = 0; i < sizeof(g_builtin_types) / sizeof(g_builtin_types[0]); i++)
-    {
-        if (g_builtin_types[i])
-        {
-            free(g_builtin_types[i]->name);
-            free(g_builtin_types[i]);
-            g_builtin_types[i] = NULL;
-        }
-    }
-
-    PointerCacheEntry *entry = g_pointer_cache;
-    while (entry)
-    {
-        PointerCacheEntry *next = entry->next;
-        free(entry->pointer);
-        free(entry);
-        entry = next;
-    }
+        g_builtin_types[i] = NULL;
     g_pointer_cache = NULL;
+    g_error_type    = NULL;
 
-    if (g_error_type)
+    if (g_type_arena_ready)
     {
-        free(g_error_type->name);
-        free(g_error_type);
-        g_error_type = NULL;
+        arena_dnit(&g_type_arena);
+        g_type_arena_ready = false;
     }
 }
 
@@ -192,6 +183,16 @@ Type *type_lookup_builtin(const char *name)
     return NULL;
 }
 
+void *type_system_alloc(size_t size)
+{
+    return arena_alloc(&g_type_arena, size);
+}
+
+char *type_system_strndup(const char *text, size_t len)
+{
+    return arena_strndup(&g_type_arena, text, len);
+}
+
 Type *type_pointer_create(Type *base)
 {
     for (PointerCacheEntry *entry = g_pointer_cache; entry; entry = entry->next)
@@ -202,8 +203,9 @@ Type *type_pointer_create(Type *base)
         }
     }
 
-    Type *type           = malloc(sizeof(Type));
+    Type *type           = type_alloc();
     type->generic_origin = NULL;
+    type->mangled        = NULL;
     type->type_args      = NULL;
     type->type_arg_count = 0;
     type->kind           = TYPE_POINTER;
@@ -212,7 +214,7 @@ Type *type_pointer_create(Type *base)
     type->name           = NULL;
     type->pointer.base   = base;
 
-    PointerCacheEntry *entry = malloc(sizeof(PointerCacheEntry));
+    PointerCacheEntry *entry = arena_alloc(&g_type_arena, sizeof(PointerCacheEntry));
     entry->base              = base;
     entry->pointer           = type;
     entry->next              = g_pointer_cache;
@@ -223,12 +225,13 @@ Type *type_pointer_create(Type *base)
 
 Type *type_array_create(Type *elem_type)
 {
-    Type *type            = malloc(sizeof(Type));
+    Type *type            = type_alloc();
     type->kind            = TYPE_ARRAY;
     type->size            = 16; // fat pointer: {void *data, u64 len}
     type->alignment       = 8;
     type->name            = NULL;
     type->generic_origin  = NULL;
+    type->mangled         = NULL;
     type->type_args       = NULL;
     type->type_arg_count  = 0;
     type->array.elem_type = elem_type;
@@ -239,12 +242,13 @@ Type *type_array_create(Type *elem_type)
 
 Type *type_fixed_array_create(Type *elem_type, size_t size)
 {
-    Type *type            = malloc(sizeof(Type));
+    Type *type            = type_alloc();
     type->kind            = TYPE_ARRAY;
     type->size            = elem_type->size * size;
     type->alignment       = elem_type->alignment;
     type->name            = NULL;
     type->generic_origin  = NULL;
+    type->mangled         = NULL;
     type->type_args       = NULL;
     type->type_arg_count  = 0;
     type->array.elem_type = elem_type;
@@ -253,44 +257,71 @@ Type *type_fixed_array_create(Type *elem_type, size_t size)
     return type;
 }
 
+Type *type_vector_create(Type *elem_type, size_t count)
+{
+    Type *type             = type_alloc();
+    type->kind             = TYPE_VECTOR;
+    type->size             = elem_type->size * count;
+    type->alignment        = type->size; // llvm aligns vectors to their full width
+    type->name             = NULL;
+    type->generic_origin   = NULL;
+    type->mangled          = NULL;
+    type->type_args        = NULL;
+    type->type_arg_count   = 0;
+    type->vector.elem_type = elem_type;
+    type->vector.count     = count;
+    return type;
+}
+
 Type *type_struct_create(const char *name)
 {
-    Type *type                  = malloc(sizeof(Type));
+    Type *type                  = type_alloc();
     type->kind                  = TYPE_STRUCT;
     type->size                  = 0; // calculated later
     type->alignment             = 1; // calculated later
-    type->name                  = name ? strdup(name) : NULL;
+    type->name                  = arena_strdup(&g_type_arena, name);
     type->generic_origin        = NULL;
+    type->mangled               = NULL;
     type->type_args             = NULL;
     type->type_arg_count        = 0;
-    type->composite.fields      = NULL;
-    type->composite.field_count = 0;
+    type->composite.fields        = NULL;
+    type->composite.field_count   = 0;
+    type->composite.field_array   = NULL;
+    type->composite.field_slots   = NULL;
+    type->composite.slot_count    = 0;
+    type->composite.indexed_count = 0;
     return type;
 }
 
 Type *type_union_create(const char *name)
 {
-    Type *type                  = malloc(sizeof(Type));
+    Type *type                  = type_alloc();
     type->kind                  = TYPE_UNION;
     type->size                  = 0; // calculated later
     type->alignment             = 1; // calculated later
-    type->name                  = name ? strdup(name) : NULL;
+    type->name                  = arena_strdup(&g_type_arena, name);
     type->generic_origin        = NULL;
+    type->mangled               = NULL;
     type->type_args             = NULL;
     type->type_arg_count        = 0;
-    type->composite.fields      = NULL;
-    type->composite.field_count = 0;
+    type->composite.fields        = NULL;
+    type->composite.field_count   = 0;
+    type->composite.field_array   = NULL;
+    type->composite.field_slots   = NULL;
+    type->composite.slot_count    = 0;
+    type->composite.indexed_count = 0;
     return type;
 }
 
 Type *type_function_create(Type *return_type, Type **param_types, size_t param_count, bool is_variadic)
 {
-    Type *type                 = malloc(sizeof(Type));
+    Type *type                 = type_alloc();
     type->kind                 = TYPE_FUNCTION;
     type->size                 = 8; // function pointers are 8 bytes
     type->alignment            = 8;
     type->name                 = NULL;
     type->generic_origin       = NULL;
+    type->mangled              = NULL;
     type->type_args            = NULL;
     type->type_arg_count       = 0;
     type->function.return_type = return_type;
@@ -299,7 +330,7 @@ Type *type_function_create(Type *return_type, Type **param_types, size_t param_c
 
     if (param_count > 0)
     {
-        type->function.param_types = malloc(sizeof(Type *) * param_count);
+        type->function.param_types = arena_alloc(&g_type_arena, sizeof(Type *) * param_count);
         memcpy(type->function.param_types, param_types, sizeof(Type *) * param_count);
     }
     else
@@ -312,12 +343,13 @@ Type *type_function_create(Type *return_type, Type **param_types, size_t param_c
 
 Type *type_alias_create(const char *name, Type *target)
 {
-    Type *type           = malloc(sizeof(Type));
+    Type *type           = type_alloc();
     type->kind           = TYPE_ALIAS;
     type->size           = target ? target->size : 0;
     type->alignment      = target ? target->alignment : 0;
-    type->name           = strdup(name);
+    type->name           = arena_strdup(&g_type_arena, name);
     type->generic_origin = NULL;
+    type->mangled        = NULL;
     type->type_args      = NULL;
     type->type_arg_count = 0;
     type->alias.target   = target;
@@ -351,6 +383,9 @@ bool type_equals(Type *a, Type *b)
     case TYPE_ARRAY:
         return type_equals(a->array.elem_type, b->array.elem_type);
 
+    case TYPE_VECTOR:
+        return a->vector.count == b->vector.count && type_equals(a->vector.elem_type, b->vector.elem_type);
+
     case TYPE_FUNCTION:
         if (a->function.param_count != b->function.param_count)
             return false;
@@ -434,6 +469,16 @@ bool type_is_pointer_like(Type *type)
     return type->kind == TYPE_PTR || type->kind == TYPE_POINTER || type->kind == TYPE_FUNCTION;
 }
 
+bool type_is_vector(Type *type)
+{
+    if (!type)
+        return false;
+    while (type->kind == TYPE_ALIAS)
+        type = type->alias.target;
+
+    return type->kind == TYPE_VECTOR;
+}
+
 bool type_is_truthy(Type *type)
 {
     if (!type)
@@ -673,12 +718,7 @@ Type *type_resolve(AstNode *type_node, SymbolTable *symbol_table)
                 AstNode *field_node = type_node->type_str.fields->items[i];
                 Type    *field_type = type_resolve(field_node->field_stmt.type, symbol_table);
                 if (!field_type)
-                {
-                    type_free_field_list(head);
-                    free(struct_type->name);
-                    free(struct_type);
-                    return NULL;
-                }
+                    return NULL; // fields already created stay in the symbol arena
 
                 Symbol *field_symbol = symbol_create(SYMBOL_FIELD, field_node->field_stmt.name, field_type, field_node);
 
@@ -749,12 +789,7 @@ Type *type_resolve(AstNode *type_node, SymbolTable *symbol_table)
                 AstNode *field_node = type_node->type_uni.fields->items[i];
                 Type    *field_type = type_resolve(field_node->field_stmt.type, symbol_table);
                 if (!field_type)
-                {
-                    type_free_field_list(head);
-                    free(union_type->name);
-                    free(union_type);
-                    return NULL;
-                }
+                    return NULL; // fields already created stay in the symbol arena
 
                 Symbol *field_symbol       = symbol_create(SYMBOL_FIELD, field_node->field_stmt.name, field_type, field_node);
                 field_symbol->field.offset = 0;
@@ -800,6 +835,87 @@ Type *type_resolve(AstNode *type_node, SymbolTable *symbol_table)
     }
 }
 
+static size_t type_hash_name(const char *name)
+{
+    size_t hash = 5381;
+    for (const unsigned char *c = (const unsigned char *)name; *c; c++)
+        hash = ((hash << 5) + hash) + *c;
+    return hash;
+}
+
+// (re)build the dense field array and its name index; fields are appended during analysis,
+// so an index built earlier is stale once the head or field_count no longer match it
+static bool type_index_fields(Type *type)
+{
+    if (type->kind != TYPE_STRUCT && type->kind != TYPE_UNION)
+        return false;
+    if (!type->composite.fields)
+        return false;
+    if (type->composite.field_array && type->composite.field_array[0] == type->composite.fields && type->composite.indexed_count == type->composite.field_count)
+        return true;
+
+    size_t count = 0;
+    for (Symbol *field = type->composite.fields; field; field = field->next)
+        count++;
+
+    size_t slot_count = 8;
+    while (slot_count < count * 2)
+        slot_count *= 2;
+
+    // a stale index stays in the arena; rebuilds only follow fields appended after a lookup
+    type->composite.field_array = NULL;
+    type->composite.field_slots = NULL;
+    type->composite.slot_count  = 0;
+
+    Symbol **array = arena_alloc(&g_type_arena, count * sizeof(Symbol *));
+    Symbol **slots = arena_alloc(&g_type_arena, slot_count * sizeof(Symbol *));
+    if (!array || !slots)
+        return false;
+
+    size_t index = 0;
+    for (Symbol *field = type->composite.fields; field; field = field->next)
+    {
+        field->field.index = index;
+        array[index++]     = field;
+        if (!field->name)
+            continue;
+
+        size_t slot = type_hash_name(field->name) & (slot_count - 1);
+        while (slots[slot])
+            slot = (slot + 1) & (slot_count - 1);
+        slots[slot] = field;
+    }
+
+    type->composite.field_array   = array;
+    type->composite.field_slots   = slots;
+    type->composite.slot_count    = slot_count;
+    type->composite.indexed_count = count;
+    return true;
+}
+
+Symbol *type_find_field(Type *type, const char *name)
+{
+    if (!type || !name || !type_index_fields(type))
+        return NULL;
+
+    // the first field with a name wins, matching declaration order
+    size_t mask = type->composite.slot_count - 1;
+    for (size_t slot = type_hash_name(name) & mask; type->composite.field_slots[slot]; slot = (slot + 1) & mask)
+    {
+        Symbol *field = type->composite.field_slots[slot];
+        if (strcmp(field->name, name) == 0)
+            return field;
+    }
+    return NULL;
+}
+
+Symbol *type_field_at(Type *type, size_t index)
+{
+    if (!type || !type_index_fields(type) || index >= type->composite.indexed_count)
+        return NULL;
+    return type->composite.field_array[index];
+}
+
 Type *type_resolve_alias(Type *type)
 {
     if (!type)
@@ -857,6 +973,14 @@ char *type_to_string(Type *type)
         snprintf(result, 256, "[]%s", type_to_string(type->array.elem_type));
         break;
 
+    case TYPE_VECTOR:
+    {
+        char *elem_str = type_to_string(type->vector.elem_type);
+        snprintf(result, 256, "vec[%zu]%s", type->vector.count, elem_str);
+        free(elem_str);
+    }
+    break;
+
     case TYPE_STRUCT:
         snprintf(result, 256, "str %s", type->name ? type->name : "(anonymous)");
         break;